@@ -0,0 +1,217 @@
+#pragma once
+// Shared helpers for the headless benchmark executables (stats, JSON in/out)
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline float msSince(Clock::time_point from) {
+    return std::chrono::duration<float>(Clock::now() - from).count() * 1000.0f;
+}
+
+// Nearest-rank percentile; sorts a copy so callers keep sample order
+inline float percentile(std::vector<float> samples, float p) {
+    if (samples.empty()) return 0.0f;
+    std::sort(samples.begin(), samples.end());
+    size_t rank = static_cast<size_t>(p / 100.0f * (samples.size() - 1) + 0.5f);
+    return samples[std::min(rank, samples.size() - 1)];
+}
+
+inline float mean(const std::vector<float>& samples) {
+    if (samples.empty()) return 0.0f;
+    double sum = 0.0;
+    for (float s : samples) sum += s;
+    return static_cast<float>(sum / samples.size());
+}
+
+// World size at the default scenario's density (10k agents in 1280x720), so neighbor
+// counts stay comparable across agent counts; smaller populations keep 1280x720
+struct WorldSize {
+    int width;
+    int height;
+};
+inline WorldSize densityMatchedWorld(size_t agents) {
+    float scale = std::sqrt(std::max(1.0f, agents / 10000.0f));
+    return {static_cast<int>(1280 * scale), static_cast<int>(720 * scale)};
+}
+
+// Split "a,b,c" command line lists
+inline std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos) comma = list.size();
+        if (comma > start) out.push_back(list.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return out;
+}
+
+inline bool writeFile(const std::string& path, const std::string& text) {
+    std::ofstream out(path);
+    if (!out) {
+        std::fprintf(stderr, "Failed to write %s\n", path.c_str());
+        return false;
+    }
+    out << text << "\n";
+    return true;
+}
+
+// Minimal JSON writer: enough for flat result objects and arrays of them
+class JsonWriter {
+public:
+    void beginObject() { prefix(); out += '{'; first = true; }
+    void endObject() { out += '}'; first = false; }
+    void beginArray() { prefix(); out += '['; first = true; }
+    void endArray() { out += ']'; first = false; }
+
+    void key(const std::string& k) {
+        if (!first) out += ", ";
+        first = false;
+        out += '"' + k + "\": ";
+        afterKey = true;
+    }
+    void value(const std::string& v) { prefix(); out += '"' + v + '"'; }
+    void value(double v) {
+        prefix();
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%.6g", v);
+        out += buf;
+    }
+    void value(uint64_t v) { prefix(); out += std::to_string(v); }
+    void value(bool v) { prefix(); out += v ? "true" : "false"; }
+
+    void field(const std::string& k, const std::string& v) { key(k); value(v); }
+    void field(const std::string& k, const char* v) { key(k); value(std::string(v)); }
+    void field(const std::string& k, double v) { key(k); value(v); }
+    void field(const std::string& k, float v) { key(k); value(static_cast<double>(v)); }
+    void field(const std::string& k, uint64_t v) { key(k); value(v); }
+    void field(const std::string& k, uint32_t v) { key(k); value(static_cast<uint64_t>(v)); }
+    void field(const std::string& k, int v) { key(k); value(static_cast<uint64_t>(v)); }
+    void field(const std::string& k, bool v) { key(k); value(v); }
+
+    const std::string& str() const { return out; }
+
+private:
+    std::string out;
+    bool first = true;
+    bool afterKey = false;
+
+    void prefix() {
+        if (afterKey) { afterKey = false; return; }
+        if (!first) out += ", ";
+        first = false;
+    }
+};
+
+// Minimal JSON reader for baseline files written by JsonWriter (or edited by hand)
+struct JsonValue {
+    enum class Kind { Null, Bool, Number, String, Array, Object } kind = Kind::Null;
+    double number = 0.0;
+    bool boolean = false;
+    std::string string;
+    std::vector<JsonValue> items;
+    std::map<std::string, JsonValue> members;
+
+    const JsonValue* find(const std::string& k) const {
+        auto it = members.find(k);
+        return it == members.end() ? nullptr : &it->second;
+    }
+    double numberOr(const std::string& k, double fallback) const {
+        const JsonValue* v = find(k);
+        return (v && v->kind == Kind::Number) ? v->number : fallback;
+    }
+    std::string stringOr(const std::string& k, const std::string& fallback) const {
+        const JsonValue* v = find(k);
+        return (v && v->kind == Kind::String) ? v->string : fallback;
+    }
+};
+
+class JsonReader {
+public:
+    explicit JsonReader(const std::string& text) : s(text) {}
+
+    bool parse(JsonValue& out) {
+        pos = 0;
+        bool ok = parseValue(out);
+        skipWs();
+        return ok && pos == s.size();
+    }
+
+private:
+    const std::string& s;
+    size_t pos = 0;
+
+    void skipWs() {
+        while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\n' || s[pos] == '\r' || s[pos] == '\t')) pos++;
+    }
+    bool consume(char c) {
+        skipWs();
+        if (pos < s.size() && s[pos] == c) { pos++; return true; }
+        return false;
+    }
+    bool parseString(std::string& out) {
+        if (!consume('"')) return false;
+        out.clear();
+        while (pos < s.size() && s[pos] != '"') {
+            if (s[pos] == '\\' && pos + 1 < s.size()) pos++;
+            out += s[pos++];
+        }
+        return consume('"');
+    }
+    bool parseValue(JsonValue& out) {
+        skipWs();
+        if (pos >= s.size()) return false;
+        char c = s[pos];
+        if (c == '{') {
+            pos++;
+            out.kind = JsonValue::Kind::Object;
+            if (consume('}')) return true;
+            do {
+                std::string k;
+                if (!parseString(k) || !consume(':')) return false;
+                if (!parseValue(out.members[k])) return false;
+            } while (consume(','));
+            return consume('}');
+        }
+        if (c == '[') {
+            pos++;
+            out.kind = JsonValue::Kind::Array;
+            if (consume(']')) return true;
+            do {
+                out.items.emplace_back();
+                if (!parseValue(out.items.back())) return false;
+            } while (consume(','));
+            return consume(']');
+        }
+        if (c == '"') {
+            out.kind = JsonValue::Kind::String;
+            return parseString(out.string);
+        }
+        if (s.compare(pos, 4, "true") == 0) { pos += 4; out.kind = JsonValue::Kind::Bool; out.boolean = true; return true; }
+        if (s.compare(pos, 5, "false") == 0) { pos += 5; out.kind = JsonValue::Kind::Bool; return true; }
+        if (s.compare(pos, 4, "null") == 0) { pos += 4; return true; }
+
+        char* end = nullptr;
+        out.number = std::strtod(s.c_str() + pos, &end);
+        if (end == s.c_str() + pos) return false;
+        out.kind = JsonValue::Kind::Number;
+        pos = static_cast<size_t>(end - s.c_str());
+        return true;
+    }
+};
+
+}  // namespace bench
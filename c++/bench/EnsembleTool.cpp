@@ -0,0 +1,190 @@
+// tactix_ensemble: many seeds of one scenario on a single shared worker pool, with
+// per-seed outcomes and summary statistics (takeover, containment, survivors, hero
+// exhaustion) for balancing sweeps.
+#include "platform.h"
+#include "Ensemble.hpp"
+#include "BenchCommon.hpp"
+#include "spdlog/spdlog.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    EnsembleConfig config;
+    uint32_t workers = 0;
+    std::string outPath = "tactix_ensemble.json";
+    bool quiet = false;
+};
+
+void printUsage() {
+    std::printf(
+        "Usage: tactix_ensemble [options]\n"
+        "  --runs N             Seeds to run (default 64)\n"
+        "  --seed N             First seed; run r uses seed+r (default 1)\n"
+        "  --agents N           Agents per run (default 10000)\n"
+        "  --mix C,Z            Civilian and zombie shares, heroes get the rest (default 0.90,0.05)\n"
+        "  --max-ticks N        Tick cap per run (default 36000 = 10 simulated minutes)\n"
+        "  --world WxH          World size (default: density matched like tactix_bench)\n"
+        "  --workers N          Shared pool size, 'auto' = available CPUs - 1 (default auto)\n"
+        "  --in-flight N        Simulations alive at once (default 2 per worker)\n"
+        "  --ticks-per-job N    Ticks a run advances per pool job (default 60)\n"
+        "  --out PATH           JSON results path (default tactix_ensemble.json)\n"
+        "  --quiet              No per-run lines\n");
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    EnsembleConfig& config = opt.config;
+    bool explicitWorld = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return (i + 1 < argc) ? argv[++i] : ""; };
+
+        if (arg == "--runs") {
+            config.runs = static_cast<uint32_t>(std::stoul(next()));
+        } else if (arg == "--seed") {
+            config.firstSeed = std::stoull(next());
+        } else if (arg == "--agents") {
+            config.agents = std::stoul(next());
+        } else if (arg == "--mix") {
+            auto parts = bench::splitList(next());
+            if (parts.size() != 2) return false;
+            config.mix.civilians = std::stof(parts[0]);
+            config.mix.zombies = std::stof(parts[1]);
+        } else if (arg == "--max-ticks") {
+            config.maxTicks = static_cast<uint32_t>(std::stoul(next()));
+        } else if (arg == "--world") {
+            std::string v = next();
+            size_t x = v.find('x');
+            if (x == std::string::npos) return false;
+            config.world.width = std::stof(v.substr(0, x));
+            config.world.height = std::stof(v.substr(x + 1));
+            explicitWorld = true;
+        } else if (arg == "--workers") {
+            std::string v = next();
+            opt.workers = v == "auto" ? 0u : static_cast<uint32_t>(std::stoul(v));
+        } else if (arg == "--in-flight") {
+            config.maxInFlight = static_cast<uint32_t>(std::stoul(next()));
+        } else if (arg == "--ticks-per-job") {
+            config.ticksPerJob = static_cast<uint32_t>(std::stoul(next()));
+        } else if (arg == "--out") {
+            opt.outPath = next();
+        } else if (arg == "--quiet") {
+            opt.quiet = true;
+        } else {
+            return false;
+        }
+    }
+    if (!explicitWorld) {
+        const bench::WorldSize size = bench::densityMatchedWorld(config.agents);
+        config.world.width = static_cast<float>(size.width);
+        config.world.height = static_cast<float>(size.height);
+    }
+    return config.runs > 0;
+}
+
+void printStat(const char* name, double rate, const EnsembleStat& s) {
+    std::printf("%-16s %6.1f%% %8u %10.1f %9.1f %9.0f %9.0f %9.0f %9.0f\n", name, rate * 100.0, s.samples,
+                s.mean, s.stddev, s.min, s.p50, s.p90, s.max);
+}
+
+void statJson(bench::JsonWriter& json, const char* name, double rate, const EnsembleStat& s) {
+    json.key(name);
+    json.beginObject();
+    json.field("rate", rate);
+    json.field("samples", s.samples);
+    json.field("mean", s.mean);
+    json.field("stddev", s.stddev);
+    json.field("min", s.min);
+    json.field("p50", s.p50);
+    json.field("p90", s.p90);
+    json.field("max", s.max);
+    json.endObject();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        printUsage();
+        return 2;
+    }
+    spdlog::set_level(spdlog::level::warn);
+    const EnsembleConfig& config = opt.config;
+
+    JobSystem jobs(opt.workers);
+    EnsembleRunner runner(jobs);
+    std::mutex printMutex;
+    if (!opt.quiet) {
+        runner.onRunFinished = [&printMutex](const RunOutcome& o) {
+            std::lock_guard<std::mutex> lock(printMutex);
+            std::printf("seed %-8llu %6u ticks  takeover %6lld  contained %6lld  exhaustion %6lld  survivors %6u  %.0f ms\n",
+                        static_cast<unsigned long long>(o.seed), o.ticks, static_cast<long long>(o.takeoverTick),
+                        static_cast<long long>(o.containedTick), static_cast<long long>(o.heroExhaustionTick),
+                        o.survivors, o.wallMs);
+        };
+    }
+
+    std::printf("%u runs x %zu agents (%.0fx%.0f world) on %u workers\n", config.runs, config.agents,
+                config.world.width, config.world.height, jobs.getWorkerCount());
+    auto start = bench::Clock::now();
+    std::vector<RunOutcome> outcomes = runner.run(config);
+    float ms = bench::msSince(start);
+
+    uint64_t totalTicks = 0;
+    for (const RunOutcome& o : outcomes) totalTicks += o.ticks;
+    EnsembleSummary summary = EnsembleRunner::summarize(outcomes);
+
+    std::printf("\n%u runs, %llu ticks in %.1f s (%.1f runs/s, %.0f ticks/s)\n", summary.runs,
+                static_cast<unsigned long long>(totalTicks), ms / 1000.0f, summary.runs / (ms / 1000.0f),
+                totalTicks / (ms / 1000.0f));
+    std::printf("%-16s %7s %8s %10s %9s %9s %9s %9s %9s\n", "metric", "rate", "samples", "mean", "stddev",
+                "min", "p50", "p90", "max");
+    printStat("takeover tick", summary.takeoverRate, summary.takeoverTick);
+    printStat("contained tick", summary.containedRate, summary.containedTick);
+    printStat("exhaustion tick", summary.heroExhaustionRate, summary.heroExhaustionTick);
+    printStat("survivors", 1.0, summary.survivors);
+
+    bench::JsonWriter json;
+    json.beginObject();
+    json.field("tactix_ensemble", 1);
+    json.field("agents", static_cast<uint64_t>(config.agents));
+    json.field("civilians", config.mix.civilians);
+    json.field("zombies", config.mix.zombies);
+    json.field("world_width", config.world.width);
+    json.field("world_height", config.world.height);
+    json.field("max_ticks", config.maxTicks);
+    json.field("workers", jobs.getWorkerCount());
+    json.field("wall_ms", ms);
+    json.key("summary");
+    json.beginObject();
+    json.field("runs", summary.runs);
+    statJson(json, "takeover_tick", summary.takeoverRate, summary.takeoverTick);
+    statJson(json, "contained_tick", summary.containedRate, summary.containedTick);
+    statJson(json, "hero_exhaustion_tick", summary.heroExhaustionRate, summary.heroExhaustionTick);
+    statJson(json, "survivors", 1.0, summary.survivors);
+    json.endObject();
+    json.key("runs");
+    json.beginArray();
+    for (const RunOutcome& o : outcomes) {
+        json.beginObject();
+        json.field("seed", o.seed);
+        json.field("ticks", o.ticks);
+        // -1 = never happened
+        json.field("takeover_tick", static_cast<double>(o.takeoverTick));
+        json.field("contained_tick", static_cast<double>(o.containedTick));
+        json.field("hero_exhaustion_tick", static_cast<double>(o.heroExhaustionTick));
+        json.field("survivors", o.survivors);
+        json.field("zombies", o.zombies);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    if (!opt.outPath.empty() && bench::writeFile(opt.outPath, json.str())) {
+        std::printf("\nResults written to %s\n", opt.outPath.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,414 @@
+// tactix_microbench: isolated numbers for SpatialHash, JobSystem and line-of-sight
+// primitives.
+//
+//   rebuild  - build() throughput and memory vs agent count, distribution
+//              and storage mode (blocks / hashed)
+//   query    - queryNeighbors() cost vs radius and storage mode
+//   dispatch - submit()/waitAll() overhead vs chunk size
+//   rays     - ObstacleGrid batch tracing cost vs ray length, serial and in jobs
+#include "SpatialHash.hpp"
+#include "JobSystem.hpp"
+#include "LineOfSight.hpp"
+#include "BenchCommon.hpp"
+#include "spdlog/spdlog.h"
+
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const float kWorldWidth = 1280.0f;
+const float kWorldHeight = 720.0f;
+const float kCellSize = 50.0f;  // Same as Simulation
+
+enum class Distribution { Uniform, Clustered, SingleCell };
+
+const char* distributionName(Distribution d) {
+    switch (d) {
+        case Distribution::Uniform: return "uniform";
+        case Distribution::Clustered: return "clustered";
+        default: return "single_cell";
+    }
+}
+
+const char* modeName(SpatialHashMode m) {
+    return m == SpatialHashMode::Hashed ? "hashed" : "blocks";
+}
+
+struct Points {
+    std::vector<float> x;
+    std::vector<float> y;
+};
+
+// World scales with count so "uniform" keeps the 10k @ 1280x720 density
+Points makePoints(size_t count, Distribution dist, float worldW, float worldH, uint32_t seed) {
+    std::mt19937 rng(seed);
+    Points p;
+    p.x.resize(count);
+    p.y.resize(count);
+
+    if (dist == Distribution::Uniform) {
+        std::uniform_real_distribution<float> ux(0.0f, worldW), uy(0.0f, worldH);
+        for (size_t i = 0; i < count; i++) { p.x[i] = ux(rng); p.y[i] = uy(rng); }
+    } else if (dist == Distribution::Clustered) {
+        // A handful of dense hordes (sigma ~ 2 cells) like a late-game outbreak
+        const int hordes = 8;
+        std::uniform_real_distribution<float> cx(worldW * 0.1f, worldW * 0.9f), cy(worldH * 0.1f, worldH * 0.9f);
+        std::vector<float> centerX(hordes), centerY(hordes);
+        for (int h = 0; h < hordes; h++) { centerX[h] = cx(rng); centerY[h] = cy(rng); }
+        std::normal_distribution<float> spread(0.0f, kCellSize * 2.0f);
+        for (size_t i = 0; i < count; i++) {
+            int h = static_cast<int>(i % hordes);
+            p.x[i] = std::clamp(centerX[h] + spread(rng), 0.0f, worldW - 1.0f);
+            p.y[i] = std::clamp(centerY[h] + spread(rng), 0.0f, worldH - 1.0f);
+        }
+    } else {
+        // Worst case: everything in one cell
+        std::uniform_real_distribution<float> u(0.0f, kCellSize * 0.99f);
+        for (size_t i = 0; i < count; i++) { p.x[i] = worldW * 0.5f + u(rng); p.y[i] = worldH * 0.5f + u(rng); }
+    }
+    return p;
+}
+
+struct Options {
+    std::vector<size_t> counts = {1000, 10000, 100000, 1000000};
+    std::vector<float> radii = {25.0f, 50.0f, 100.0f, 150.0f, 300.0f};
+    std::vector<size_t> chunkSizes = {16, 64, 256, 1024, 4096};
+    std::vector<SpatialHashMode> modes = {SpatialHashMode::Blocks, SpatialHashMode::Hashed};
+    float worldWidth = 0.0f;  // Fixed world (--world), e.g. a huge sparse map; 0 = density matched
+    float worldHeight = 0.0f;
+    uint32_t workers = 0;
+    int reps = 15;
+    bool runRebuild = true;
+    bool runQuery = true;
+    bool runDispatch = true;
+    bool runRays = true;
+    std::string outPath;
+};
+
+void worldFor(const Options& opt, size_t count, float& w, float& h) {
+    if (opt.worldWidth > 0.0f && opt.worldHeight > 0.0f) {
+        w = opt.worldWidth;
+        h = opt.worldHeight;
+        return;
+    }
+    float scale = std::sqrt(std::max(1.0f, count / 10000.0f));
+    w = kWorldWidth * scale;
+    h = kWorldHeight * scale;
+}
+
+void benchRebuild(const Options& opt, bench::JsonWriter& json) {
+    std::printf("\n== SpatialHash rebuild (build) ==\n");
+    std::printf("%-7s %-12s %10s %12s %12s %14s %12s\n", "mode", "dist", "agents", "build us",
+                "ns/agent", "max occupancy", "memory KB");
+    json.key("rebuild");
+    json.beginArray();
+
+    for (Distribution dist : {Distribution::Uniform, Distribution::Clustered, Distribution::SingleCell}) {
+        for (size_t count : opt.counts) {
+            float w, h;
+            worldFor(opt, count, w, h);
+            Points pts = makePoints(count, dist, w, h, 42);
+            for (SpatialHashMode mode : opt.modes) {
+                SpatialHash grid(w, h, kCellSize, mode);
+
+                // Prime storage so we measure steady-state ticks, not first growth
+                grid.build(pts.x.data(), pts.y.data(), count);
+
+                std::vector<float> buildMs;
+                for (int r = 0; r < opt.reps; r++) {
+                    auto t0 = bench::Clock::now();
+                    grid.build(pts.x.data(), pts.y.data(), count);
+                    buildMs.push_back(bench::msSince(t0));
+                }
+
+                float buildP50 = bench::percentile(buildMs, 50.0f);
+                float nsPerAgent = buildP50 * 1e6f / static_cast<float>(count);
+                float memoryKB = grid.getMemoryBytes() / 1024.0f;
+                std::printf("%-7s %-12s %10zu %12.1f %12.2f %14u %12.0f\n", modeName(mode), distributionName(dist),
+                            count, buildP50 * 1000.0f, nsPerAgent, grid.getMaxOccupancy(), memoryKB);
+
+                json.beginObject();
+                json.field("mode", modeName(mode));
+                json.field("distribution", distributionName(dist));
+                json.field("agents", static_cast<uint64_t>(count));
+                json.field("cells", grid.getCellCount());
+                json.field("build_p50_ms", buildP50);
+                json.field("ns_per_agent", nsPerAgent);
+                json.field("max_occupancy", grid.getMaxOccupancy());
+                json.field("memory_bytes", static_cast<uint64_t>(grid.getMemoryBytes()));
+                json.endObject();
+            }
+        }
+    }
+    json.endArray();
+}
+
+void benchQuery(const Options& opt, bench::JsonWriter& json) {
+    std::printf("\n== SpatialHash queryNeighbors vs radius ==\n");
+    std::printf("%-7s %-12s %10s %8s %12s %14s\n", "mode", "dist", "agents", "radius", "ns/query", "avg returned");
+    json.key("query");
+    json.beginArray();
+
+    const size_t queries = 20000;
+    for (Distribution dist : {Distribution::Uniform, Distribution::Clustered}) {
+        for (size_t count : {size_t(10000), size_t(100000)}) {
+            float w, h;
+            worldFor(opt, count, w, h);
+            Points pts = makePoints(count, dist, w, h, 7);
+            for (SpatialHashMode mode : opt.modes) {
+                SpatialHash grid(w, h, kCellSize, mode);
+                grid.build(pts.x.data(), pts.y.data(), count);
+
+                std::vector<uint32_t> out;
+                out.reserve(4096);
+                for (float radius : opt.radii) {
+                    std::vector<float> runs;
+                    uint64_t returned = 0;
+                    for (int r = 0; r < std::max(3, opt.reps / 3); r++) {
+                        returned = 0;
+                        auto t0 = bench::Clock::now();
+                        for (size_t q = 0; q < queries; q++) {
+                            size_t i = (q * 2654435761u) % count;  // Query from agent positions
+                            grid.queryNeighbors(pts.x[i], pts.y[i], radius, out);
+                            returned += out.size();
+                        }
+                        runs.push_back(bench::msSince(t0));
+                    }
+                    float nsPerQuery = bench::percentile(runs, 50.0f) * 1e6f / queries;
+                    float avgReturned = static_cast<float>(returned) / queries;
+                    std::printf("%-7s %-12s %10zu %8.0f %12.1f %14.1f\n", modeName(mode), distributionName(dist), count,
+                                radius, nsPerQuery, avgReturned);
+
+                    json.beginObject();
+                    json.field("mode", modeName(mode));
+                    json.field("distribution", distributionName(dist));
+                    json.field("agents", static_cast<uint64_t>(count));
+                    json.field("radius", radius);
+                    json.field("ns_per_query", nsPerQuery);
+                    json.field("avg_returned", avgReturned);
+                    json.endObject();
+                }
+            }
+        }
+    }
+    json.endArray();
+}
+
+void benchDispatch(const Options& opt, bench::JsonWriter& json) {
+    JobSystem jobs(opt.workers);
+    std::printf("\n== JobSystem submit/waitAll (%u workers) ==\n", jobs.getWorkerCount());
+    std::printf("%-8s %10s %8s %12s %12s %14s\n", "items", "chunk", "jobs", "empty us", "work us", "overhead/job us");
+    json.key("dispatch");
+    json.beginObject();
+    json.field("workers", jobs.getWorkerCount());
+    json.key("runs");
+    json.beginArray();
+
+    // Work item roughly the cost of one agent's movement update
+    const size_t items = 100000;
+    std::vector<float> data(items, 1.0f);
+    std::atomic<uint64_t> sink{0};
+
+    for (size_t chunk : opt.chunkSizes) {
+        size_t jobCount = (items + chunk - 1) / chunk;
+        std::vector<float> emptyMs, workMs;
+        for (int r = 0; r < opt.reps; r++) {
+            // Empty jobs: pure queue + wake + barrier cost
+            auto t0 = bench::Clock::now();
+            for (size_t start = 0; start < items; start += chunk) {
+                jobs.submit([]() {});
+            }
+            jobs.waitAll();
+            emptyMs.push_back(bench::msSince(t0));
+
+            // Light per-item work, like a movement chunk
+            auto t1 = bench::Clock::now();
+            for (size_t start = 0; start < items; start += chunk) {
+                size_t end = std::min(start + chunk, items);
+                jobs.submit([&data, &sink, start, end]() {
+                    float acc = 0.0f;
+                    for (size_t i = start; i < end; i++) {
+                        data[i] = data[i] * 0.999f + 0.001f;
+                        acc += data[i];
+                    }
+                    sink += static_cast<uint64_t>(acc);
+                });
+            }
+            jobs.waitAll();
+            workMs.push_back(bench::msSince(t1));
+        }
+
+        float emptyP50 = bench::percentile(emptyMs, 50.0f);
+        float workP50 = bench::percentile(workMs, 50.0f);
+        float overheadPerJob = emptyP50 * 1000.0f / static_cast<float>(jobCount);
+        std::printf("%-8zu %10zu %8zu %12.1f %12.1f %14.2f\n", items, chunk, jobCount,
+                    emptyP50 * 1000.0f, workP50 * 1000.0f, overheadPerJob);
+
+        json.beginObject();
+        json.field("items", static_cast<uint64_t>(items));
+        json.field("chunk_size", static_cast<uint64_t>(chunk));
+        json.field("jobs", static_cast<uint64_t>(jobCount));
+        json.field("empty_p50_ms", emptyP50);
+        json.field("work_p50_ms", workP50);
+        json.field("overhead_per_job_us", overheadPerJob);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+}
+
+void benchRays(const Options& opt, bench::JsonWriter& json) {
+    JobSystem jobs(opt.workers);
+    std::printf("\n== ObstacleGrid ray batches (%u workers) ==\n", jobs.getWorkerCount());
+    std::printf("%-10s %8s %10s %12s %12s %10s\n", "world", "length", "rays", "serial ns", "jobs ns", "visible");
+    json.key("rays");
+    json.beginArray();
+
+    // Obstacles as dense as Simulation::generateObstacles at its cap (4x the base map)
+    const float w = kWorldWidth * 2.0f;
+    const float h = kWorldHeight * 2.0f;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> ux(0.0f, w), uy(0.0f, h), size(80.0f, 150.0f), radius(15.0f, 25.0f);
+    std::vector<ObstacleGrid::Box> boxes;
+    std::vector<ObstacleGrid::Disc> discs;
+    for (int b = 0; b < 32; b++) boxes.push_back({ux(rng) * 0.9f, uy(rng) * 0.9f, size(rng), size(rng)});
+    for (int t = 0; t < 120; t++) discs.push_back({ux(rng), uy(rng), radius(rng)});
+    ObstacleGrid grid;
+    grid.build(boxes, discs, w, h);
+
+    const uint32_t rayCount = 100000;
+    const uint32_t chunk = 256;
+    for (float length : {100.0f, 300.0f}) {
+        RayBatch batch;
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        for (uint32_t r = 0; r < rayCount; r++) {
+            float x = ux(rng), y = uy(rng), a = angle(rng);
+            batch.add(x, y, x + std::cos(a) * length, y + std::sin(a) * length);
+        }
+
+        std::vector<float> serialMs, jobMs;
+        for (int r = 0; r < opt.reps; r++) {
+            batch.resetVisibility();
+            auto t0 = bench::Clock::now();
+            grid.trace(batch, 0, rayCount);
+            serialMs.push_back(bench::msSince(t0));
+
+            batch.resetVisibility();
+            auto t1 = bench::Clock::now();
+            for (uint32_t start = 0; start < rayCount; start += chunk) {
+                jobs.submit([&grid, &batch, start, last = std::min(start + chunk, rayCount)]() {
+                    grid.trace(batch, start, last);
+                });
+            }
+            jobs.waitAll();
+            jobMs.push_back(bench::msSince(t1));
+        }
+        uint32_t visible = 0;
+        for (uint32_t r = 0; r < rayCount; r++) visible += batch.isVisible(r);
+
+        float serialNs = bench::percentile(serialMs, 50.0f) * 1e6f / rayCount;
+        float jobNs = bench::percentile(jobMs, 50.0f) * 1e6f / rayCount;
+        float visibleShare = static_cast<float>(visible) / rayCount;
+        std::printf("%4.0fx%-5.0f %8.0f %10u %12.1f %12.1f %9.0f%%\n", w, h, length, rayCount, serialNs, jobNs,
+                    visibleShare * 100.0f);
+
+        json.beginObject();
+        json.field("world_width", w);
+        json.field("world_height", h);
+        json.field("grid_cells", grid.getCellCount());
+        json.field("ray_length", length);
+        json.field("rays", rayCount);
+        json.field("serial_ns_per_ray", serialNs);
+        json.field("jobs_ns_per_ray", jobNs);
+        json.field("visible_share", visibleShare);
+        json.endObject();
+    }
+    json.endArray();
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return (i + 1 < argc) ? argv[++i] : ""; };
+
+        if (arg == "--counts") {
+            opt.counts.clear();
+            for (const auto& v : bench::splitList(next())) opt.counts.push_back(std::stoul(v));
+        } else if (arg == "--radii") {
+            opt.radii.clear();
+            for (const auto& v : bench::splitList(next())) opt.radii.push_back(std::stof(v));
+        } else if (arg == "--chunks") {
+            opt.chunkSizes.clear();
+            for (const auto& v : bench::splitList(next())) opt.chunkSizes.push_back(std::stoul(v));
+        } else if (arg == "--modes") {
+            opt.modes.clear();
+            for (const auto& v : bench::splitList(next())) {
+                opt.modes.push_back(v == "hashed" ? SpatialHashMode::Hashed : SpatialHashMode::Blocks);
+            }
+        } else if (arg == "--world") {
+            std::string v = next();
+            size_t x = v.find('x');
+            if (x != std::string::npos) {
+                opt.worldWidth = std::stof(v.substr(0, x));
+                opt.worldHeight = std::stof(v.substr(x + 1));
+            }
+        } else if (arg == "--workers") {
+            opt.workers = static_cast<uint32_t>(std::stoul(next()));
+        } else if (arg == "--reps") {
+            opt.reps = std::max(1, std::stoi(next()));
+        } else if (arg == "--only") {
+            std::string which = next();
+            opt.runRebuild = which == "rebuild";
+            opt.runQuery = which == "query";
+            opt.runDispatch = which == "dispatch";
+            opt.runRays = which == "rays";
+        } else if (arg == "--out") {
+            opt.outPath = next();
+        } else {
+            std::printf(
+                "Usage: tactix_microbench [options]\n"
+                "  --counts LIST   Agent counts for rebuild (default 1000,10000,100000,1000000)\n"
+                "  --radii LIST    Query radii (default 25,50,100,150,300)\n"
+                "  --chunks LIST   Job chunk sizes (default 16,64,256,1024,4096)\n"
+                "  --modes LIST    Spatial grid storage: blocks,hashed (default both)\n"
+                "  --world WxH     Fixed world size instead of density matching, e.g. 100000x100000\n"
+                "  --workers N     JobSystem workers (default: hardware)\n"
+                "  --reps N        Repetitions per measurement, p50 reported (default 15)\n"
+                "  --only NAME     rebuild | query | dispatch | rays\n"
+                "  --out PATH      Also write JSON results\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        return 2;
+    }
+    spdlog::set_level(spdlog::level::warn);
+
+    bench::JsonWriter json;
+    json.beginObject();
+    json.field("tactix_microbench", 1);
+    if (opt.runRebuild) benchRebuild(opt, json);
+    if (opt.runQuery) benchQuery(opt, json);
+    if (opt.runDispatch) benchDispatch(opt, json);
+    if (opt.runRays) benchRays(opt, json);
+    json.endObject();
+
+    if (!opt.outPath.empty()) {
+        std::ofstream out(opt.outPath);
+        out << json.str() << "\n";
+        std::printf("\nResults written to %s\n", opt.outPath.c_str());
+    }
+    return 0;
+}
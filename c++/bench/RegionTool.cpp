@@ -0,0 +1,272 @@
+// tactix_regions: one world split into vertical strips, each simulated by its own
+// process with its own job system, exchanging migrants and boundary ghosts over the
+// shared-memory ring transport. Launches every rank on this machine by default, or a
+// single rank (--rank) when the ranks are started separately.
+#include "platform.h"
+#include "Region.hpp"
+#include "BenchCommon.hpp"
+#include "spdlog/spdlog.h"
+
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct Options {
+    RegionConfig config;
+    uint32_t ranks = 2;
+    int rank = -1;  // -1: fork every rank here
+    uint32_t ticks = 600;
+    uint32_t reportInterval = 120;
+    std::string name;  // Shared memory segment, default derived from the launcher's pid
+    std::string outPath = "tactix_regions.json";
+};
+
+void printUsage() {
+    std::printf(
+        "Usage: tactix_regions [options]\n"
+        "  --ranks N            Regions / processes (default 2)\n"
+        "  --rank R             Run only rank R; start the others with the same options and --name\n"
+        "  --agents N           Agents in the whole world (default 100000)\n"
+        "  --ticks N            Ticks to simulate (default 600)\n"
+        "  --seed N             Simulation seed (default 1337)\n"
+        "  --mix C,Z            Civilian and zombie shares, heroes get the rest (default 0.90,0.05)\n"
+        "  --world WxH          World size (default: density matched like tactix_bench)\n"
+        "  --workers N          Job system workers per rank, 'auto' = equal share of the available CPUs (default auto)\n"
+        "  --think-interval N   Max ticks between AI evaluations (default 8)\n"
+        "  --hordes             Simulate calm zombie packs as horde macro-agents\n"
+        "  --ghost-band PX      Boundary band copied to neighbors (default 150)\n"
+        "  --rebalance N        Ticks between load checks, 0 = fixed equal-width strips (default 120)\n"
+        "  --threshold X        Busiest/mean load that triggers a re-cut (default 1.2)\n"
+        "  --report N           Ticks between progress lines (default 120, 0 = none)\n"
+        "  --name NAME          Shared memory segment name (default /tactix_regions_<pid>)\n"
+        "  --out PATH           JSON results path, written by rank 0 (default tactix_regions.json)\n");
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    RegionConfig& config = opt.config;
+    bool explicitWorld = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return (i + 1 < argc) ? argv[++i] : ""; };
+
+        if (arg == "--ranks") {
+            opt.ranks = static_cast<uint32_t>(std::stoul(next()));
+        } else if (arg == "--rank") {
+            opt.rank = std::stoi(next());
+        } else if (arg == "--agents") {
+            config.agents = std::stoul(next());
+        } else if (arg == "--ticks") {
+            opt.ticks = static_cast<uint32_t>(std::stoul(next()));
+        } else if (arg == "--seed") {
+            config.seed = std::stoull(next());
+        } else if (arg == "--mix") {
+            auto parts = bench::splitList(next());
+            if (parts.size() != 2) return false;
+            config.mix.civilians = std::stof(parts[0]);
+            config.mix.zombies = std::stof(parts[1]);
+        } else if (arg == "--world") {
+            std::string v = next();
+            size_t x = v.find('x');
+            if (x == std::string::npos) return false;
+            config.world.width = std::stof(v.substr(0, x));
+            config.world.height = std::stof(v.substr(x + 1));
+            explicitWorld = true;
+        } else if (arg == "--workers") {
+            std::string v = next();
+            config.workers = v == "auto" ? 0u : static_cast<uint32_t>(std::stoul(v));
+        } else if (arg == "--think-interval") {
+            config.maxThinkInterval = static_cast<uint32_t>(std::stoul(next()));
+        } else if (arg == "--hordes") {
+            config.hordes = true;
+        } else if (arg == "--ghost-band") {
+            config.ghostBand = std::stof(next());
+        } else if (arg == "--rebalance") {
+            config.rebalanceInterval = static_cast<uint32_t>(std::stoul(next()));
+        } else if (arg == "--threshold") {
+            config.rebalanceThreshold = std::stof(next());
+        } else if (arg == "--report") {
+            opt.reportInterval = static_cast<uint32_t>(std::stoul(next()));
+        } else if (arg == "--name") {
+            opt.name = next();
+        } else if (arg == "--out") {
+            opt.outPath = next();
+        } else {
+            return false;
+        }
+    }
+    if (!explicitWorld) {
+        const bench::WorldSize size = bench::densityMatchedWorld(config.agents);
+        config.world.width = static_cast<float>(size.width);
+        config.world.height = static_cast<float>(size.height);
+    }
+    if (config.workers == 0) {
+        // Every rank on this machine: split the CPUs instead of each taking them all
+        config.workers = std::max(1u, JobSystem::availableCpus() / std::max(1u, opt.ranks));
+    }
+    if (opt.rank >= 0 && opt.name.empty()) {
+        std::fprintf(stderr, "--rank needs --name so the ranks find each other\n");
+        return false;
+    }
+    return opt.ranks > 0 && opt.rank < static_cast<int>(opt.ranks);
+}
+
+// Totals of one rank over the run
+struct RankTotals {
+    uint64_t migratedIn = 0;
+    uint64_t migratedOut = 0;
+    uint64_t ghosts = 0;  // Received, summed over ticks
+    double tickMs = 0.0;
+    double exchangeMs = 0.0;
+};
+
+int runRank(const Options& opt, uint32_t rank) {
+    auto transport = ShmRingTransport::open(opt.name, rank, opt.ranks);
+    if (!transport) return 1;
+    RegionNode node(opt.config, *transport);
+    if (!node.init()) return 1;
+
+    const float dt = 1.0f / 60.0f;
+    RankTotals totals;
+    std::vector<uint64_t> counts;
+    auto start = bench::Clock::now();
+    for (uint32_t t = 1; t <= opt.ticks; t++) {
+        if (!node.step(dt)) {
+            spdlog::error("Rank {}: step {} failed", rank, t);
+            return 1;
+        }
+        const RegionStepStats& s = node.getLastStepStats();
+        totals.migratedIn += s.migratedIn;
+        totals.migratedOut += s.migratedOut;
+        totals.ghosts += s.ghostsReceived;
+        totals.tickMs += s.tickMs;
+        totals.exchangeMs += s.exchangeMs;
+
+        if (opt.reportInterval > 0 && t % opt.reportInterval == 0) {
+            if (!node.allGather(node.getSimulation().getAgentCount(), counts)) return 1;
+            if (rank == 0) {
+                std::printf("tick %5u  %6.0f ms  agents", t, bench::msSince(start));
+                for (uint64_t c : counts) std::printf(" %7llu", static_cast<unsigned long long>(c));
+                std::printf("\n");
+            }
+        }
+    }
+    const float wallMs = bench::msSince(start);
+
+    // Gather every rank's totals on every rank; rank 0 prints and writes them
+    const Simulation& sim = node.getSimulation();
+    std::vector<uint64_t> agents, in, out, ghosts, tickUs, exchangeUs;
+    bool ok = node.allGather(sim.getAgentCount(), agents) &&
+              node.allGather(totals.migratedIn, in) &&
+              node.allGather(totals.migratedOut, out) &&
+              node.allGather(totals.ghosts, ghosts) &&
+              node.allGather(static_cast<uint64_t>(totals.tickMs * 1000.0), tickUs) &&
+              node.allGather(static_cast<uint64_t>(totals.exchangeMs * 1000.0), exchangeUs);
+    if (!ok) return 1;
+    if (rank != 0) return 0;
+
+    const RegionLayout& layout = node.getLayout();
+    uint64_t totalAgents = 0, totalIn = 0, totalOut = 0;
+    std::printf("\n%-5s %9s %9s %9s %9s %9s %11s %10s %12s\n", "rank", "x_min", "x_max", "agents", "in", "out",
+                "ghosts/tick", "tick ms", "exchange ms");
+    for (uint32_t r = 0; r < opt.ranks; r++) {
+        totalAgents += agents[r];
+        totalIn += in[r];
+        totalOut += out[r];
+        std::printf("%-5u %9.0f %9.0f %9llu %9llu %9llu %11.0f %10.2f %12.2f\n", r, layout.bounds[r],
+                    layout.bounds[r + 1], static_cast<unsigned long long>(agents[r]),
+                    static_cast<unsigned long long>(in[r]), static_cast<unsigned long long>(out[r]),
+                    static_cast<double>(ghosts[r]) / opt.ticks, tickUs[r] / 1000.0 / opt.ticks,
+                    exchangeUs[r] / 1000.0 / opt.ticks);
+    }
+    std::printf("\n%u ranks, %u ticks in %.1f s (%.2f ms/tick), %llu agents, %u rebalances, migrations %s\n",
+                opt.ranks, opt.ticks, wallMs / 1000.0f, wallMs / opt.ticks,
+                static_cast<unsigned long long>(totalAgents), node.getRebalanceCount(),
+                totalIn == totalOut ? "balanced" : "LOST");
+
+    bench::JsonWriter json;
+    json.beginObject();
+    json.field("tactix_regions", 1);
+    json.field("ranks", opt.ranks);
+    json.field("agents", static_cast<uint64_t>(opt.config.agents));
+    json.field("ticks", opt.ticks);
+    json.field("seed", opt.config.seed);
+    json.field("world_width", opt.config.world.width);
+    json.field("world_height", opt.config.world.height);
+    json.field("ghost_band", opt.config.ghostBand);
+    json.field("hordes", opt.config.hordes);
+    json.field("wall_ms", wallMs);
+    json.field("final_agents", totalAgents);
+    json.field("rebalances", node.getRebalanceCount());
+    json.field("migrations_balanced", totalIn == totalOut);
+    json.key("regions");
+    json.beginArray();
+    for (uint32_t r = 0; r < opt.ranks; r++) {
+        json.beginObject();
+        json.field("rank", r);
+        json.field("x_min", layout.bounds[r]);
+        json.field("x_max", layout.bounds[r + 1]);
+        json.field("agents", agents[r]);
+        json.field("migrated_in", in[r]);
+        json.field("migrated_out", out[r]);
+        json.field("ghosts_per_tick", static_cast<double>(ghosts[r]) / opt.ticks);
+        json.field("tick_ms", tickUs[r] / 1000.0 / opt.ticks);
+        json.field("exchange_ms", exchangeUs[r] / 1000.0 / opt.ticks);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    if (!opt.outPath.empty() && bench::writeFile(opt.outPath, json.str())) {
+        std::printf("\nResults written to %s\n", opt.outPath.c_str());
+    }
+    return totalIn == totalOut ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        printUsage();
+        return 2;
+    }
+    spdlog::set_level(spdlog::level::warn);
+
+    if (opt.rank >= 0) return runRank(opt, static_cast<uint32_t>(opt.rank));
+
+#if !defined(_WIN32)
+    opt.name = opt.name.empty() ? "/tactix_regions_" + std::to_string(::getpid()) : opt.name;
+    std::printf("%u ranks x %zu agents (%.0fx%.0f world), segment %s\n", opt.ranks, opt.config.agents,
+                opt.config.world.width, opt.config.world.height, opt.name.c_str());
+    std::fflush(stdout);
+
+    // Fork before anything starts threads; rank 0 stays in this process
+    std::vector<pid_t> children;
+    for (uint32_t r = 1; r < opt.ranks; r++) {
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            std::_Exit(runRank(opt, r));
+        }
+        if (pid < 0) {
+            std::fprintf(stderr, "fork failed for rank %u\n", r);
+            return 1;
+        }
+        children.push_back(pid);
+    }
+    int result = runRank(opt, 0);
+    for (pid_t pid : children) {
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) result = 1;
+    }
+    return result;
+#else
+    std::fprintf(stderr, "Launching every rank needs fork(); start each with --rank R --name NAME\n");
+    return 1;
+#endif
+}
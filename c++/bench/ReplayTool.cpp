@@ -0,0 +1,187 @@
+// tactix_replay: headless recording, seeking and determinism checks for replay logs.
+//
+//   record - run a scripted headless session and write a replay
+//   seek   - fast-forward to a tick (nearest keyframe + re-simulation) and time it
+//   verify - compare seek-from-keyframe against re-simulating from the first keyframe
+#include "platform.h"
+#include "Simulation.hpp"
+#include "Snapshot.hpp"
+#include "Replay.hpp"
+#include "BenchCommon.hpp"
+#include "spdlog/spdlog.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string command;
+    std::string path;
+    size_t agents = 10000;
+    uint64_t ticks = 3600;
+    uint64_t targetTick = 0;
+    uint64_t seed = 1337;
+    uint32_t workers = 0;
+    uint32_t keyframeInterval = 600;
+    float tickBudget = 0.0f;  // Governor budget while recording, 0 = off
+    std::vector<std::pair<uint64_t, size_t>> script;  // (tick, agent count)
+};
+
+void printUsage() {
+    std::printf(
+        "Usage: tactix_replay record --out PATH [options]\n"
+        "       tactix_replay seek PATH --tick N [--workers N]\n"
+        "       tactix_replay verify PATH --tick N [--workers N]\n"
+        "  --agents N               Initial agents for record (default 10000)\n"
+        "  --ticks N                Ticks to record (default 3600)\n"
+        "  --seed N                 Simulation seed (default 1337)\n"
+        "  --keyframe-interval N    Ticks between keyframes (default 600)\n"
+        "  --script T:N,...         setAgentCount(N) at tick T during record\n"
+        "  --tick-budget MS         Record with the tick governor on (quality changes are logged)\n"
+        "  --workers N              Worker threads (default auto)\n");
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    if (argc < 2) return false;
+    opt.command = argv[1];
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return (i + 1 < argc) ? argv[++i] : ""; };
+
+        if (arg == "--out") {
+            opt.path = next();
+        } else if (arg == "--agents") {
+            opt.agents = std::stoul(next());
+        } else if (arg == "--ticks") {
+            opt.ticks = std::stoull(next());
+        } else if (arg == "--tick") {
+            opt.targetTick = std::stoull(next());
+        } else if (arg == "--seed") {
+            opt.seed = std::stoull(next());
+        } else if (arg == "--keyframe-interval") {
+            opt.keyframeInterval = static_cast<uint32_t>(std::stoul(next()));
+        } else if (arg == "--workers") {
+            std::string v = next();
+            opt.workers = v == "auto" ? 0u : static_cast<uint32_t>(std::stoul(v));
+        } else if (arg == "--tick-budget") {
+            opt.tickBudget = std::stof(next());
+        } else if (arg == "--script") {
+            for (const auto& entry : bench::splitList(next())) {
+                size_t colon = entry.find(':');
+                if (colon == std::string::npos) return false;
+                opt.script.push_back({std::stoull(entry.substr(0, colon)), std::stoul(entry.substr(colon + 1))});
+            }
+        } else if (arg[0] != '-' && opt.path.empty()) {
+            opt.path = arg;
+        } else {
+            return false;
+        }
+    }
+    return (opt.command == "record" || opt.command == "seek" || opt.command == "verify") && !opt.path.empty();
+}
+
+int record(const Options& opt) {
+    const bench::WorldSize size = bench::densityMatchedWorld(opt.agents);
+    Simulation sim(size.width, size.height, opt.workers);
+    sim.setSeed(opt.seed);
+    sim.init(opt.agents);
+    sim.setTickBudget(opt.tickBudget);
+
+    const float dt = 1.0f / 60.0f;
+    ReplayRecorder recorder(opt.keyframeInterval);
+    recorder.begin(sim, dt);
+    recorder.setPaused(sim, false);
+
+    auto start = bench::Clock::now();
+    for (uint64_t t = 0; t < opt.ticks; t++) {
+        for (const auto& [tick, count] : opt.script) {
+            if (tick == sim.getTickCount()) recorder.setAgentCount(sim, count);
+        }
+        sim.tick(dt);
+        recorder.afterTick(sim);
+    }
+    recorder.end(sim);
+    float ms = bench::msSince(start);
+
+    std::printf("Recorded %llu ticks in %.1f s (%zu agents at end, %zu keyframes)\n",
+                static_cast<unsigned long long>(opt.ticks), ms / 1000.0f,
+                sim.getAgentCount(), recorder.getLog().keyframes.size());
+    return recorder.getLog().save(opt.path) ? 0 : 1;
+}
+
+// Simulation sized for the replay's world
+std::unique_ptr<Simulation> makeSimulation(const ReplayLog& log, uint32_t workers) {
+    SnapshotInfo info;
+    const auto& first = log.keyframes.front().snapshot;
+    if (!Snapshot::readInfo(first.data(), first.size(), info)) return nullptr;
+    return std::make_unique<Simulation>(info.worldWidth, info.worldHeight, workers);
+}
+
+void printState(const char* label, const Simulation& sim) {
+    std::printf("%-10s tick %llu: %zu agents (%zu civilians, %zu zombies, %zu heroes)\n", label,
+                static_cast<unsigned long long>(sim.getTickCount()), sim.getAgentCount(),
+                sim.getCivilianCount(), sim.getZombieCount(), sim.getHeroCount());
+}
+
+int seek(const Options& opt) {
+    ReplayPlayer player;
+    if (!player.load(opt.path)) return 1;
+    auto sim = makeSimulation(player.getLog(), opt.workers);
+    if (!sim || !player.seek(*sim, opt.targetTick)) return 1;
+
+    std::printf("Seek to tick %llu: re-simulated %llu ticks in %.1f ms\n",
+                static_cast<unsigned long long>(sim->getTickCount()),
+                static_cast<unsigned long long>(player.getLastSeekTicks()), player.getLastSeekMs());
+    printState("state", *sim);
+    return 0;
+}
+
+int verify(const Options& opt) {
+    ReplayPlayer player;
+    if (!player.load(opt.path)) return 1;
+
+    // Reference: only the first keyframe, so the whole range is re-simulated
+    ReplayLog fromStart = player.getLog();
+    fromStart.keyframes.resize(1);
+    ReplayPlayer reference;
+    reference.open(std::move(fromStart));
+
+    auto simA = makeSimulation(player.getLog(), opt.workers);
+    auto simB = makeSimulation(player.getLog(), opt.workers);
+    if (!simA || !simB || !player.seek(*simA, opt.targetTick) || !reference.seek(*simB, opt.targetTick)) {
+        return 1;
+    }
+    std::printf("keyframe seek: %llu ticks in %.1f ms\n",
+                static_cast<unsigned long long>(player.getLastSeekTicks()), player.getLastSeekMs());
+    std::printf("full re-sim:   %llu ticks in %.1f ms\n",
+                static_cast<unsigned long long>(reference.getLastSeekTicks()), reference.getLastSeekMs());
+
+    std::vector<uint8_t> a, b;
+    Snapshot::write(*simA, a);
+    Snapshot::write(*simB, b);
+    printState("keyframe", *simA);
+    printState("full", *simB);
+    if (a != b) {
+        std::printf("DIVERGED: states differ at tick %llu\n", static_cast<unsigned long long>(simA->getTickCount()));
+        return 1;
+    }
+    std::printf("MATCH: identical state at tick %llu\n", static_cast<unsigned long long>(simA->getTickCount()));
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        printUsage();
+        return 2;
+    }
+    spdlog::set_level(spdlog::level::warn);
+
+    if (opt.command == "record") return record(opt);
+    if (opt.command == "seek") return seek(opt);
+    return verify(opt);
+}
@@ -0,0 +1,662 @@
+// tactix_bench: headless, fixed-seed scenario matrix over the full Simulation tick.
+//
+// Runs every (mix x agents x workers) combination, reports p50/p99 tick time per
+// phase, memory per agent and scaling efficiency, writes JSON, and optionally
+// gates against a stored baseline (exit code 1 on regression).
+//
+// --verify-determinism instead runs each (mix x agents) scenario under every worker
+// count and chunk size in lockstep with a 1-worker reference, compares state hashes
+// every tick and reports the first diverging tick, column and entity (exit code 1).
+#include "platform.h"
+#include "Simulation.hpp"
+#include "AllocationCounter.hpp"
+#include "Snapshot.hpp"
+#include "Telemetry.hpp"
+#include "StateHasher.hpp"
+#include "BenchCommon.hpp"
+#include "raylib.h"
+#include "spdlog/spdlog.h"
+
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct MixPreset {
+    const char* name;
+    PopulationMix mix;
+};
+
+// Population mixes the matrix can sweep
+const MixPreset kMixes[] = {
+    {"default", {0.90f, 0.05f}},   // Early outbreak (90/5/5)
+    {"outbreak", {0.60f, 0.35f}},  // Mid outbreak, lots of melee
+    {"heroic", {0.70f, 0.10f}},    // 20% heroes, shooting-heavy
+};
+
+struct Options {
+    std::vector<size_t> agents = {1000, 10000, 50000, 100000, 200000};
+    std::vector<uint32_t> workers;  // Empty = {1, auto}
+    std::vector<std::string> mixes = {"default"};
+    int warmupTicks = 60;
+    int measureTicks = 300;
+    unsigned int seed = 1337;
+    bool densityMatched = true;  // Scale the world so density matches 10k @ 1280x720
+    int worldWidth = 0;          // Explicit world size (--world), overrides density matching
+    int worldHeight = 0;
+    SpatialHashMode spatialMode = SpatialHashMode::Blocks;
+    uint32_t thinkInterval = 0;  // 0 = simulation default
+    bool hordes = false;
+    bool occlusion = true;       // Line of sight against buildings and trees
+    bool pinWorkers = false;     // One CPU per job system worker
+    bool phased = false;         // Separate separation/behaviors/movement passes
+    float tickBudget = 0.0f;     // Governor budget in ms, 0 = off (full quality)
+    std::string outPath = "tactix_bench.json";
+    std::string baselinePath;
+    std::string saveBaselinePath;
+    float tolerance = 0.10f;
+    std::string fromSnapshotPath;  // Start every scenario from this warmed-up state
+    std::string saveSnapshotPath;  // Write the post-warmup state of the first scenario
+    std::string telemetryPrefix;   // Stream measured ticks to PREFIX-<scenario>.tlm
+    bool verifyDeterminism = false;  // Compare state hashes across workers/chunk sizes
+    std::vector<uint32_t> chunkSizes = {64, Simulation::kDefaultChunkSize, 1024};
+    bool verbose = false;
+};
+
+struct PhaseStats {
+    std::vector<float> samples;
+    float p50 = 0.0f;
+    float p99 = 0.0f;
+};
+
+struct ScenarioResult {
+    std::string name;
+    std::string mix;
+    size_t agents = 0;
+    uint32_t workers = 0;
+    int worldWidth = 0;
+    int worldHeight = 0;
+    PhaseStats phases[8];  // Matches kPhaseNames
+    float meanTick = 0.0f;
+    size_t bytesPerAgent = 0;
+    size_t finalAgents = 0;
+    size_t finalHordes = 0;
+    size_t finalHordeMembers = 0;
+    uint32_t jobsStolen = 0;  // Sticky chunks run by another worker, warmup included
+    float speedup = 0.0f;
+    float efficiency = 0.0f;
+    uint64_t maxTickAllocations = 0;  // Measured ticks; needs TACTIX_COUNT_ALLOCATIONS
+    uint32_t qualityTicks[kQualityLevelCount] = {};  // Measured ticks run at each governor level
+};
+
+const char* kPhaseNames[8] = {
+    "total", "housekeeping", "spatial_hash", "separation",
+    "behaviors", "movement", "infections", "screen_wrap",
+};
+
+float phaseValue(const TickPhaseTimes& t, int phase) {
+    switch (phase) {
+        case 0: return t.total;
+        case 1: return t.housekeeping;
+        case 2: return t.spatialHash;
+        case 3: return t.separation;
+        case 4: return t.behaviors;
+        case 5: return t.movement;
+        case 6: return t.infections;
+        default: return t.screenWrap;
+    }
+}
+
+const MixPreset* findMix(const std::string& name) {
+    for (const auto& preset : kMixes) {
+        if (name == preset.name) return &preset;
+    }
+    return nullptr;
+}
+
+void printUsage() {
+    std::printf(
+        "Usage: tactix_bench [options]\n"
+        "  --agents LIST        Agent counts (default 1000,10000,50000,100000,200000)\n"
+        "  --workers LIST       Worker counts, 'auto' = available CPUs - 1 (default 1,auto)\n"
+        "  --mix LIST           Population mixes: default,outbreak,heroic (default default)\n"
+        "  --ticks N            Measured ticks per scenario (default 300)\n"
+        "  --warmup N           Unmeasured warmup ticks (default 60)\n"
+        "  --seed N             Simulation seed (default 1337)\n"
+        "  --fixed-world        Keep the 1280x720 world instead of density matching\n"
+        "  --world WxH          Explicit world size, e.g. 100000x100000\n"
+        "  --spatial MODE       Spatial grid storage: blocks or hashed (default blocks)\n"
+        "  --think-interval N   Max ticks between AI evaluations, 1 = every tick (default 8)\n"
+        "  --hordes             Simulate calm zombie packs as horde macro-agents\n"
+        "  --no-occlusion       Shots and gunshot hearing ignore buildings and trees\n"
+        "  --pin                Pin each job system worker to its own CPU (Linux)\n"
+        "  --phased             One pass and barrier per phase instead of the fused pass\n"
+        "                       (slower, but times separation and movement separately)\n"
+        "  --tick-budget MS     Let the tick governor degrade quality past this cost (default off)\n"
+        "  --quick              Small matrix for smoke runs (1k,10k agents, 120 ticks)\n"
+        "  --out PATH           JSON results path (default tactix_bench.json)\n"
+        "  --baseline PATH      Compare against a stored baseline, exit 1 on regression\n"
+        "  --tolerance F        Allowed p50 slowdown vs baseline (default 0.10 = 10%%)\n"
+        "  --save-baseline PATH Also write results as a new baseline\n"
+        "  --from-snapshot PATH Start from a saved state (agents and world from the file)\n"
+        "  --save-snapshot PATH Save the first scenario's state after warmup\n"
+        "  --telemetry PREFIX   Stream measured ticks of each scenario to PREFIX-<scenario>.tlm\n"
+        "  --verify-determinism Run each scenario with every worker count and chunk size and\n"
+        "                       compare state hashes per tick against 1 worker (warmup +\n"
+        "                       measured ticks); exit 1 on the first divergence\n"
+        "  --chunk-sizes LIST   Agents per job to verify (default 64,256,1024)\n"
+        "  --verbose            Keep simulation event logging enabled\n");
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string { return (i + 1 < argc) ? argv[++i] : ""; };
+
+        if (arg == "--agents") {
+            opt.agents.clear();
+            for (const auto& v : bench::splitList(next())) opt.agents.push_back(std::stoul(v));
+        } else if (arg == "--workers") {
+            opt.workers.clear();
+            for (const auto& v : bench::splitList(next())) {
+                opt.workers.push_back(v == "auto" ? 0u : static_cast<uint32_t>(std::stoul(v)));
+            }
+        } else if (arg == "--mix") {
+            opt.mixes = bench::splitList(next());
+        } else if (arg == "--ticks") {
+            opt.measureTicks = std::stoi(next());
+        } else if (arg == "--warmup") {
+            opt.warmupTicks = std::stoi(next());
+        } else if (arg == "--seed") {
+            opt.seed = static_cast<unsigned int>(std::stoul(next()));
+        } else if (arg == "--fixed-world") {
+            opt.densityMatched = false;
+        } else if (arg == "--world") {
+            std::string v = next();
+            size_t x = v.find('x');
+            if (x == std::string::npos) {
+                printUsage();
+                return false;
+            }
+            opt.worldWidth = std::stoi(v.substr(0, x));
+            opt.worldHeight = std::stoi(v.substr(x + 1));
+        } else if (arg == "--spatial") {
+            std::string v = next();
+            if (v == "blocks") {
+                opt.spatialMode = SpatialHashMode::Blocks;
+            } else if (v == "hashed") {
+                opt.spatialMode = SpatialHashMode::Hashed;
+            } else {
+                std::fprintf(stderr, "Unknown spatial mode '%s'\n", v.c_str());
+                return false;
+            }
+        } else if (arg == "--think-interval") {
+            opt.thinkInterval = static_cast<uint32_t>(std::stoul(next()));
+        } else if (arg == "--hordes") {
+            opt.hordes = true;
+        } else if (arg == "--no-occlusion") {
+            opt.occlusion = false;
+        } else if (arg == "--pin") {
+            opt.pinWorkers = true;
+        } else if (arg == "--phased") {
+            opt.phased = true;
+        } else if (arg == "--tick-budget") {
+            opt.tickBudget = std::stof(next());
+        } else if (arg == "--quick") {
+            opt.agents = {1000, 10000};
+            opt.measureTicks = 120;
+            opt.warmupTicks = 30;
+        } else if (arg == "--out") {
+            opt.outPath = next();
+        } else if (arg == "--baseline") {
+            opt.baselinePath = next();
+        } else if (arg == "--tolerance") {
+            opt.tolerance = std::stof(next());
+        } else if (arg == "--save-baseline") {
+            opt.saveBaselinePath = next();
+        } else if (arg == "--from-snapshot") {
+            opt.fromSnapshotPath = next();
+        } else if (arg == "--save-snapshot") {
+            opt.saveSnapshotPath = next();
+        } else if (arg == "--telemetry") {
+            opt.telemetryPrefix = next();
+        } else if (arg == "--verify-determinism") {
+            opt.verifyDeterminism = true;
+        } else if (arg == "--chunk-sizes") {
+            opt.chunkSizes.clear();
+            for (const auto& v : bench::splitList(next())) opt.chunkSizes.push_back(std::stoul(v));
+        } else if (arg == "--verbose") {
+            opt.verbose = true;
+        } else {
+            printUsage();
+            return false;
+        }
+    }
+
+    for (const auto& m : opt.mixes) {
+        if (!findMix(m)) {
+            std::fprintf(stderr, "Unknown mix '%s'\n", m.c_str());
+            return false;
+        }
+    }
+    if (opt.workers.empty()) {
+        opt.workers = {1, 0};
+    }
+    if (!opt.fromSnapshotPath.empty()) {
+        SnapshotInfo info;
+        if (!Snapshot::peek(opt.fromSnapshotPath, info)) {
+            return false;
+        }
+        opt.agents = {static_cast<size_t>(info.entityCount)};
+    }
+    return true;
+}
+
+// A scenario's simulation, initialized (or loaded from the snapshot) and unpaused
+std::unique_ptr<Simulation> createSimulation(const Options& opt, const MixPreset& mix, size_t agents,
+                                             uint32_t workers, int& worldWidth, int& worldHeight) {
+    const bench::WorldSize size = bench::densityMatchedWorld(opt.densityMatched ? agents : 0);
+    worldWidth = size.width;
+    worldHeight = size.height;
+    if (opt.worldWidth > 0 && opt.worldHeight > 0) {
+        worldWidth = opt.worldWidth;
+        worldHeight = opt.worldHeight;
+    }
+
+    SnapshotInfo snapshot;
+    if (!opt.fromSnapshotPath.empty() && Snapshot::peek(opt.fromSnapshotPath, snapshot)) {
+        worldWidth = snapshot.worldWidth;
+        worldHeight = snapshot.worldHeight;
+    }
+
+    WorldConfig world;
+    world.width = static_cast<float>(worldWidth);
+    world.height = static_cast<float>(worldHeight);
+    world.spatialMode = opt.spatialMode;
+    auto sim = std::make_unique<Simulation>(world, workers, opt.pinWorkers);
+    sim->setSeed(opt.seed);
+    if (opt.thinkInterval > 0) sim->setMaxThinkInterval(opt.thinkInterval);
+    sim->setHordesEnabled(opt.hordes);
+    sim->setLineOfSightEnabled(opt.occlusion);
+    sim->setFusedPipeline(!opt.phased);
+    sim->init(agents, mix.mix);
+    if (!opt.fromSnapshotPath.empty()) {
+        Snapshot::load(*sim, opt.fromSnapshotPath);
+    }
+    sim->setPaused(false);
+    return sim;
+}
+
+ScenarioResult runScenario(Options& opt, const MixPreset& mix, size_t agents, uint32_t workers) {
+    ScenarioResult result;
+    result.mix = mix.name;
+    result.agents = agents;
+
+    std::unique_ptr<Simulation> simulation = createSimulation(opt, mix, agents, workers,
+                                                              result.worldWidth, result.worldHeight);
+    Simulation& sim = *simulation;
+    sim.setTickBudget(opt.tickBudget);
+
+    result.workers = sim.getWorkerCount();
+    result.bytesPerAgent = sim.getMemoryPerAgent();
+    result.name = std::string(mix.name) + "/n" + std::to_string(agents) + "/w" + std::to_string(result.workers);
+
+    const float dt = 1.0f / 60.0f;
+    for (int t = 0; t < opt.warmupTicks; t++) {
+        sim.tick(dt);
+    }
+    if (!opt.saveSnapshotPath.empty()) {
+        Snapshot::save(sim, opt.saveSnapshotPath);
+        opt.saveSnapshotPath.clear();
+    }
+    for (auto& phase : result.phases) {
+        phase.samples.reserve(opt.measureTicks);
+    }
+    TelemetrySink telemetry;
+    if (!opt.telemetryPrefix.empty()) {
+        TelemetryConfig config;
+        config.path = opt.telemetryPrefix + "-" + mix.name + "-n" + std::to_string(agents) +
+                      "-w" + std::to_string(result.workers) + ".tlm";
+        telemetry.open(config);
+    }
+    for (int t = 0; t < opt.measureTicks; t++) {
+        result.qualityTicks[static_cast<uint32_t>(sim.getQualityLevel())]++;
+        sim.tick(dt);
+        const TickPhaseTimes& times = sim.getLastPhaseTimes();
+        telemetry.record(sim, times.total);
+        result.maxTickAllocations = std::max(result.maxTickAllocations, sim.getLastTickAllocations());
+        for (int p = 0; p < 8; p++) {
+            result.phases[p].samples.push_back(phaseValue(times, p));
+        }
+    }
+
+    for (auto& phase : result.phases) {
+        phase.p50 = bench::percentile(phase.samples, 50.0f);
+        phase.p99 = bench::percentile(phase.samples, 99.0f);
+    }
+    result.meanTick = bench::mean(result.phases[0].samples);
+    result.finalAgents = sim.getAgentCount();
+    result.finalHordes = sim.getHordeCount();
+    result.finalHordeMembers = sim.getHordeMemberCount();
+    result.jobsStolen = sim.getJobsStolen();
+    return result;
+}
+
+// Speedup/efficiency relative to the lowest worker count run for the same mix and size
+void computeScaling(std::vector<ScenarioResult>& results) {
+    for (auto& r : results) {
+        const ScenarioResult* ref = nullptr;
+        for (const auto& other : results) {
+            if (other.mix != r.mix || other.agents != r.agents) continue;
+            if (!ref || other.workers < ref->workers) ref = &other;
+        }
+        if (!ref || r.phases[0].p50 <= 0.0f) continue;
+        r.speedup = ref->phases[0].p50 / r.phases[0].p50;
+        float workerRatio = static_cast<float>(r.workers) / static_cast<float>(ref->workers);
+        r.efficiency = r.speedup / workerRatio;
+    }
+}
+
+std::string toJson(const Options& opt, const std::vector<ScenarioResult>& results) {
+    bench::JsonWriter json;
+    json.beginObject();
+    json.field("tactix_bench", 1);
+    json.field("seed", static_cast<uint64_t>(opt.seed));
+    json.field("warmup_ticks", opt.warmupTicks);
+    json.field("measure_ticks", opt.measureTicks);
+    json.field("spatial", opt.spatialMode == SpatialHashMode::Hashed ? "hashed" : "blocks");
+    json.field("think_interval", opt.thinkInterval > 0 ? opt.thinkInterval : Simulation::kDefaultThinkInterval);
+    json.field("hordes", opt.hordes);
+    json.field("occlusion", opt.occlusion);
+    json.field("pipeline", opt.phased ? "phased" : "fused");
+    json.field("tick_budget_ms", opt.tickBudget);
+#ifdef TACTIX_COMPACT_STATE
+    json.field("state_layout", "compact");
+#else
+    json.field("state_layout", "float");
+#endif
+    json.field("hardware_threads", std::thread::hardware_concurrency());
+    json.field("available_cpus", JobSystem::availableCpus());
+    json.field("pinned_workers", opt.pinWorkers);
+    json.key("scenarios");
+    json.beginArray();
+    for (const auto& r : results) {
+        json.beginObject();
+        json.field("name", r.name);
+        json.field("mix", r.mix);
+        json.field("agents", static_cast<uint64_t>(r.agents));
+        json.field("workers", r.workers);
+        json.field("world_width", r.worldWidth);
+        json.field("world_height", r.worldHeight);
+        json.field("final_agents", static_cast<uint64_t>(r.finalAgents));
+        json.field("final_hordes", static_cast<uint64_t>(r.finalHordes));
+        json.field("final_horde_members", static_cast<uint64_t>(r.finalHordeMembers));
+        json.field("jobs_stolen", r.jobsStolen);
+        json.field("bytes_per_agent", static_cast<uint64_t>(r.bytesPerAgent));
+        json.field("tick_mean_ms", r.meanTick);
+        json.field("speedup", r.speedup);
+        json.field("efficiency", r.efficiency);
+        if (opt.tickBudget > 0.0f) {
+            json.key("quality_ticks");  // Indexed by QualityLevel
+            json.beginArray();
+            for (uint32_t ticks : r.qualityTicks) json.value(static_cast<uint64_t>(ticks));
+            json.endArray();
+        }
+        if (AllocationCounter::isEnabled()) {
+            json.field("max_tick_allocations", r.maxTickAllocations);
+        }
+        json.key("phases");
+        json.beginObject();
+        for (int p = 0; p < 8; p++) {
+            json.key(kPhaseNames[p]);
+            json.beginObject();
+            json.field("p50_ms", r.phases[p].p50);
+            json.field("p99_ms", r.phases[p].p99);
+            json.endObject();
+        }
+        json.endObject();
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    return json.str();
+}
+
+// Returns the number of regressed scenarios (-1 if the baseline is unreadable)
+int compareBaseline(const Options& opt, const std::vector<ScenarioResult>& results) {
+    std::ifstream in(opt.baselinePath);
+    if (!in) {
+        std::fprintf(stderr, "Cannot open baseline %s\n", opt.baselinePath.c_str());
+        return -1;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    std::string content = text.str();
+
+    bench::JsonValue root;
+    bench::JsonReader reader(content);
+    const bench::JsonValue* scenarios = nullptr;
+    if (!reader.parse(root) || !(scenarios = root.find("scenarios"))) {
+        std::fprintf(stderr, "Baseline %s is not a tactix_bench result file\n", opt.baselinePath.c_str());
+        return -1;
+    }
+
+    int regressions = 0;
+    std::printf("\nBaseline comparison (%s, tolerance %.0f%%)\n", opt.baselinePath.c_str(), opt.tolerance * 100.0f);
+    for (const auto& r : results) {
+        const bench::JsonValue* match = nullptr;
+        for (const auto& s : scenarios->items) {
+            if (s.stringOr("name", "") == r.name) { match = &s; break; }
+        }
+        if (!match) {
+            std::printf("  %-28s  (not in baseline)\n", r.name.c_str());
+            continue;
+        }
+        const bench::JsonValue* phases = match->find("phases");
+        const bench::JsonValue* total = phases ? phases->find("total") : nullptr;
+        if (!total) continue;
+
+        double baseP50 = total->numberOr("p50_ms", 0.0);
+        double delta = baseP50 > 0.0 ? (r.phases[0].p50 - baseP50) / baseP50 : 0.0;
+        bool regressed = delta > opt.tolerance;
+        regressions += regressed ? 1 : 0;
+        std::printf("  %-28s  p50 %8.3f ms vs %8.3f ms  (%+6.1f%%)%s\n",
+                    r.name.c_str(), r.phases[0].p50, baseP50, delta * 100.0,
+                    regressed ? "  REGRESSION" : "");
+
+        // Point at the phase responsible when the total regressed
+        if (regressed) {
+            for (int p = 1; p < 8; p++) {
+                const bench::JsonValue* phase = phases->find(kPhaseNames[p]);
+                double basePhase = phase ? phase->numberOr("p50_ms", 0.0) : 0.0;
+                if (basePhase <= 0.0) continue;
+                double phaseDelta = (r.phases[p].p50 - basePhase) / basePhase;
+                if (phaseDelta > opt.tolerance) {
+                    std::printf("      %-14s %8.3f ms vs %8.3f ms  (%+6.1f%%)\n",
+                                kPhaseNames[p], r.phases[p].p50, basePhase, phaseDelta * 100.0);
+                }
+            }
+        }
+    }
+    return regressions;
+}
+
+const char* typeName(AgentType type) {
+    switch (type) {
+        case AgentType::Civilian: return "civilian";
+        case AgentType::Zombie: return "zombie";
+        case AgentType::Hero: return "hero";
+    }
+    return "?";
+}
+
+// Lockstep runs of one scenario: every (workers x chunk size) variant against a
+// 1-worker reference at the default chunk size. Returns the number that diverged.
+int verifyScenario(const Options& opt, const MixPreset& mix, size_t agents) {
+    struct Variant {
+        uint32_t workers;
+        uint32_t chunkSize;
+        std::unique_ptr<Simulation> sim;
+        StateHasher hasher;
+        bool diverged = false;
+    };
+    std::vector<Variant> variants;
+    auto addVariant = [&](uint32_t workers, uint32_t chunkSize) {
+        for (const auto& v : variants) {
+            if (v.workers == workers && v.chunkSize == chunkSize) return;
+        }
+        variants.push_back({workers, chunkSize, nullptr, {}, false});
+    };
+    addVariant(1, Simulation::kDefaultChunkSize);  // Reference
+    for (uint32_t workers : opt.workers) {
+        // Resolve 'auto' up front so it dedupes against explicit counts
+        const uint32_t resolved = workers > 0 ? workers : std::max(1u, JobSystem::availableCpus() - 1);
+        for (uint32_t chunkSize : opt.chunkSizes) addVariant(resolved, std::max(1u, chunkSize));
+    }
+
+    int worldWidth = 0;
+    int worldHeight = 0;
+    for (auto& v : variants) {
+        v.sim = createSimulation(opt, mix, agents, v.workers, worldWidth, worldHeight);
+        v.sim->setChunkSize(v.chunkSize);  // The governor stays off: its levels follow wall time
+    }
+    std::printf("%s/n%zu: %zu variants vs w1/c%u, %d ticks\n", mix.name, agents, variants.size() - 1,
+                Simulation::kDefaultChunkSize, opt.warmupTicks + opt.measureTicks);
+
+    // Tick 0 is the initial state, so setup differences show up too
+    using Clock = std::chrono::steady_clock;
+    double hashSeconds = 0.0;
+    const float dt = 1.0f / 60.0f;
+    const int ticks = opt.warmupTicks + opt.measureTicks;
+    Variant& reference = variants[0];
+    for (int t = 0; t <= ticks; t++) {
+        for (auto& v : variants) {
+            if (v.diverged) continue;
+            if (t > 0) v.sim->tick(dt);
+            auto hashStart = Clock::now();
+            v.hasher.update(v.sim->getEntities());
+            if (&v == &reference) hashSeconds += std::chrono::duration<double>(Clock::now() - hashStart).count();
+        }
+        for (size_t n = 1; n < variants.size(); n++) {
+            Variant& v = variants[n];
+            if (v.diverged || v.hasher.getTickHash() == reference.hasher.getTickHash()) continue;
+            v.diverged = true;
+            StateDivergence d;
+            if (!findDivergence(reference.sim->getEntities(), v.sim->getEntities(), d)) {
+                d.column = "?";  // Hash collision across different states, in principle
+            }
+            const EntityHot& e = reference.sim->getEntities();
+            std::printf("  w%u/c%-5u DIVERGED at tick %d: column %s, entity %zu", v.workers, v.chunkSize,
+                        t, d.column.c_str(), d.entity);
+            if (d.entity < e.count) {
+                std::printf(" (%s, state %u)", typeName(e.type[d.entity]),
+                            static_cast<unsigned>(e.state[d.entity]));
+            }
+            std::printf(": expected %.9g, got %.9g\n", d.expected, d.actual);
+            v.sim.reset();  // Frees its workers for the ones still running
+        }
+    }
+
+    int diverged = 0;
+    for (size_t n = 1; n < variants.size(); n++) {
+        const Variant& v = variants[n];
+        if (v.diverged) {
+            diverged++;
+            continue;
+        }
+        std::printf("  w%u/c%-5u MATCH (%llu ticks, running hash %016llx)\n", v.workers, v.chunkSize,
+                    static_cast<unsigned long long>(v.hasher.getTicksHashed()),
+                    static_cast<unsigned long long>(v.hasher.getRunningHash()));
+    }
+    std::printf("  hashing: %.3f ms per tick for %zu agents\n", hashSeconds * 1000.0 / (ticks + 1),
+                reference.sim->getAgentCount());
+    std::fflush(stdout);
+    return diverged;
+}
+
+int verifyDeterminism(const Options& opt) {
+    int diverged = 0;
+    for (const auto& mixName : opt.mixes) {
+        const MixPreset& mix = *findMix(mixName);
+        for (size_t agents : opt.agents) {
+            diverged += verifyScenario(opt, mix, agents);
+        }
+    }
+    if (diverged > 0) {
+        std::printf("\n%d variant(s) diverged\n", diverged);
+        return 1;
+    }
+    std::printf("\nAll variants deterministic\n");
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        return 2;
+    }
+
+    // Event lines are formatted off the tick path; this only keeps the console quiet
+    spdlog::set_level(opt.verbose ? spdlog::level::info : spdlog::level::warn);
+    if (opt.verifyDeterminism) {
+        return verifyDeterminism(opt);
+    }
+
+    std::vector<ScenarioResult> results;
+    std::printf("%-28s %10s %10s %10s %10s %10s\n",
+                "scenario", "p50 ms", "p99 ms", "behav p50", "sep p50", "B/agent");
+    for (const auto& mixName : opt.mixes) {
+        const MixPreset& mix = *findMix(mixName);
+        for (size_t agents : opt.agents) {
+            for (uint32_t workers : opt.workers) {
+                results.push_back(runScenario(opt, mix, agents, workers));
+                const ScenarioResult& r = results.back();
+                std::printf("%-28s %10.3f %10.3f %10.3f %10.3f %10zu\n",
+                            r.name.c_str(), r.phases[0].p50, r.phases[0].p99,
+                            r.phases[4].p50, r.phases[3].p50, r.bytesPerAgent);
+                if (opt.tickBudget > 0.0f) {
+                    std::printf("  ^ quality ticks: full %u, reduced queries %u, coarse separation %u, limited catch-up %u\n",
+                                r.qualityTicks[0], r.qualityTicks[1], r.qualityTicks[2], r.qualityTicks[3]);
+                }
+                if (AllocationCounter::isEnabled() && r.maxTickAllocations > 0) {
+                    std::printf("  ^ %llu global allocations in the worst measured tick\n",
+                                static_cast<unsigned long long>(r.maxTickAllocations));
+                }
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    computeScaling(results);
+    std::printf("\nScaling (relative to fewest workers per scenario):\n");
+    for (const auto& r : results) {
+        std::printf("  %-28s speedup %5.2fx  efficiency %5.1f%%\n",
+                    r.name.c_str(), r.speedup, r.efficiency * 100.0f);
+    }
+
+    std::string json = toJson(opt, results);
+    if (!opt.outPath.empty() && bench::writeFile(opt.outPath, json)) {
+        std::printf("\nResults written to %s\n", opt.outPath.c_str());
+    }
+    if (!opt.saveBaselinePath.empty() && bench::writeFile(opt.saveBaselinePath, json)) {
+        std::printf("Baseline written to %s\n", opt.saveBaselinePath.c_str());
+    }
+
+    if (!opt.baselinePath.empty()) {
+        int regressions = compareBaseline(opt, results);
+        if (regressions < 0) return 2;
+        if (regressions > 0) {
+            std::printf("\n%d scenario(s) regressed beyond %.0f%%\n", regressions, opt.tolerance * 100.0f);
+            return 1;
+        }
+        std::printf("\nNo regressions beyond %.0f%%\n", opt.tolerance * 100.0f);
+    }
+    return 0;
+}
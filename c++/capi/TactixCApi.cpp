@@ -0,0 +1,194 @@
+#include "tactix.h"
+#include "Simulation.hpp"
+#include "spdlog/spdlog.h"
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <type_traits>
+
+// The handle is the simulation plus the scratch the batch commands reuse
+struct tactix_sim {
+    std::unique_ptr<Simulation> sim;
+    std::vector<uint32_t> rows;  // tactix_kill's copy (killAgents sorts it)
+};
+
+namespace {
+constexpr float kTickDt = 1.0f / 60.0f;
+
+template <typename T>
+struct ColumnType;
+template <> struct ColumnType<float> { static constexpr uint32_t kType = TACTIX_F32; };
+template <> struct ColumnType<uint8_t> { static constexpr uint32_t kType = TACTIX_U8; };
+template <> struct ColumnType<uint16_t> { static constexpr uint32_t kType = TACTIX_U16; };
+template <> struct ColumnType<uint32_t> { static constexpr uint32_t kType = TACTIX_U32; };
+template <> struct ColumnType<AgentType> { static constexpr uint32_t kType = TACTIX_U8; };
+template <> struct ColumnType<AgentState> { static constexpr uint32_t kType = TACTIX_U8; };
+template <int FracBits>
+struct ColumnType<Quantized<int16_t, FracBits>> { static constexpr uint32_t kType = TACTIX_I16; };
+
+template <typename Column>
+void describe(const char* name, const Column& column, tactix_column_info* out) {
+    using T = typename Column::value_type;
+    // The pointer is handed out as raw elements: no padding or hidden state allowed
+    static_assert(std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>);
+    out->name = name;
+    out->data = column.empty() ? nullptr : column.data();
+    out->length = column.size();
+    out->type = ColumnType<T>::kType;
+    out->element_size = static_cast<uint32_t>(sizeof(T));
+    out->fraction_bits = 0;
+    if constexpr (ColumnType<T>::kType == TACTIX_I16) out->fraction_bits = T::kFracBits;
+}
+
+// Runs a command, turning exceptions into a return code: nothing may unwind into C
+template <typename Fn>
+int guarded(const char* what, Fn&& fn) {
+    try {
+        fn();
+        return TACTIX_OK;
+    } catch (const std::exception& e) {
+        spdlog::error("tactix_{}: {}", what, e.what());
+    } catch (...) {
+        spdlog::error("tactix_{}: unknown exception", what);
+    }
+    return TACTIX_ERROR_INTERNAL;
+}
+}
+
+extern "C" {
+
+int tactix_api_version(void) {
+    return TACTIX_API_VERSION;
+}
+
+void tactix_config_default(tactix_config* config) {
+    if (!config) return;
+    *config = tactix_config{};
+    config->world_width = 1280.0f;
+    config->world_height = 720.0f;
+    config->agents = 10000;
+    config->civilians = PopulationMix{}.civilians;
+    config->zombies = PopulationMix{}.zombies;
+    config->seed = 1337;
+    config->workers = 0;
+    config->hordes = 0;
+    config->occlusion = 1;
+    config->log_events = 0;
+}
+
+tactix_sim* tactix_create(const tactix_config* config) {
+    tactix_config defaults;
+    tactix_config_default(&defaults);
+    const tactix_config& c = config ? *config : defaults;
+    if (!(c.world_width > 0.0f) || !(c.world_height > 0.0f)) {
+        spdlog::error("tactix_create: world size must be positive");
+        return nullptr;
+    }
+
+    auto handle = std::make_unique<tactix_sim>();
+    int result = guarded("create", [&]() {
+        WorldConfig world;
+        world.width = c.world_width;
+        world.height = c.world_height;
+        handle->sim = std::make_unique<Simulation>(world, c.workers);
+        Simulation& sim = *handle->sim;
+        sim.setSeed(c.seed);
+        sim.setHordesEnabled(c.hordes != 0);
+        sim.setLineOfSightEnabled(c.occlusion != 0);
+        sim.getEventLog().setEnabled(c.log_events != 0);
+        PopulationMix mix;
+        mix.civilians = c.civilians;
+        mix.zombies = c.zombies;
+        sim.init(c.agents, mix);
+        sim.setPaused(false);
+    });
+    return result == TACTIX_OK ? handle.release() : nullptr;
+}
+
+void tactix_destroy(tactix_sim* sim) {
+    delete sim;
+}
+
+int tactix_step(tactix_sim* sim, uint32_t ticks) {
+    if (!sim) return TACTIX_ERROR_ARGUMENT;
+    return guarded("step", [&]() {
+        for (uint32_t t = 0; t < ticks; t++) sim->sim->tick(kTickDt);
+    });
+}
+
+size_t tactix_agent_count(const tactix_sim* sim) {
+    return sim ? sim->sim->getAgentCount() : 0;
+}
+
+uint64_t tactix_tick_count(const tactix_sim* sim) {
+    return sim ? sim->sim->getTickCount() : 0;
+}
+
+uint32_t tactix_column_count(const tactix_sim* sim) {
+    if (!sim) return 0;
+    uint32_t count = 0;
+    sim->sim->getEntities().forEachColumn([&count](const char*, const auto&) { count++; });
+    return count;
+}
+
+int tactix_column(const tactix_sim* sim, const char* name, tactix_column_info* out) {
+    if (!sim || !name || !out) return TACTIX_ERROR_ARGUMENT;
+    bool found = false;
+    sim->sim->getEntities().forEachColumn([&](const char* columnName, const auto& column) {
+        if (found || std::strcmp(columnName, name) != 0) return;
+        describe(columnName, column, out);
+        found = true;
+    });
+    return found ? TACTIX_OK : TACTIX_ERROR_ARGUMENT;
+}
+
+int tactix_column_at(const tactix_sim* sim, uint32_t index, tactix_column_info* out) {
+    if (!sim || !out) return TACTIX_ERROR_ARGUMENT;
+    uint32_t n = 0;
+    bool found = false;
+    sim->sim->getEntities().forEachColumn([&](const char* columnName, const auto& column) {
+        if (n++ != index) return;
+        describe(columnName, column, out);
+        found = true;
+    });
+    return found ? TACTIX_OK : TACTIX_ERROR_ARGUMENT;
+}
+
+int tactix_spawn(tactix_sim* sim, size_t count, const float* pos_x, const float* pos_y,
+                 const float* vel_x, const float* vel_y, const uint8_t* types) {
+    if (!sim) return TACTIX_ERROR_ARGUMENT;
+    if (count == 0) return TACTIX_OK;
+    if (!pos_x || !pos_y || !types || (!vel_x) != (!vel_y)) return TACTIX_ERROR_ARGUMENT;
+    for (size_t n = 0; n < count; n++) {
+        if (types[n] > TACTIX_HERO) return TACTIX_ERROR_ARGUMENT;
+    }
+    return guarded("spawn", [&]() {
+        // Workers read the caller's arrays concurrently; nothing writes them
+        sim->sim->spawnBatch(count, [=](const SpawnRandom& r) {
+            SpawnParams p;
+            p.posX = pos_x[r.index];
+            p.posY = pos_y[r.index];
+            p.velX = vel_x ? vel_x[r.index] : 0.0f;
+            p.velY = vel_y ? vel_y[r.index] : 0.0f;
+            p.type = static_cast<AgentType>(types[r.index]);
+            return p;
+        });
+    });
+}
+
+int tactix_kill(tactix_sim* sim, const uint32_t* rows, size_t count) {
+    if (!sim || (count > 0 && !rows)) return TACTIX_ERROR_ARGUMENT;
+    return guarded("kill", [&]() {
+        sim->rows.assign(rows, rows + count);
+        sim->sim->killAgents(sim->rows);
+    });
+}
+
+int tactix_set_velocities(tactix_sim* sim, const uint32_t* rows, size_t count,
+                          const float* vel_x, const float* vel_y) {
+    if (!sim || (count > 0 && (!rows || !vel_x || !vel_y))) return TACTIX_ERROR_ARGUMENT;
+    sim->sim->setVelocities(rows, count, vel_x, vel_y);
+    return TACTIX_OK;
+}
+
+}  // extern "C"
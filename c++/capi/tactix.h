@@ -0,0 +1,143 @@
+#ifndef TACTIX_H
+#define TACTIX_H
+
+/*
+ * C API over a headless tactix simulation (libtactix), for drivers and analytics
+ * that live outside the app: Python via ctypes, DuckDB, anything with a C FFI.
+ *
+ * State is exposed without copying. tactix_column() returns a read-only pointer to
+ * one of the simulation's SoA columns (see EntityHot in src/Simulation.hpp) and its
+ * length, so numpy.frombuffer / ctypes views see millions of agents as they are.
+ * Pointers are valid between calls: anything that changes the simulation
+ * (tactix_step, tactix_spawn, tactix_kill, tactix_set_velocities, tactix_destroy)
+ * may reallocate or reorder the columns, so fetch them again afterwards.
+ *
+ * Commands take whole columns too: spawning, killing and setting velocities are one
+ * call per batch with parallel arrays, never one call per agent.
+ *
+ * Agents are addressed by their current row. Removal swaps the last agents into the
+ * freed rows, so rows are not stable identities across calls that remove agents
+ * (killing, and ticks in which zombies die or corpses are eaten).
+ *
+ * A handle is not thread-safe; use one per thread or serialize the calls. The
+ * simulation runs its own worker threads inside tactix_step.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(TACTIX_CAPI_BUILD)
+#    define TACTIX_API __declspec(dllexport)
+#  else
+#    define TACTIX_API __declspec(dllimport)
+#  endif
+#else
+#  define TACTIX_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped whenever a signature or struct below changes incompatibly */
+#define TACTIX_API_VERSION 1
+
+typedef struct tactix_sim tactix_sim;
+
+/* Return codes */
+enum {
+    TACTIX_OK = 0,
+    TACTIX_ERROR_ARGUMENT = -1,  /* Null handle/array, unknown column, bad type */
+    TACTIX_ERROR_INTERNAL = -2   /* The simulation threw; see the log */
+};
+
+/* Agent types and states, same values as AgentType / AgentState */
+enum {
+    TACTIX_CIVILIAN = 0,
+    TACTIX_ZOMBIE = 1,
+    TACTIX_HERO = 2
+};
+enum {
+    TACTIX_IDLE = 0,
+    TACTIX_PATROL = 1,
+    TACTIX_FLEEING = 2,
+    TACTIX_PURSUING = 3,
+    TACTIX_SEARCHING = 4,
+    TACTIX_DEAD = 5,
+    TACTIX_FIGHTING = 6,
+    TACTIX_BITTEN = 7
+};
+
+/* Element types of a column. I16 columns are fixed point (compact-state builds):
+ * value = raw / 2^fraction_bits. U16 columns are the low bits of tick numbers
+ * (compact-state builds). */
+enum {
+    TACTIX_U8 = 0,
+    TACTIX_U32 = 1,
+    TACTIX_F32 = 2,
+    TACTIX_I16 = 3,
+    TACTIX_U16 = 4
+};
+
+typedef struct tactix_config {
+    float world_width;     /* Default 1280 x 720 */
+    float world_height;
+    uint32_t agents;       /* Initial population, default 10000 */
+    float civilians;       /* Population shares, heroes get the rest (default 0.90, 0.05) */
+    float zombies;
+    uint64_t seed;         /* Default 1337 */
+    uint32_t workers;      /* Job system threads, 0 = available CPUs - 1 */
+    uint32_t hordes;       /* Non-zero: horde macro-agents on */
+    uint32_t occlusion;    /* Non-zero (default): buildings and trees block line of sight */
+    uint32_t log_events;   /* Non-zero: per-event log lines through spdlog (default 0, totals only) */
+} tactix_config;
+
+typedef struct tactix_column_info {
+    const char* name;      /* Static string, e.g. "posX" */
+    const void* data;      /* First element, length elements; NULL when length is 0 */
+    size_t length;         /* Agents */
+    uint32_t type;         /* TACTIX_U8 / U16 / U32 / F32 / I16 */
+    uint32_t element_size; /* Bytes */
+    uint32_t fraction_bits;/* I16 only */
+} tactix_column_info;
+
+TACTIX_API int tactix_api_version(void);
+
+/* Fills config with the defaults above */
+TACTIX_API void tactix_config_default(tactix_config* config);
+
+/* NULL config = defaults. Returns NULL on failure. */
+TACTIX_API tactix_sim* tactix_create(const tactix_config* config);
+TACTIX_API void tactix_destroy(tactix_sim* sim);
+
+/* Runs ticks fixed 1/60 s ticks */
+TACTIX_API int tactix_step(tactix_sim* sim, uint32_t ticks);
+
+TACTIX_API size_t tactix_agent_count(const tactix_sim* sim);
+TACTIX_API uint64_t tactix_tick_count(const tactix_sim* sim);
+
+/* Columns by name, or by index in [0, tactix_column_count()) to list them all */
+TACTIX_API uint32_t tactix_column_count(const tactix_sim* sim);
+TACTIX_API int tactix_column(const tactix_sim* sim, const char* name, tactix_column_info* out);
+TACTIX_API int tactix_column_at(const tactix_sim* sim, uint32_t index, tactix_column_info* out);
+
+/* Appends count agents. vel_x / vel_y may be NULL (standing still); types are
+ * TACTIX_CIVILIAN / ZOMBIE / HERO. The new agents are rows [old count, old count +
+ * count). */
+TACTIX_API int tactix_spawn(tactix_sim* sim, size_t count, const float* pos_x, const float* pos_y,
+                            const float* vel_x, const float* vel_y, const uint8_t* types);
+
+/* Removes the agents at the given rows (duplicates and out-of-range rows ignored) */
+TACTIX_API int tactix_kill(tactix_sim* sim, const uint32_t* rows, size_t count);
+
+/* Sets the velocity of the agents at rows[n] to (vel_x[n], vel_y[n]). Behaviors steer
+ * from there, so it acts as an impulse for agents that are moving on their own. */
+TACTIX_API int tactix_set_velocities(tactix_sim* sim, const uint32_t* rows, size_t count,
+                                     const float* vel_x, const float* vel_y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TACTIX_H */
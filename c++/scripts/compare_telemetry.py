@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""Measure behavioral divergence between two telemetry runs of the same scenario.
+
+Meant for checking a TACTIX_COMPACT_STATE build against the default float build:
+run the same tactix_bench scenario (same seed, agents, ticks) with --telemetry from
+both builds, then
+
+    python3 scripts/compare_telemetry.py float-10000a-1w.tlm compact-10000a-1w.tlm
+
+Per population column it reports the largest and mean per-tick gap (as a share of
+the agent count) and the final gap; per event column the run totals. With
+--tolerance F it exits 1 when any final population gap exceeds F of the agents.
+"""
+import argparse
+import sys
+
+from read_telemetry import load
+
+POPULATION = ("civilians", "zombies", "heroes", "bitten", "dead", "fighting", "fleeing")
+EVENTS = ("shots_fired", "zombies_shot", "combats_started", "civilians_bitten", "civilians_killed",
+          "infection_deaths", "reanimations", "corpses_eaten", "zombies_killed_by_civilians",
+          "zombies_killed_by_heroes", "heroes_turned")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("reference", help="telemetry of the reference (float) run")
+    parser.add_argument("candidate", help="telemetry of the run to compare")
+    parser.add_argument("--tolerance", type=float, help="max allowed final population gap, share of agents")
+    args = parser.parse_args()
+
+    ref = load(args.reference, use_numpy=False)["ticks"]
+    cand = load(args.candidate, use_numpy=False)["ticks"]
+    if not ref or not cand:
+        sys.exit("both files need a ticks table")
+
+    n = min(len(ref["tick"]), len(cand["tick"]))
+    if ref["tick"][0] != cand["tick"][0]:
+        sys.exit(f"runs start at different ticks ({ref['tick'][0]} vs {cand['tick'][0]})")
+    if len(ref["tick"]) != len(cand["tick"]):
+        print(f"note: comparing the first {n} ticks only")
+    agents = max(1, int(ref["agents"][0]))
+
+    print(f"{n} ticks, {agents} agents at start")
+    print(f"{'population':<12} {'max gap':>10} {'mean gap':>10} {'final ref':>10} {'final cand':>11} {'final gap':>10}")
+    worst_final = 0.0
+    for name in POPULATION:
+        gaps = [abs(int(ref[name][i]) - int(cand[name][i])) for i in range(n)]
+        first_diff = next((i for i, g in enumerate(gaps) if g), None)
+        final_gap = gaps[n - 1] / agents
+        worst_final = max(worst_final, final_gap)
+        print(f"{name:<12} {max(gaps) / agents:>9.2%} {sum(gaps) / n / agents:>9.2%} "
+              f"{ref[name][n - 1]:>10} {cand[name][n - 1]:>11} {final_gap:>9.2%}"
+              + (f"  (first differs at tick {ref['tick'][first_diff]})" if first_diff is not None else ""))
+
+    print(f"{'event total':<27} {'ref':>10} {'cand':>10} {'diff':>8}")
+    for name in EVENTS:
+        r = sum(int(v) for v in ref[name][:n])
+        c = sum(int(v) for v in cand[name][:n])
+        diff = f"{(c - r) / r:+.1%}" if r else ("0" if c == 0 else "new")
+        print(f"{name:<27} {r:>10} {c:>10} {diff:>8}")
+
+    if args.tolerance is not None and worst_final > args.tolerance:
+        print(f"FAIL: final population gap {worst_final:.2%} exceeds {args.tolerance:.2%}")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Read a tactix telemetry file (.tlm) into columns.
+
+    python3 scripts/read_telemetry.py run.tlm                 # summary
+    python3 scripts/read_telemetry.py run.tlm --csv ticks.csv # per-tick table as CSV
+    python3 scripts/read_telemetry.py run.tlm --agents-csv agents.csv
+
+As a module, load() returns {"ticks": {...}, "agents": {...}}, where each table maps
+column name -> list (or numpy array when numpy is installed). With pandas:
+    pandas.DataFrame(load("run.tlm")["ticks"])
+"""
+import argparse
+import array
+import struct
+import sys
+
+TABLES = {0: "ticks", 1: "agents"}
+TYPES = {0: "B", 1: "I", 2: "Q", 3: "f"}  # TelemetryType -> array typecode
+NUMPY_TYPES = {0: "<u1", 1: "<u4", 2: "<u8", 3: "<f4"}
+
+
+def load(path, use_numpy=True):
+    try:
+        import numpy as np
+    except ImportError:
+        np = None
+    if not use_numpy:
+        np = None
+
+    with open(path, "rb") as f:
+        data = f.read()
+
+    magic, version, batch_ticks, sample_every = struct.unpack_from("<4sIII", data, 0)
+    if magic != b"TXTM":
+        raise ValueError(f"{path} is not a tactix telemetry file")
+    if version != 2:
+        raise ValueError(f"unsupported telemetry version {version}")
+
+    parts = {}  # table -> column -> list of chunks
+    offset = 16
+    while offset + 16 <= len(data):
+        bmagic, table, rows, columns = struct.unpack_from("<4sIII", data, offset)
+        if bmagic != b"BTCH":
+            raise ValueError(f"corrupt batch at byte {offset}")
+        offset += 16
+        table_parts = parts.setdefault(TABLES.get(table, f"table{table}"), {})
+        for _ in range(columns):
+            raw_name, ctype, nbytes = struct.unpack_from("<32sB7xQ", data, offset)
+            offset += 48
+            name = raw_name.split(b"\0", 1)[0].decode()
+            chunk = data[offset:offset + nbytes]
+            offset += nbytes
+            if np is not None:
+                values = np.frombuffer(chunk, dtype=NUMPY_TYPES[ctype])
+            else:
+                values = array.array(TYPES[ctype])
+                values.frombytes(chunk)
+                if sys.byteorder != "little":
+                    values.byteswap()
+            table_parts.setdefault(name, []).append(values)
+
+    tables = {}
+    for table, cols in parts.items():
+        if np is not None:
+            tables[table] = {name: np.concatenate(chunks) for name, chunks in cols.items()}
+        else:
+            tables[table] = {name: [v for chunk in chunks for v in chunk] for name, chunks in cols.items()}
+    tables.setdefault("ticks", {})
+    tables.setdefault("agents", {})
+    return tables
+
+
+def write_csv(table, path):
+    names = list(table.keys())
+    rows = len(table[names[0]]) if names else 0
+    with open(path, "w") as f:
+        f.write(",".join(names) + "\n")
+        for i in range(rows):
+            f.write(",".join(str(table[n][i]) for n in names) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("path")
+    parser.add_argument("--csv", help="write the per-tick table as CSV")
+    parser.add_argument("--agents-csv", help="write the sampled per-agent table as CSV")
+    args = parser.parse_args()
+
+    tables = load(args.path)
+    ticks = tables["ticks"]
+    if ticks:
+        n = len(ticks["tick"])
+        print(f"ticks: {n} rows ({ticks['tick'][0]}-{ticks['tick'][n - 1]}), {len(ticks)} columns")
+        last = n - 1
+        print(f"  final population: {ticks['civilians'][last]} civilians, "
+              f"{ticks['zombies'][last]} zombies, {ticks['heroes'][last]} heroes")
+        for name in ("civilians_bitten", "civilians_killed", "reanimations",
+                     "zombies_shot", "zombies_killed_by_civilians", "zombies_killed_by_heroes", "heroes_turned"):
+            print(f"  total {name}: {sum(int(v) for v in ticks[name])}")
+    agents = tables["agents"]
+    if agents:
+        print(f"agents: {len(agents['tick'])} sampled rows")
+
+    if args.csv:
+        write_csv(ticks, args.csv)
+    if args.agents_csv:
+        write_csv(agents, args.agents_csv)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+"""Drive a headless tactix simulation through libtactix (capi/tactix.h) with ctypes.
+
+    python3 scripts/tactix_capi.py --lib build/libtactix.so --agents 100000 --ticks 600
+
+As a module, Sim wraps one simulation: step(), spawn(), kill(), set_velocities(), and
+column(name) / columns(), which return zero-copy views of the simulation's columns
+(numpy arrays when numpy is installed, memoryviews otherwise). Views are valid until
+the next call that changes the simulation; fetch them again after stepping. With
+DuckDB, for example:
+    duckdb.sql("select type, count(*) from df group by type")  # df = pandas.DataFrame(sim.columns())
+"""
+import argparse
+import ctypes
+import sys
+
+API_VERSION = 1
+TYPES = {0: "B", 1: "I", 2: "f", 3: "h", 4: "H"}  # Column type -> memoryview format
+NUMPY_TYPES = {0: "<u1", 1: "<u4", 2: "<f4", 3: "<i2", 4: "<u2"}
+TYPE_NAMES = {0: "civilian", 1: "zombie", 2: "hero"}
+
+
+class Config(ctypes.Structure):
+    _fields_ = [
+        ("world_width", ctypes.c_float),
+        ("world_height", ctypes.c_float),
+        ("agents", ctypes.c_uint32),
+        ("civilians", ctypes.c_float),
+        ("zombies", ctypes.c_float),
+        ("seed", ctypes.c_uint64),
+        ("workers", ctypes.c_uint32),
+        ("hordes", ctypes.c_uint32),
+        ("occlusion", ctypes.c_uint32),
+        ("log_events", ctypes.c_uint32),
+    ]
+
+
+class ColumnInfo(ctypes.Structure):
+    _fields_ = [
+        ("name", ctypes.c_char_p),
+        ("data", ctypes.c_void_p),
+        ("length", ctypes.c_size_t),
+        ("type", ctypes.c_uint32),
+        ("element_size", ctypes.c_uint32),
+        ("fraction_bits", ctypes.c_uint32),
+    ]
+
+
+def load_library(path):
+    lib = ctypes.CDLL(path)
+    p = ctypes.c_void_p
+    u32_p = ctypes.POINTER(ctypes.c_uint32)
+    f32_p = ctypes.POINTER(ctypes.c_float)
+    signatures = {
+        "tactix_api_version": (ctypes.c_int, []),
+        "tactix_config_default": (None, [ctypes.POINTER(Config)]),
+        "tactix_create": (p, [ctypes.POINTER(Config)]),
+        "tactix_destroy": (None, [p]),
+        "tactix_step": (ctypes.c_int, [p, ctypes.c_uint32]),
+        "tactix_agent_count": (ctypes.c_size_t, [p]),
+        "tactix_tick_count": (ctypes.c_uint64, [p]),
+        "tactix_column_count": (ctypes.c_uint32, [p]),
+        "tactix_column": (ctypes.c_int, [p, ctypes.c_char_p, ctypes.POINTER(ColumnInfo)]),
+        "tactix_column_at": (ctypes.c_int, [p, ctypes.c_uint32, ctypes.POINTER(ColumnInfo)]),
+        "tactix_spawn": (ctypes.c_int, [p, ctypes.c_size_t, f32_p, f32_p, f32_p, f32_p,
+                                        ctypes.POINTER(ctypes.c_uint8)]),
+        "tactix_kill": (ctypes.c_int, [p, u32_p, ctypes.c_size_t]),
+        "tactix_set_velocities": (ctypes.c_int, [p, u32_p, ctypes.c_size_t, f32_p, f32_p]),
+    }
+    for name, (restype, argtypes) in signatures.items():
+        fn = getattr(lib, name)
+        fn.restype = restype
+        fn.argtypes = argtypes
+    if lib.tactix_api_version() != API_VERSION:
+        raise RuntimeError("libtactix API version %d, expected %d" % (lib.tactix_api_version(), API_VERSION))
+    return lib
+
+
+def _as_array(values, ctype):
+    """ctypes pointer to values' elements: numpy arrays are passed without copying"""
+    if values is None:
+        return None
+    if hasattr(values, "ctypes"):
+        return values.ctypes.data_as(ctypes.POINTER(ctype))
+    return (ctype * len(values))(*values)
+
+
+class Sim:
+    def __init__(self, lib, **config):
+        self.lib = lib
+        c = Config()
+        lib.tactix_config_default(ctypes.byref(c))
+        for key, value in config.items():
+            setattr(c, key, value)
+        self.handle = lib.tactix_create(ctypes.byref(c))
+        if not self.handle:
+            raise RuntimeError("tactix_create failed")
+        try:
+            import numpy
+            self.np = numpy
+        except ImportError:
+            self.np = None
+
+    def close(self):
+        if self.handle:
+            self.lib.tactix_destroy(self.handle)
+            self.handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def _check(self, result, what):
+        if result != 0:
+            raise RuntimeError("%s failed (%d)" % (what, result))
+
+    @property
+    def agent_count(self):
+        return self.lib.tactix_agent_count(self.handle)
+
+    @property
+    def tick_count(self):
+        return self.lib.tactix_tick_count(self.handle)
+
+    def step(self, ticks=1):
+        self._check(self.lib.tactix_step(self.handle, ticks), "tactix_step")
+
+    def _view(self, info):
+        if info.length == 0:
+            return self.np.empty(0, NUMPY_TYPES[info.type]) if self.np else memoryview(b"")
+        size = info.length * info.element_size
+        raw = (ctypes.c_char * size).from_address(info.data)
+        if self.np:
+            view = self.np.frombuffer(raw, dtype=NUMPY_TYPES[info.type])
+            view.flags.writeable = False  # The simulation owns the memory
+            return view
+        return memoryview(raw).cast("B").cast(TYPES[info.type]).toreadonly()
+
+    def column(self, name):
+        info = ColumnInfo()
+        self._check(self.lib.tactix_column(self.handle, name.encode(), ctypes.byref(info)), "tactix_column")
+        return self._view(info)
+
+    def columns(self):
+        result = {}
+        info = ColumnInfo()
+        for index in range(self.lib.tactix_column_count(self.handle)):
+            self._check(self.lib.tactix_column_at(self.handle, index, ctypes.byref(info)), "tactix_column_at")
+            result[info.name.decode()] = self._view(info)
+        return result
+
+    def spawn(self, pos_x, pos_y, types, vel_x=None, vel_y=None):
+        if self.np:
+            pos_x, pos_y = (self.np.ascontiguousarray(a, dtype="<f4") for a in (pos_x, pos_y))
+            types = self.np.ascontiguousarray(types, dtype="<u1")
+            if vel_x is not None:
+                vel_x, vel_y = (self.np.ascontiguousarray(a, dtype="<f4") for a in (vel_x, vel_y))
+        self._check(self.lib.tactix_spawn(self.handle, len(pos_x),
+                                          _as_array(pos_x, ctypes.c_float), _as_array(pos_y, ctypes.c_float),
+                                          _as_array(vel_x, ctypes.c_float), _as_array(vel_y, ctypes.c_float),
+                                          _as_array(types, ctypes.c_uint8)), "tactix_spawn")
+
+    def kill(self, rows):
+        if self.np:
+            rows = self.np.ascontiguousarray(rows, dtype="<u4")
+        self._check(self.lib.tactix_kill(self.handle, _as_array(rows, ctypes.c_uint32), len(rows)), "tactix_kill")
+
+    def set_velocities(self, rows, vel_x, vel_y):
+        if self.np:
+            rows = self.np.ascontiguousarray(rows, dtype="<u4")
+            vel_x, vel_y = (self.np.ascontiguousarray(a, dtype="<f4") for a in (vel_x, vel_y))
+        self._check(self.lib.tactix_set_velocities(self.handle, _as_array(rows, ctypes.c_uint32), len(rows),
+                                                   _as_array(vel_x, ctypes.c_float),
+                                                   _as_array(vel_y, ctypes.c_float)), "tactix_set_velocities")
+
+
+def type_counts(types):
+    counts = {name: 0 for name in TYPE_NAMES.values()}
+    for t in types:
+        counts[TYPE_NAMES[t]] += 1
+    return counts
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--lib", default="libtactix.so", help="path to libtactix")
+    parser.add_argument("--agents", type=int, default=10000)
+    parser.add_argument("--ticks", type=int, default=600)
+    parser.add_argument("--workers", type=int, default=0)
+    parser.add_argument("--seed", type=int, default=1337)
+    args = parser.parse_args()
+
+    lib = load_library(args.lib)
+    with Sim(lib, agents=args.agents, workers=args.workers, seed=args.seed) as sim:
+        # A squad of heroes dropped into the middle, then a cull of the first 10 rows
+        sim.spawn([640.0] * 8, [360.0 + 4 * i for i in range(8)], [2] * 8)
+        sim.kill(list(range(10)))
+        for second in range(max(1, args.ticks // 60)):
+            sim.step(60)
+            types = sim.column("type")
+            pos_x = sim.column("posX")
+            if sim.np:
+                counts = {name: int((types == t).sum()) for t, name in TYPE_NAMES.items()}
+                mean_x = float(pos_x.mean()) if len(pos_x) else 0.0
+            else:
+                counts = type_counts(types)
+                mean_x = sum(pos_x) / len(pos_x) if len(pos_x) else 0.0
+            print("tick %5d: %6d agents %s mean x %.1f" % (sim.tick_count, sim.agent_count, counts, mean_x))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,48 @@
+#include "AllocationCounter.hpp"
+
+#ifdef TACTIX_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+thread_local bool tracked = false;
+
+void* countedMalloc(std::size_t size) noexcept {
+    if (tracked) allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+}  // namespace
+
+// Replacements for the global allocation functions (aligned variants keep the defaults)
+void* operator new(std::size_t size) {
+    if (void* p = countedMalloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* p = countedMalloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedMalloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedMalloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+bool AllocationCounter::isEnabled() { return true; }
+void AllocationCounter::trackCurrentThread() { tracked = true; }
+uint64_t AllocationCounter::getCount() { return allocations.load(std::memory_order_relaxed); }
+
+#else
+
+bool AllocationCounter::isEnabled() { return false; }
+void AllocationCounter::trackCurrentThread() {}
+uint64_t AllocationCounter::getCount() { return 0; }
+
+#endif
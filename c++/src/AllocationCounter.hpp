@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+
+// Counts calls to the global operator new, to check that steady-state ticks don't
+// allocate (Design Doc §6).
+//
+// Compiled in when TACTIX_COUNT_ALLOCATIONS is defined (Debug builds, or the
+// TACTIX_COUNT_ALLOCATIONS CMake option). Only threads that opted in through
+// trackCurrentThread() are counted - the simulation thread and job workers - so the
+// event log and telemetry threads don't show up in per-tick numbers. Otherwise
+// everything here is a no-op and getCount() stays 0.
+namespace AllocationCounter {
+
+bool isEnabled();
+void trackCurrentThread();
+uint64_t getCount();
+
+}  // namespace AllocationCounter
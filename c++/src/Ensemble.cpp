@@ -0,0 +1,164 @@
+#include "Ensemble.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Population {
+    uint32_t humans = 0;   // Living civilians and heroes (bitten included)
+    uint32_t zombies = 0;
+    uint32_t pending = 0;  // Bitten or corpses: future zombies
+};
+
+Population countPopulation(const EntityHot& entities) {
+    Population pop;
+    for (size_t i = 0; i < entities.count; i++) {
+        AgentState state = entities.state[i];
+        if (entities.type[i] == AgentType::Zombie) {
+            pop.zombies++;
+        } else if (state != AgentState::Dead) {
+            pop.humans++;
+        }
+        if (state == AgentState::Dead || state == AgentState::Bitten) pop.pending++;
+    }
+    return pop;
+}
+
+EnsembleStat statOf(std::vector<double> values) {
+    EnsembleStat stat;
+    if (values.empty()) return stat;
+    std::sort(values.begin(), values.end());
+    auto at = [&values](double p) {
+        size_t rank = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+        return values[std::min(rank, values.size() - 1)];
+    };
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    stat.samples = static_cast<uint32_t>(values.size());
+    stat.mean = sum / values.size();
+    double var = 0.0;
+    for (double v : values) var += (v - stat.mean) * (v - stat.mean);
+    stat.stddev = values.size() > 1 ? std::sqrt(var / (values.size() - 1)) : 0.0;
+    stat.min = values.front();
+    stat.p50 = at(0.5);
+    stat.p90 = at(0.9);
+    stat.max = values.back();
+    return stat;
+}
+}
+
+struct EnsembleRunner::Context {
+    EnsembleConfig config;
+    std::vector<RunOutcome> outcomes;
+    std::vector<std::unique_ptr<Simulation>> sims;  // Alive while the run is in flight
+    std::vector<Clock::time_point> started;
+    std::atomic<uint32_t> nextRun{0};
+    JobSystem::Group group;
+};
+
+std::vector<RunOutcome> EnsembleRunner::run(const EnsembleConfig& config) {
+    Context ctx;
+    ctx.config = config;
+    ctx.config.ticksPerJob = std::max(1u, config.ticksPerJob);
+    ctx.outcomes.resize(config.runs);
+    ctx.sims.resize(config.runs);
+    ctx.started.resize(config.runs);
+    
+    uint32_t inFlight = config.maxInFlight > 0 ? config.maxInFlight : jobs.getWorkerCount() * 2;
+    inFlight = std::min(inFlight, config.runs);
+    for (uint32_t s = 0; s < inFlight; s++) {
+        uint32_t first = ctx.nextRun++;
+        jobs.submit([this, &ctx, first]() { startRun(ctx, first); }, ctx.group);
+    }
+    
+    // Every job queues its successor before it finishes, so the group only drains
+    // once the last run is done
+    jobs.wait(ctx.group);
+    return std::move(ctx.outcomes);
+}
+
+void EnsembleRunner::startRun(Context& ctx, uint32_t run) {
+    ctx.started[run] = Clock::now();
+    auto sim = std::make_unique<Simulation>(ctx.config.world, jobs);
+    sim->getEventLog().setEnabled(false);  // Outcomes come from counters, not log lines
+    sim->setSeed(ctx.config.firstSeed + run);
+    sim->init(ctx.config.agents, ctx.config.mix);
+    sim->setPaused(false);
+    ctx.outcomes[run].seed = sim->getSeed();
+    ctx.sims[run] = std::move(sim);
+    runSlice(ctx, run);
+}
+
+void EnsembleRunner::runSlice(Context& ctx, uint32_t run) {
+    Simulation& sim = *ctx.sims[run];
+    RunOutcome& outcome = ctx.outcomes[run];
+    const float dt = 1.0f / 60.0f;
+    
+    bool done = false;
+    for (uint32_t t = 0; t < ctx.config.ticksPerJob && !done; t++) {
+        sim.tick(dt);
+        outcome.ticks++;
+        int64_t tick = static_cast<int64_t>(sim.getTickCount());
+        
+        if (outcome.heroExhaustionTick < 0 && sim.getLastTickEvents().heroesTurned > 0) {
+            outcome.heroExhaustionTick = tick;
+        }
+        Population pop = countPopulation(sim.getEntities());
+        if (pop.humans == 0) {
+            outcome.takeoverTick = tick;
+            done = true;
+        } else if (pop.zombies == 0 && pop.pending == 0) {
+            outcome.containedTick = tick;  // Nothing left that can turn anyone
+            done = true;
+        }
+        done = done || outcome.ticks >= ctx.config.maxTicks;
+    }
+    
+    if (!done) {
+        jobs.submit([this, &ctx, run]() { runSlice(ctx, run); }, ctx.group);
+        return;
+    }
+    finishRun(ctx, run);
+}
+
+void EnsembleRunner::finishRun(Context& ctx, uint32_t run) {
+    RunOutcome& outcome = ctx.outcomes[run];
+    Population pop = countPopulation(ctx.sims[run]->getEntities());
+    outcome.survivors = pop.humans;
+    outcome.zombies = pop.zombies;
+    outcome.wallMs = std::chrono::duration<float>(Clock::now() - ctx.started[run]).count() * 1000.0f;
+    ctx.sims[run].reset();
+    if (onRunFinished) onRunFinished(outcome);
+    
+    // Reuse this job for the next seed
+    uint32_t next = ctx.nextRun++;
+    if (next < ctx.config.runs) {
+        startRun(ctx, next);
+    }
+}
+
+EnsembleSummary EnsembleRunner::summarize(const std::vector<RunOutcome>& outcomes) {
+    EnsembleSummary summary;
+    summary.runs = static_cast<uint32_t>(outcomes.size());
+    std::vector<double> takeover, contained, exhaustion, survivors;
+    for (const RunOutcome& o : outcomes) {
+        if (o.takeoverTick >= 0) takeover.push_back(static_cast<double>(o.takeoverTick));
+        if (o.containedTick >= 0) contained.push_back(static_cast<double>(o.containedTick));
+        if (o.heroExhaustionTick >= 0) exhaustion.push_back(static_cast<double>(o.heroExhaustionTick));
+        survivors.push_back(o.survivors);
+    }
+    if (summary.runs > 0) {
+        summary.takeoverRate = static_cast<double>(takeover.size()) / summary.runs;
+        summary.containedRate = static_cast<double>(contained.size()) / summary.runs;
+        summary.heroExhaustionRate = static_cast<double>(exhaustion.size()) / summary.runs;
+    }
+    summary.takeoverTick = statOf(std::move(takeover));
+    summary.containedTick = statOf(std::move(contained));
+    summary.heroExhaustionTick = statOf(std::move(exhaustion));
+    summary.survivors = statOf(std::move(survivors));
+    return summary;
+}
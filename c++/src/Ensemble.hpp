@@ -0,0 +1,81 @@
+#pragma once
+#include "Simulation.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// One scenario run many times with consecutive seeds, for Monte Carlo statistics
+struct EnsembleConfig {
+    WorldConfig world;
+    PopulationMix mix;
+    size_t agents = 10000;
+    uint64_t firstSeed = 1;     // Run r uses seed firstSeed + r
+    uint32_t runs = 64;
+    uint32_t maxTicks = 36000;  // Per run (10 simulated minutes)
+    uint32_t ticksPerJob = 60;  // Ticks a run advances per pool job
+    uint32_t maxInFlight = 0;   // Simulations alive at once, 0 = two per pool worker
+};
+
+// How one run ended. Ticks are -1 when the event never happened.
+struct RunOutcome {
+    uint64_t seed = 0;
+    uint32_t ticks = 0;               // Ticks simulated before the run stopped
+    int64_t takeoverTick = -1;        // No living civilians or heroes left
+    int64_t containedTick = -1;       // No zombies, bitten or corpses left
+    int64_t heroExhaustionTick = -1;  // First hero turned from exhaustion
+    uint32_t survivors = 0;           // Living civilians + heroes at the end
+    uint32_t zombies = 0;
+    float wallMs = 0.0f;
+};
+
+// Distribution of one metric over the runs where it was defined
+struct EnsembleStat {
+    uint32_t samples = 0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double min = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double max = 0.0;
+};
+
+struct EnsembleSummary {
+    uint32_t runs = 0;
+    double takeoverRate = 0.0;  // Share of runs ending in takeover
+    double containedRate = 0.0;
+    double heroExhaustionRate = 0.0;
+    EnsembleStat takeoverTick;
+    EnsembleStat containedTick;
+    EnsembleStat heroExhaustionTick;
+    EnsembleStat survivors;
+};
+
+// Steps many independent simulations on one shared JobSystem.
+//
+// Each in-flight run is a chain of pool jobs: a job advances its simulation by
+// ticksPerJob ticks (the simulation's own chunk jobs go to the same pool, and the
+// worker helps run them at each barrier) and then queues the next slice, so whole-run
+// slices and intra-tick chunks are interleaved on the same workers. A finished run
+// frees its simulation and the same job starts the next seed. Outcomes only depend
+// on the seed, not on the pool size or scheduling.
+class EnsembleRunner {
+public:
+    explicit EnsembleRunner(JobSystem& jobs) : jobs(jobs) {}
+    
+    // Runs every seed and returns outcomes in seed order. Call from outside the pool.
+    std::vector<RunOutcome> run(const EnsembleConfig& config);
+    
+    // Called from pool workers as each run finishes (must be thread safe)
+    std::function<void(const RunOutcome&)> onRunFinished;
+    
+    static EnsembleSummary summarize(const std::vector<RunOutcome>& outcomes);
+
+private:
+    struct Context;
+    
+    JobSystem& jobs;
+    
+    void startRun(Context& ctx, uint32_t run);
+    void runSlice(Context& ctx, uint32_t run);
+    void finishRun(Context& ctx, uint32_t run);
+};
@@ -0,0 +1,128 @@
+#include "EventLog.hpp"
+#include "spdlog/spdlog.h"
+#include <chrono>
+
+EventLog::EventLog(const EventLogConfig& cfg) : config(cfg) {
+    size_t capacity = 1;
+    while (capacity < cfg.capacity) capacity <<= 1;
+    mask = capacity - 1;
+}
+
+EventLog::~EventLog() {
+    running = false;
+    if (formatter.joinable()) {
+        formatter.join();
+    }
+}
+
+void EventLog::start() {
+    ring.resize(mask + 1);
+    formatter = std::thread(&EventLog::formatLoop, this);
+}
+
+void EventLog::flush() {
+    while (tail.load(std::memory_order_acquire) != head.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void EventLog::formatLoop() {
+    // Polls rather than waking on every emit, so the producer never makes a syscall
+    while (true) {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t h = head.load(std::memory_order_acquire);
+        if (t == h) {
+            if (!running.load(std::memory_order_acquire)) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            continue;
+        }
+        for (; t != h; t++) {
+            format(ring[t & mask]);
+            tail.store(t + 1, std::memory_order_release);
+        }
+    }
+}
+
+void EventLog::format(const Record& r) {
+    switch (r.kind) {
+        case EventKind::CombatStarted:
+            spdlog::info("[{}] Combat initiated: {} vs {} ({:.1f}s)", r.tick, r.a, r.b, r.value);
+            break;
+        case EventKind::ZombieFed:
+            spdlog::info("[{}] Zombie {} fed on corpse {}, health now {}", r.tick, r.a, r.b, static_cast<int>(r.value));
+            break;
+        case EventKind::InfectionDeath:
+            spdlog::info("[{}] Civilian {} died from infection! Will reanimate in {:.1f}s", r.tick, r.a, r.value);
+            break;
+        case EventKind::Reanimated:
+            spdlog::info("[{}] Corpse {} reanimated as zombie!", r.tick, r.a);
+            break;
+        case EventKind::CivilianKilledZombie:
+            spdlog::info("[{}] Civilian {} killed zombie {}!", r.tick, r.a, r.b);
+            break;
+        case EventKind::CivilianPyrrhicKill:
+            spdlog::info("[{}] Civilian {} killed zombie {} but was bitten!", r.tick, r.a, r.b);
+            break;
+        case EventKind::CivilianBitten:
+            spdlog::info("[{}] Civilian {} escaped but was bitten!", r.tick, r.a);
+            break;
+        case EventKind::CivilianKilled:
+            spdlog::info("[{}] Civilian {} was killed by zombie {}!", r.tick, r.a, r.b);
+            break;
+        case EventKind::HeroKilledZombie:
+            spdlog::info("[{}] Hero {} killed zombie {}!", r.tick, r.a, r.b);
+            break;
+        case EventKind::HeroTraded:
+            spdlog::info("[{}] Hero {} vs Zombie {} - both damaged!", r.tick, r.a, r.b);
+            break;
+        case EventKind::HeroExhausted:
+            spdlog::info("[{}] Hero {} exhausted and turned zombie!", r.tick, r.a);
+            break;
+        default:
+            break;
+    }
+}
+
+void EventLog::logSummary() const {
+    spdlog::info("Event totals (exact):");
+    for (size_t k = 0; k < static_cast<size_t>(EventKind::Count); k++) {
+        spdlog::info("  {:<22} {}", nameOf(static_cast<EventKind>(k)), totals[k].load(std::memory_order_relaxed));
+    }
+    spdlog::info("  not logged: {} sampled out, {} rate limited, {} dropped (ring full)",
+                 getSampledOut(), getRateLimited(), getDropped());
+}
+
+EventCategory EventLog::categoryOf(EventKind kind) {
+    switch (kind) {
+        case EventKind::CombatStarted:
+        case EventKind::HeroTraded:
+            return EventCategory::Combat;
+        case EventKind::ZombieFed:
+            return EventCategory::Feeding;
+        case EventKind::InfectionDeath:
+        case EventKind::Reanimated:
+        case EventKind::CivilianBitten:
+            return EventCategory::Infection;
+        case EventKind::HeroExhausted:
+            return EventCategory::Hero;
+        default:
+            return EventCategory::Kill;
+    }
+}
+
+const char* EventLog::nameOf(EventKind kind) {
+    switch (kind) {
+        case EventKind::CombatStarted: return "combat_started";
+        case EventKind::ZombieFed: return "zombie_fed";
+        case EventKind::InfectionDeath: return "infection_death";
+        case EventKind::Reanimated: return "reanimated";
+        case EventKind::CivilianKilledZombie: return "civilian_killed_zombie";
+        case EventKind::CivilianPyrrhicKill: return "civilian_pyrrhic_kill";
+        case EventKind::CivilianBitten: return "civilian_bitten";
+        case EventKind::CivilianKilled: return "civilian_killed";
+        case EventKind::HeroKilledZombie: return "hero_killed_zombie";
+        case EventKind::HeroTraded: return "hero_traded";
+        case EventKind::HeroExhausted: return "hero_exhausted";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Simulation events worth a log line
+enum class EventKind : uint8_t {
+    CombatStarted = 0,      // a = zombie, b = target, value = duration (s)
+    ZombieFed,              // a = zombie, b = corpse, value = new health
+    InfectionDeath,         // a = civilian, value = reanimation delay (s)
+    Reanimated,             // a = corpse
+    CivilianKilledZombie,   // a = civilian, b = zombie
+    CivilianPyrrhicKill,    // a = civilian, b = zombie (killed it but was bitten)
+    CivilianBitten,         // a = civilian (escaped bitten)
+    CivilianKilled,         // a = civilian, b = zombie
+    HeroKilledZombie,       // a = hero, b = zombie
+    HeroTraded,             // a = hero, b = zombie (both damaged)
+    HeroExhausted,          // a = hero
+    Count
+};
+
+// Sampling and rate limits are applied per category
+enum class EventCategory : uint8_t { Combat = 0, Feeding, Infection, Kill, Hero, Count };
+
+struct EventCategoryLimit {
+    uint32_t sampleEvery = 1;   // Keep 1 in N events (1 = all)
+    uint32_t maxPerSecond = 0;  // Per simulated second (60 ticks), 0 = unlimited
+};
+
+struct EventLogConfig {
+    bool enabled = true;        // Off = count only, nothing is queued or formatted
+    uint32_t capacity = 65536;  // Ring slots (rounded up to a power of two)
+    std::array<EventCategoryLimit, static_cast<size_t>(EventCategory::Count)> limits = {{
+        {1, 30},  // Combat
+        {1, 30},  // Feeding
+        {1, 30},  // Infection
+        {1, 30},  // Kill
+        {1, 0},   // Hero - rare and always interesting
+    }};
+};
+
+// Structured, asynchronous event log.
+//
+// emit() runs on the simulation thread: it bumps exact per-kind counters, applies
+// the category's sampling and rate limit, and copies a 24-byte record into a
+// single-producer ring. A background thread formats records through spdlog, so log
+// volume no longer shows up in tick time. A full ring drops records (counted)
+// instead of waiting. The ring and the thread only exist once the first record is
+// queued: a disabled log (ensemble runs, libtactix) never starts a thread.
+class EventLog {
+public:
+    explicit EventLog(const EventLogConfig& config = EventLogConfig{});
+    ~EventLog();
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    void emit(EventKind kind, uint64_t tick, uint32_t a, uint32_t b = 0, float value = 0.0f) {
+        size_t k = static_cast<size_t>(kind);
+        totals[k].store(totals[k].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (!config.enabled) return;
+
+        size_t c = static_cast<size_t>(categoryOf(kind));
+        CategoryState& cat = categories[c];
+        const EventCategoryLimit& limit = config.limits[c];
+        if (limit.sampleEvery > 1 && (cat.seen++ % limit.sampleEvery) != 0) {
+            bump(sampledOut);
+            return;
+        }
+        uint64_t window = tick / 60;
+        if (window != cat.window) {
+            cat.window = window;
+            cat.inWindow = 0;
+        }
+        if (limit.maxPerSecond > 0 && cat.inWindow >= limit.maxPerSecond) {
+            bump(rateLimited);
+            return;
+        }
+        cat.inWindow++;
+
+        if (!formatter.joinable()) start();
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= ring.size()) {
+            bump(dropped);
+            return;
+        }
+        ring[h & mask] = {tick, a, b, value, kind};
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    void setEnabled(bool on) { config.enabled = on; }
+    bool isEnabled() const { return config.enabled; }
+    void setLimit(EventCategory category, EventCategoryLimit limit) {
+        config.limits[static_cast<size_t>(category)] = limit;
+    }
+
+    // Exact totals, regardless of sampling, rate limits or drops
+    uint64_t getTotal(EventKind kind) const { return totals[static_cast<size_t>(kind)].load(std::memory_order_relaxed); }
+    uint64_t getSampledOut() const { return sampledOut.load(std::memory_order_relaxed); }
+    uint64_t getRateLimited() const { return rateLimited.load(std::memory_order_relaxed); }
+    uint64_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    void flush();         // Wait until the formatter has caught up
+    void logSummary() const;  // One line per kind with exact totals
+
+    static EventCategory categoryOf(EventKind kind);
+    static const char* nameOf(EventKind kind);
+
+private:
+    struct Record {
+        uint64_t tick;
+        uint32_t a;
+        uint32_t b;
+        float value;
+        EventKind kind;
+    };
+
+    struct CategoryState {
+        uint64_t seen = 0;
+        uint64_t window = UINT64_MAX;
+        uint32_t inWindow = 0;
+    };
+
+    EventLogConfig config;
+    std::vector<Record> ring;
+    size_t mask = 0;
+    alignas(64) std::atomic<uint64_t> head{0};  // Written by the simulation thread
+    alignas(64) std::atomic<uint64_t> tail{0};  // Written by the formatter thread
+
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(EventKind::Count)> totals{};
+    std::array<CategoryState, static_cast<size_t>(EventCategory::Count)> categories{};
+    std::atomic<uint64_t> sampledOut{0};
+    std::atomic<uint64_t> rateLimited{0};
+    std::atomic<uint64_t> dropped{0};
+
+    std::atomic<bool> running{true};
+    std::thread formatter;
+
+    static void bump(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    void start();  // Allocates the ring and starts the formatter
+    void formatLoop();
+    static void format(const Record& r);
+};
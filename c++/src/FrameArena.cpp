@@ -0,0 +1,60 @@
+#include "FrameArena.hpp"
+#include <algorithm>
+
+FrameArena::FrameArena(size_t initialBytes) {
+    blocks.push_back({std::make_unique<std::byte[]>(initialBytes), initialBytes});
+}
+
+void* FrameArena::allocate(size_t bytes, size_t align) {
+    while (true) {
+        Block& block = blocks[current];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        uintptr_t at = (base + offset + align - 1) & ~static_cast<uintptr_t>(align - 1);
+        if (at + bytes <= base + block.size) {
+            offset = (at + bytes) - base;
+            highWater = std::max(highWater, usedBytes());
+            return reinterpret_cast<void*>(at);
+        }
+
+        // Spill into the next block; drop any later block too small to help
+        current++;
+        offset = 0;
+        if (current < blocks.size() && blocks[current].size < bytes + align) {
+            blocks.resize(current);
+        }
+        if (current == blocks.size()) {
+            size_t size = std::max(bytes + align, blocks.back().size * 2);
+            blocks.push_back({std::make_unique<std::byte[]>(size), size});
+        }
+    }
+}
+
+void FrameArena::release(void* p, size_t bytes) {
+    std::byte* top = blocks[current].data.get() + offset;
+    if (static_cast<std::byte*>(p) + bytes == top) {
+        offset -= bytes;
+    }
+}
+
+void FrameArena::reset() {
+    if (blocks.size() > 1) {
+        // Settle on one block that holds everything this tick needed
+        size_t size = getCapacity();
+        blocks.clear();
+        blocks.push_back({std::make_unique<std::byte[]>(size), size});
+    }
+    current = 0;
+    offset = 0;
+}
+
+size_t FrameArena::getCapacity() const {
+    size_t total = 0;
+    for (const auto& block : blocks) total += block.size;
+    return total;
+}
+
+size_t FrameArena::usedBytes() const {
+    size_t used = offset;
+    for (size_t b = 0; b < current; b++) used += blocks[b].size;
+    return used;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Linear allocator for per-tick temporaries (Design Doc §6)
+//
+// Each job worker (and the simulation thread) owns one. allocate() bumps a pointer
+// inside the current block and nothing is freed individually; the simulation resets
+// every arena at the end of the tick. If a tick spilled into extra blocks, reset()
+// swaps the chain for a single block big enough for it, so after a few ticks the
+// arena settles and a tick makes no calls to the global allocator.
+class FrameArena {
+public:
+    explicit FrameArena(size_t initialBytes = 64 * 1024);
+    FrameArena(FrameArena&&) noexcept = default;
+    FrameArena& operator=(FrameArena&&) noexcept = default;
+
+    void* allocate(size_t bytes, size_t align);
+    // Hands back the most recent allocation so a growing vector can reuse the top
+    void release(void* p, size_t bytes);
+
+    // Scoped rewinding: everything allocated after mark() is dropped by rewind()
+    struct Marker {
+        size_t block;
+        size_t offset;
+    };
+    Marker mark() const { return {current, offset}; }
+    void rewind(Marker m) { current = m.block; offset = m.offset; }
+
+    void reset();
+
+    size_t getCapacity() const;
+    size_t getHighWater() const { return highWater; }  // Most bytes used in one tick
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+
+    std::vector<Block> blocks;
+    size_t current = 0;  // Block being bumped
+    size_t offset = 0;   // Next free byte in blocks[current]
+    size_t highWater = 0;
+
+    size_t usedBytes() const;
+};
+
+// Rewinds an arena when it goes out of scope (e.g. per job chunk)
+class ArenaScope {
+public:
+    explicit ArenaScope(FrameArena& arena) : arena(arena), marker(arena.mark()) {}
+    ~ArenaScope() { arena.rewind(marker); }
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    FrameArena& arena;
+    FrameArena::Marker marker;
+};
+
+// std allocator adapter so standard containers can live in a FrameArena
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    FrameArena* arena;
+
+    explicit ArenaAllocator(FrameArena& a) : arena(&a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* p, size_t n) { arena->release(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+template <typename T>
+ArenaVector<T> makeArenaVector(FrameArena& arena, size_t reserve = 0) {
+    ArenaVector<T> v{ArenaAllocator<T>(arena)};
+    v.reserve(reserve);
+    return v;
+}
@@ -1,21 +1,107 @@
 #include "JobSystem.hpp"
+#include "AllocationCounter.hpp"
 #include "spdlog/spdlog.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
 
-JobSystem::JobSystem() {
-    // Use hardware concurrency, leave 1 core for main thread and rendering
-    workerCount = std::max(1u, std::thread::hardware_concurrency() - 1);
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+thread_local const JobSystem* currentSystem = nullptr;
+thread_local uint32_t currentIndex = 0;
+
+#if defined(__linux__)
+// CPU ids in this process's affinity mask, ascending
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+// CPUs worth of cgroup quota (rounded up), 0 if unlimited or unknown
+uint32_t cgroupCpuQuota() {
+    double quota = -1.0;
+    double period = 0.0;
+    // cgroup v2: "max 100000" or "<quota> <period>"
+    std::ifstream v2("/sys/fs/cgroup/cpu.max");
+    std::string max;
+    if (v2 >> max >> period) {
+        if (max != "max") quota = std::stod(max);
+    } else {
+        // cgroup v1: quota is -1 when unlimited
+        std::ifstream v1Quota("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+        std::ifstream v1Period("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+        if (!(v1Quota >> quota) || !(v1Period >> period)) return 0;
+    }
+    if (quota <= 0.0 || period <= 0.0) return 0;
+    return std::max(1u, static_cast<uint32_t>(std::ceil(quota / period)));
+}
+#endif
+}
+
+uint32_t JobSystem::availableCpus() {
+    uint32_t cpus = std::thread::hardware_concurrency();
+#if defined(__linux__)
+    const size_t allowed = allowedCpus().size();
+    if (allowed > 0) cpus = static_cast<uint32_t>(allowed);
+    const uint32_t quota = cgroupCpuQuota();
+    if (quota > 0) cpus = std::min(cpus, quota);
+#endif
+    return std::max(1u, cpus);
+}
+
+JobSystem::JobSystem(uint32_t requestedWorkers, bool pinWorkers) {
+    // Use the CPUs we may run on, leave 1 core for main thread and rendering
+    const uint32_t cpus = availableCpus();
+    workerCount = requestedWorkers > 0
+        ? requestedWorkers
+        : std::max(1u, cpus - 1);
+    workerQueues.resize(workerCount);
+    // Queues keep their capacity, so a tick only allocates here when it queues more
+    // jobs than any before it (1024 = 200k agents in 256-agent chunks, with room)
+    sharedQueue.entries.reserve(kReservedJobs);
+    for (auto& queue : workerQueues) queue.entries.reserve(kReservedJobs);
     
-    spdlog::info("JobSystem: Starting {} worker threads", workerCount);
+    // Worker i on the i-th allowed CPU, wrapping if there are more workers than CPUs
+    std::vector<int> cpuOf(workerCount, -1);
+#if defined(__linux__)
+    if (pinWorkers) {
+        std::vector<int> allowed = allowedCpus();
+        for (uint32_t i = 0; i < workerCount && !allowed.empty(); ++i) {
+            cpuOf[i] = allowed[i % allowed.size()];
+        }
+        pinned = !allowed.empty();
+    }
+#else
+    if (pinWorkers) spdlog::warn("JobSystem: Pinning workers is not supported on this platform");
+#endif
+
+    spdlog::info("JobSystem: Starting {} worker threads ({} CPUs available{})", workerCount, cpus,
+                 pinned ? ", pinned" : "");
     
     // Spawn worker threads
     for (uint32_t i = 0; i < workerCount; ++i) {
-        workers.emplace_back(&JobSystem::workerLoop, this);
+        workers.emplace_back(&JobSystem::workerLoop, this, i, cpuOf[i]);
     }
 }
 
 JobSystem::~JobSystem() {
     // Signal workers to stop
-    running = false;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        running = false;
+    }
     queueCV.notify_all();
     
     // Wait for all workers to finish
@@ -29,50 +115,199 @@ JobSystem::~JobSystem() {
 }
 
 void JobSystem::submit(Job job) {
+    submit(std::move(job), defaultGroup);
+}
+
+void JobSystem::submit(Job job, Group& group) {
     {
         std::lock_guard<std::mutex> lock(queueMutex);
-        jobQueue.push(std::move(job));
-        activeJobs++;
+        sharedQueue.entries.push_back({std::move(job), &group});
+        queuedJobs++;
+        group.pending++;
     }
     queueCV.notify_one();
 }
 
+void JobSystem::submit(Job job, Group& group, uint32_t worker) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        workerQueues[worker % workerCount].entries.push_back({std::move(job), &group});
+        queuedJobs++;
+        group.pending++;
+    }
+    // Any sleeper may be the owner; the others go back to sleep or steal
+    queueCV.notify_all();
+}
+
+void JobSystem::submit(std::vector<BatchJob>& jobs, Group& group) {
+    if (jobs.empty()) return;
+    const bool single = jobs.size() == 1 && jobs[0].worker == kSharedQueue;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        for (BatchJob& b : jobs) {
+            Queue& queue = b.worker == kSharedQueue ? sharedQueue : workerQueues[b.worker % workerCount];
+            queue.entries.push_back({std::move(b.job), &group});
+        }
+        queuedJobs += static_cast<uint32_t>(jobs.size());
+        group.pending += static_cast<uint32_t>(jobs.size());
+    }
+    jobs.clear();
+    if (single) {
+        queueCV.notify_one();
+    } else {
+        queueCV.notify_all();
+    }
+}
+
 void JobSystem::waitAll() {
+    wait(defaultGroup);
+}
+
+void JobSystem::wait(Group& group) {
+    if (currentSystem == this) {
+        // Pool worker: run our own queued jobs; the rest are running elsewhere
+        while (group.pending.load() != 0 && runQueuedJob(group)) {
+        }
+    }
     std::unique_lock<std::mutex> lock(waitMutex);
-    waitCV.wait(lock, [this]() { 
-        return activeJobs.load() == 0 && jobQueue.empty(); 
+    waitCV.wait(lock, [&group]() {
+        return group.pending.load() == 0;  // Counts queued and running jobs
     });
 }
 
-void JobSystem::workerLoop() {
-    while (running) {
-        Job job;
+uint32_t JobSystem::getCurrentWorkerIndex() const {
+    return currentSystem == this ? currentIndex : workerCount;
+}
+
+bool JobSystem::runQueuedJob(Group& group) {
+    Job job;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        // This worker's queue first, then the shared one, then everyone else's
+        auto takeFrom = [&](Queue& queue) {
+            for (size_t i = queue.head; i < queue.entries.size(); i++) {
+                Entry& entry = queue.entries[i];
+                if (entry.group == &group && entry.job) {
+                    job = std::move(entry.job);
+                    entry.job = nullptr;
+                    skipTakenJobs(queue);
+                    queuedJobs--;
+                    return true;
+                }
+            }
+            return false;
+        };
+        bool found = takeFrom(workerQueues[currentIndex]) || takeFrom(sharedQueue);
+        for (uint32_t w = 0; w < workerCount && !found; w++) {
+            found = w != currentIndex && takeFrom(workerQueues[w]);
+        }
+        if (!found) return false;
+    }
+    job();
+    finishJob(group);
+    return true;
+}
+
+JobSystem::Entry JobSystem::takeFront(Queue& queue) {
+    Entry entry = std::move(queue.entries[queue.head++]);
+    queue.entries[queue.head - 1].job = nullptr;
+    skipTakenJobs(queue);
+    return entry;
+}
+
+JobSystem::Entry JobSystem::takeJob(uint32_t index) {
+    Queue& own = workerQueues[index];
+    if (own.hasJobs()) {
+        own.started = true;
+        return takeFront(own);
+    }
+    if (sharedQueue.hasJobs()) return takeFront(sharedQueue);
+    
+    // Steal the newest job of the next busy worker: its owner gets to the oldest first.
+    // Queues their owner hasn't started on are left alone; it is about to.
+    for (uint32_t n = 1; n < workerCount; n++) {
+        Queue& victim = workerQueues[(index + n) % workerCount];
+        if (!victim.started) continue;
+        while (victim.hasJobs() && !victim.entries.back().job) {
+            victim.entries.pop_back();  // Taken by a helping wait(); the head never is
+        }
+        if (!victim.hasJobs()) continue;
+        Entry entry = std::move(victim.entries.back());
+        victim.entries.pop_back();
+        skipTakenJobs(victim);
+        jobsStolen++;
+        return entry;
+    }
+    return {};
+}
+
+bool JobSystem::canTakeJob(uint32_t index) const {
+    if (workerQueues[index].hasJobs() || sharedQueue.hasJobs()) return true;
+    for (const Queue& queue : workerQueues) {
+        if (queue.started && queue.hasJobs()) return true;
+    }
+    return false;
+}
+
+void JobSystem::skipTakenJobs(Queue& queue) {
+    while (queue.head < queue.entries.size() && !queue.entries[queue.head].job) {
+        queue.head++;
+    }
+    if (queue.head == queue.entries.size()) {
+        queue.entries.clear();  // Keeps capacity
+        queue.head = 0;
+        queue.started = false;
+    }
+}
+
+void JobSystem::finishJob(Group& group) {
+    jobsExecuted++;
+    group.executed++;
+    
+    // Decrement the group's count and notify waiters if done
+    if (--group.pending == 0) {
+        std::lock_guard<std::mutex> lock(waitMutex);
+        waitCV.notify_all();
+    }
+}
+
+void JobSystem::workerLoop(uint32_t index, int cpu) {
+    currentSystem = this;
+    currentIndex = index;
+    AllocationCounter::trackCurrentThread();
+#if defined(__linux__)
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            spdlog::warn("JobSystem: Could not pin worker {} to CPU {}", index, cpu);
+        }
+    }
+#else
+    (void)cpu;
+#endif
+
+    while (true) {
+        Entry entry;
         
         {
             std::unique_lock<std::mutex> lock(queueMutex);
-            queueCV.wait(lock, [this]() { 
-                return !jobQueue.empty() || !running; 
+            queueCV.wait(lock, [this, index]() {
+                return canTakeJob(index) || !running;
             });
             
-            if (!running && jobQueue.empty()) {
+            if (!running && queuedJobs == 0) {
                 break;
             }
             
-            if (!jobQueue.empty()) {
-                job = std::move(jobQueue.front());
-                jobQueue.pop();
-            }
+            entry = takeJob(index);
+            if (entry.job) queuedJobs--;
         }
         
-        if (job) {
-            job();
-            jobsExecuted++;
-            
-            // Decrement active jobs and notify waitAll if done
-            if (--activeJobs == 0) {
-                std::lock_guard<std::mutex> lock(waitMutex);
-                waitCV.notify_all();
-            }
+        if (entry.job) {
+            entry.job();
+            finishJob(*entry.group);
         }
     }
 }
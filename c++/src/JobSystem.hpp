@@ -1,45 +1,125 @@
 #pragma once
 #include <vector>
 #include <thread>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <atomic>
+#include <cstdint>
 
 // Simple job system for parallel entity updates (Design Doc §6)
+//
+// Jobs belong to a Group, and wait() is the barrier for one group only, so several
+// simulations can share one pool: each waits for its own chunks while the others'
+// jobs keep flowing. A pool worker that waits (e.g. a whole simulation tick running
+// as a job) helps by running its group's queued jobs instead of blocking, so the
+// pool cannot deadlock with every worker parked in a wait. Other threads block.
+//
+// Besides the shared FIFO, each worker has its own queue. A job submitted to a worker
+// runs there unless that worker falls behind and an idle one steals it, so chunks of
+// the same agents given the same worker in every phase of a tick find their data still
+// in that core's cache. Only queues whose owner has started on them are stolen from,
+// and a batch submit queues a whole phase before waking anyone, so the first jobs
+// aren't taken by whichever worker woke first.
 class JobSystem {
 public:
     using Job = std::function<void()>;
     
-    JobSystem();
+    static constexpr uint32_t kSharedQueue = UINT32_MAX;
+    struct BatchJob {
+        Job job;
+        uint32_t worker;  // Queue index (modulo the worker count), or kSharedQueue
+    };
+    
+    // Jobs submitted together and waited for together
+    class Group {
+    public:
+        uint32_t getJobsExecuted() const { return executed.load(); }
+        void resetJobCounter() { executed = 0; }
+    private:
+        friend class JobSystem;
+        std::atomic<uint32_t> pending{0};  // Queued and running
+        std::atomic<uint32_t> executed{0};
+    };
+    
+    // workerCount == 0 sizes the pool from availableCpus(), leaving one for the main
+    // thread. pinWorkers binds worker i to the i-th CPU this process may use (Linux;
+    // ignored elsewhere), so sticky jobs also stay on one core.
+    explicit JobSystem(uint32_t workerCount = 0, bool pinWorkers = false);
     ~JobSystem();
     
+    // CPUs this process can really use: its affinity mask, capped by a cgroup CPU quota
+    // (a container limited to 2 CPUs on a 64-core host gets 2, not 64)
+    static uint32_t availableCpus();
+    
     // Submit a job to be executed by worker threads
     void submit(Job job);
+    void submit(Job job, Group& group);
+    // Queue a job on one worker (index modulo the worker count); others only steal it
+    // once their own queues and the shared one are empty and the owner has started
+    void submit(Job job, Group& group, uint32_t worker);
+    // Queue every job under one lock and wake the workers once. Moves the jobs out and
+    // clears jobs, keeping its capacity.
+    void submit(std::vector<BatchJob>& jobs, Group& group);
     
     // Wait for all submitted jobs to complete (barrier pattern, Design Doc §6.3)
     void waitAll();
+    // Wait for one group's jobs; pool workers run that group's queued jobs meanwhile
+    void wait(Group& group);
+    
+    // Index of the calling worker thread in [0, workerCount); any other thread
+    // (e.g. the simulation thread) gets workerCount. Used to pick per-worker scratch.
+    uint32_t getCurrentWorkerIndex() const;
     
     // Metrics
     uint32_t getWorkerCount() const { return workerCount; }
+    bool areWorkersPinned() const { return pinned; }
     uint32_t getJobsExecuted() const { return jobsExecuted.load(); }
-    void resetJobCounter() { jobsExecuted = 0; }
+    // Worker-queued jobs another worker ended up running
+    uint32_t getJobsStolen() const { return jobsStolen.load(); }
+    void resetJobCounter() { jobsExecuted = 0; jobsStolen = 0; }
 
 private:
+    struct Entry {
+        Job job;  // Empty once taken out of order by a helping wait() or a steal
+        Group* group;
+    };
+    
+    // FIFO kept as a vector + read index; it only grows, so steady-state submits
+    // don't allocate (a deque frees and reallocates its nodes as it drains)
+    static constexpr size_t kReservedJobs = 1024;  // Initial capacity of every queue
+    struct Queue {
+        std::vector<Entry> entries;
+        size_t head = 0;
+        bool started = false;  // Owner took a job since the queue was last empty: stealable
+        bool hasJobs() const { return head < entries.size(); }
+    };
+    
     uint32_t workerCount;
+    bool pinned = false;
     std::vector<std::thread> workers;
     
-    std::queue<Job> jobQueue;
+    Queue sharedQueue;
+    std::vector<Queue> workerQueues;  // One per worker
+    uint32_t queuedJobs = 0;          // In all queues
     std::mutex queueMutex;
     std::condition_variable queueCV;
     
     std::atomic<bool> running{true};
-    std::atomic<uint32_t> activeJobs{0};
+    Group defaultGroup;  // Jobs submitted without a group; waitAll() waits for these
     std::atomic<uint32_t> jobsExecuted{0};
+    std::atomic<uint32_t> jobsStolen{0};
     
     std::mutex waitMutex;
     std::condition_variable waitCV;
     
-    void workerLoop();
+    void workerLoop(uint32_t index, int cpu);
+    bool runQueuedJob(Group& group);  // Take and run one queued job of group, if any
+    // Own queue, then the shared one, then steal the newest job of another worker
+    // (queueMutex held, queuedJobs > 0)
+    Entry takeJob(uint32_t index);
+    bool canTakeJob(uint32_t index) const;  // takeJob would find one (queueMutex held)
+    static Entry takeFront(Queue& queue);
+    static void skipTakenJobs(Queue& queue);  // Advance head past emptied entries
+    void finishJob(Group& group);
 };
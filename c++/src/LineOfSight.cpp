@@ -0,0 +1,160 @@
+#include "LineOfSight.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void ObstacleGrid::clear() {
+    boxes.clear();
+    discs.clear();
+    cellStart.clear();
+    cellItems.clear();
+    columns = 0;
+    rows = 0;
+}
+
+void ObstacleGrid::build(const std::vector<Box>& newBoxes, const std::vector<Disc>& newDiscs,
+                         float worldWidth, float worldHeight) {
+    clear();
+    boxes = newBoxes;
+    discs = newDiscs;
+
+    // Coarser cells in huge worlds so the grid stays small; obstacles are sparse anyway
+    cellSize = std::max(kMinCellSize, std::sqrt(worldWidth * worldHeight / kMaxCells));
+    invCellSize = 1.0f / cellSize;
+    columns = std::max(1u, static_cast<uint32_t>(std::ceil(worldWidth * invCellSize)));
+    rows = std::max(1u, static_cast<uint32_t>(std::ceil(worldHeight * invCellSize)));
+
+    // Cell range of every obstacle's bounds, clamped to the grid
+    const uint32_t itemCount = static_cast<uint32_t>(boxes.size() + discs.size());
+    auto cellRange = [this](float minX, float minY, float maxX, float maxY, uint32_t range[4]) {
+        auto cell = [this](float v, uint32_t count) {
+            return static_cast<uint32_t>(std::clamp(std::floor(v * invCellSize), 0.0f, static_cast<float>(count - 1)));
+        };
+        range[0] = cell(minX, columns);
+        range[1] = cell(minY, rows);
+        range[2] = cell(maxX, columns);
+        range[3] = cell(maxY, rows);
+    };
+    std::vector<uint32_t> ranges(itemCount * 4);
+    for (uint32_t b = 0; b < boxes.size(); b++) {
+        const Box& box = boxes[b];
+        cellRange(box.x, box.y, box.x + box.width, box.y + box.height, &ranges[b * 4]);
+    }
+    for (uint32_t d = 0; d < discs.size(); d++) {
+        const Disc& disc = discs[d];
+        cellRange(disc.x - disc.radius, disc.y - disc.radius, disc.x + disc.radius, disc.y + disc.radius,
+                  &ranges[(boxes.size() + d) * 4]);
+    }
+
+    // Count, prefix sum, fill: items end up in obstacle order within each cell
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    for (uint32_t item = 0; item < itemCount; item++) {
+        const uint32_t* r = &ranges[item * 4];
+        for (uint32_t cy = r[1]; cy <= r[3]; cy++) {
+            for (uint32_t cx = r[0]; cx <= r[2]; cx++) cellStart[cy * columns + cx + 1]++;
+        }
+    }
+    for (size_t c = 1; c < cellStart.size(); c++) cellStart[c] += cellStart[c - 1];
+    cellItems.resize(cellStart.back());
+    std::vector<uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+    for (uint32_t item = 0; item < itemCount; item++) {
+        const uint32_t* r = &ranges[item * 4];
+        for (uint32_t cy = r[1]; cy <= r[3]; cy++) {
+            for (uint32_t cx = r[0]; cx <= r[2]; cx++) cellItems[cursor[cy * columns + cx]++] = item;
+        }
+    }
+}
+
+bool ObstacleGrid::blocksSegment(uint32_t item, float x0, float y0, float dx, float dy, uint32_t kindMask) const {
+    if (item < boxes.size()) {
+        if (!(kindMask & KindBox)) return false;
+        // Slab test: the segment's t range inside both axis bands must be non-empty
+        const Box& box = boxes[item];
+        float tMin = 0.0f;
+        float tMax = 1.0f;
+        const float origin[2] = {x0, y0};
+        const float dir[2] = {dx, dy};
+        const float lo[2] = {box.x, box.y};
+        const float hi[2] = {box.x + box.width, box.y + box.height};
+        for (int axis = 0; axis < 2; axis++) {
+            if (std::fabs(dir[axis]) < 1e-6f) {
+                if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) return false;
+                continue;
+            }
+            const float inv = 1.0f / dir[axis];
+            float t0 = (lo[axis] - origin[axis]) * inv;
+            float t1 = (hi[axis] - origin[axis]) * inv;
+            if (t0 > t1) std::swap(t0, t1);
+            tMin = std::max(tMin, t0);
+            tMax = std::min(tMax, t1);
+            if (tMin > tMax) return false;
+        }
+        return true;
+    }
+
+    if (!(kindMask & KindDisc)) return false;
+    // Closest point of the segment to the disc center
+    const Disc& disc = discs[item - boxes.size()];
+    const float lengthSq = dx * dx + dy * dy;
+    float t = lengthSq > 0.0f ? ((disc.x - x0) * dx + (disc.y - y0) * dy) / lengthSq : 0.0f;
+    t = std::clamp(t, 0.0f, 1.0f);
+    const float cx = x0 + dx * t - disc.x;
+    const float cy = y0 + dy * t - disc.y;
+    return cx * cx + cy * cy < disc.radius * disc.radius;
+}
+
+bool ObstacleGrid::segmentClear(float x0, float y0, float x1, float y1, uint32_t kindMask) const {
+    if (cellItems.empty()) return true;
+    const float dx = x1 - x0;
+    const float dy = y1 - y0;
+
+    // Walk the cells the segment crosses in order
+    const float gx0 = x0 * invCellSize;
+    const float gy0 = y0 * invCellSize;
+    const float gdx = dx * invCellSize;
+    const float gdy = dy * invCellSize;
+    int32_t cx = static_cast<int32_t>(std::floor(gx0));
+    int32_t cy = static_cast<int32_t>(std::floor(gy0));
+    const int32_t endX = static_cast<int32_t>(std::floor(gx0 + gdx));
+    const int32_t endY = static_cast<int32_t>(std::floor(gy0 + gdy));
+    const int32_t stepX = gdx > 0.0f ? 1 : -1;
+    const int32_t stepY = gdy > 0.0f ? 1 : -1;
+    constexpr float kNever = std::numeric_limits<float>::infinity();
+    // Segment t at the next vertical / horizontal cell border, and t per cell
+    float tNextX = gdx != 0.0f ? ((stepX > 0 ? cx + 1 : cx) - gx0) / gdx : kNever;
+    float tNextY = gdy != 0.0f ? ((stepY > 0 ? cy + 1 : cy) - gy0) / gdy : kNever;
+    const float tStepX = gdx != 0.0f ? std::fabs(1.0f / gdx) : kNever;
+    const float tStepY = gdy != 0.0f ? std::fabs(1.0f / gdy) : kNever;
+
+    uint32_t cells = static_cast<uint32_t>(std::abs(endX - cx) + std::abs(endY - cy)) + 1;
+    while (cells-- > 0) {
+        // Past the edge, the edge cells hold whatever sticks out of the world
+        const uint32_t column = static_cast<uint32_t>(std::clamp(cx, 0, static_cast<int32_t>(columns) - 1));
+        const uint32_t row = static_cast<uint32_t>(std::clamp(cy, 0, static_cast<int32_t>(rows) - 1));
+        const uint32_t cell = row * columns + column;
+        for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+            if (blocksSegment(cellItems[k], x0, y0, dx, dy, kindMask)) return false;
+        }
+        if (tNextX < tNextY) {
+            cx += stepX;
+            tNextX += tStepX;
+        } else {
+            cy += stepY;
+            tNextY += tStepY;
+        }
+    }
+    return true;
+}
+
+void ObstacleGrid::trace(RayBatch& batch, uint32_t first, uint32_t last) const {
+    for (uint32_t wordStart = first; wordStart < last; wordStart += RayBatch::kRaysPerWord) {
+        const uint32_t wordEnd = std::min(wordStart + RayBatch::kRaysPerWord, last);
+        uint64_t word = 0;
+        for (uint32_t r = wordStart; r < wordEnd; r++) {
+            if (segmentClear(batch.fromX[r], batch.fromY[r], batch.toX[r], batch.toY[r], batch.mask)) {
+                word |= uint64_t(1) << (r - wordStart);
+            }
+        }
+        batch.visible[wordStart / RayBatch::kRaysPerWord] = word;
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Line-of-sight queries as a batch: add every segment a phase needs tested, trace the
+// batch (in parallel chunks when it is large), then read one visibility bit per ray.
+// Columns are SoA and the bits are packed 64 rays to a word, so chunks that start on a
+// multiple of 64 rays never share a word.
+struct RayBatch {
+    static constexpr uint32_t kRaysPerWord = 64;
+
+    std::vector<float> fromX, fromY, toX, toY;
+    std::vector<uint64_t> visible;  // Bit r % 64 of word r / 64; valid after tracing
+    uint32_t mask = ~0u;            // ObstacleGrid kinds that block this batch
+
+    void clear() {
+        fromX.clear();
+        fromY.clear();
+        toX.clear();
+        toY.clear();
+        visible.clear();
+    }
+    uint32_t size() const { return static_cast<uint32_t>(fromX.size()); }
+    uint32_t add(float x0, float y0, float x1, float y1) {
+        fromX.push_back(x0);
+        fromY.push_back(y0);
+        toX.push_back(x1);
+        toY.push_back(y1);
+        return size() - 1;
+    }
+    // Call once all rays are added, before tracing
+    void resetVisibility() { visible.assign((size() + kRaysPerWord - 1) / kRaysPerWord, 0); }
+    bool isVisible(uint32_t ray) const { return (visible[ray / kRaysPerWord] >> (ray % kRaysPerWord)) & 1u; }
+};
+
+// The static obstacles (buildings and trees) binned into a uniform grid for segment
+// tests. Each cell lists the obstacles overlapping it (one flat array, a range per
+// cell), and a segment walks only the cells it crosses (grid DDA, Amanatides & Woo),
+// testing their obstacles exactly: slab test for boxes, closest point for discs. The
+// walk stops at the first blocker, so a short clear ray costs a few cells.
+//
+// Obstacles never move, so the grid is built once per world (and after a snapshot
+// load) and is read-only afterwards: any number of threads may trace at once.
+class ObstacleGrid {
+public:
+    enum Kind : uint32_t {
+        KindBox = 1u << 0,   // Buildings
+        KindDisc = 1u << 1,  // Trees
+    };
+    struct Box {
+        float x, y, width, height;
+    };
+    struct Disc {
+        float x, y, radius;
+    };
+
+    void build(const std::vector<Box>& boxes, const std::vector<Disc>& discs, float worldWidth, float worldHeight);
+    void clear();
+
+    // True if no obstacle of a kind in kindMask touches the segment
+    bool segmentClear(float x0, float y0, float x1, float y1, uint32_t kindMask = ~0u) const;
+
+    // Writes the visibility words of rays [first, last) after resetVisibility(). first
+    // must be a multiple of 64 and last one too unless it is the end of the batch, so
+    // concurrent ranges never touch the same word.
+    void trace(RayBatch& batch, uint32_t first, uint32_t last) const;
+
+    float getCellSize() const { return cellSize; }
+    uint32_t getCellCount() const { return columns * rows; }
+
+private:
+    // Cells per world stay bounded however large the world is
+    static constexpr float kMinCellSize = 64.0f;
+    static constexpr uint32_t kMaxCells = 1u << 16;
+
+    std::vector<Box> boxes;
+    std::vector<Disc> discs;
+    // Obstacles of cell c: cellItems[cellStart[c] .. cellStart[c + 1]). Boxes are
+    // indices < boxes.size(), discs follow at boxes.size() + disc index.
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> cellItems;
+    float cellSize = kMinCellSize;
+    float invCellSize = 1.0f / kMinCellSize;
+    uint32_t columns = 0;
+    uint32_t rows = 0;
+
+    bool blocksSegment(uint32_t item, float x0, float y0, float dx, float dy, uint32_t kindMask) const;
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+// Fixed-point number stored in a small integer that reads and writes as float.
+//
+// Used for EntityHot columns in TACTIX_COMPACT_STATE builds: simulation code keeps
+// doing float math (timer -= dt, comparisons, mixing into expressions) and only the
+// stored value is quantized. Writes round to the nearest step and saturate at the
+// storage range, so out-of-range sentinels clamp instead of wrapping.
+template <typename Storage, int FracBits>
+class Quantized {
+public:
+    static constexpr int kFracBits = FracBits;
+    static constexpr float kScale = static_cast<float>(1u << FracBits);
+    static constexpr float kMin = std::numeric_limits<Storage>::min() / kScale;
+    static constexpr float kMax = std::numeric_limits<Storage>::max() / kScale;
+
+    Quantized() = default;
+    explicit Quantized(float v) : raw(encode(v)) {}
+
+    operator float() const { return raw * (1.0f / kScale); }
+    Quantized& operator=(float v) { raw = encode(v); return *this; }
+    Quantized& operator+=(float v) { return *this = static_cast<float>(*this) + v; }
+    Quantized& operator-=(float v) { return *this = static_cast<float>(*this) - v; }
+
+    Storage getRaw() const { return raw; }
+
+private:
+    Storage raw = 0;
+
+    static Storage encode(float v) {
+        float scaled = v * kScale;
+        constexpr float lo = static_cast<float>(std::numeric_limits<Storage>::min());
+        constexpr float hi = static_cast<float>(std::numeric_limits<Storage>::max());
+        if (!(scaled > lo)) return std::numeric_limits<Storage>::min();  // Also catches NaN
+        if (scaled >= hi) return std::numeric_limits<Storage>::max();
+        return static_cast<Storage>(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+    }
+};
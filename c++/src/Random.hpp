@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+
+// Deterministic RNG owned by a Simulation.
+// raylib's GetRandomValue is process-global and its state can't be saved, so the
+// simulation keeps its own: a sequential stream for main-thread decisions and a
+// stateless keyed draw for worker threads, which gives the same value for the same
+// (seed, tick, entity, stream) no matter which worker runs the chunk.
+class Rng {
+public:
+    explicit Rng(uint64_t seed = 0x7AC71Cull) { reseed(seed); }
+
+    void reseed(uint64_t seed) { state = seed; }
+    uint64_t getState() const { return state; }
+    void setState(uint64_t s) { state = s; }
+
+    // splitmix64
+    uint64_t next() {
+        state += 0x9E3779B97F4A7C15ull;
+        return mix(state);
+    }
+
+    // Inclusive range, same contract as raylib's GetRandomValue
+    int range(int min, int max) { return toRange(next(), min, max); }
+
+    static int rangeAt(uint64_t seed, uint64_t tick, uint32_t entity, uint32_t stream, int min, int max) {
+        uint64_t key = seed ^ (tick * 0xD1B54A32D192ED03ull) ^
+                       (static_cast<uint64_t>(entity) * 0xABC98388FB8FAC03ull) ^
+                       (static_cast<uint64_t>(stream) * 0x8CB92BA72F3D8DD7ull);
+        return toRange(mix(key + 0x9E3779B97F4A7C15ull), min, max);
+    }
+
+    // splitmix64 finalizer: every input bit affects every output bit
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state;
+
+    static int toRange(uint64_t bits, int min, int max) {
+        if (min > max) { int t = min; min = max; max = t; }
+        uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+        return static_cast<int>(min + static_cast<int64_t>(bits % span));
+    }
+};
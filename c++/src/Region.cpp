@@ -0,0 +1,271 @@
+#include "Region.hpp"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+float msSince(Clock::time_point from) {
+    return std::chrono::duration<float>(Clock::now() - from).count() * 1000.0f;
+}
+
+// Strips holding equal shares of the histogram's agents, at least minWidth wide.
+// Pure function of its inputs, so every rank computes the same cuts.
+RegionLayout balancedLayout(const std::vector<uint64_t>& histogram, uint32_t regions, float width, float minWidth) {
+    uint64_t total = 0;
+    for (uint64_t n : histogram) total += n;
+    if (total == 0 || width < minWidth * regions) return RegionLayout::uniform(regions, width);
+
+    const float binWidth = width / histogram.size();
+    RegionLayout layout;
+    layout.bounds.assign(regions + 1, 0.0f);
+    layout.bounds[regions] = width;
+    uint64_t before = 0;  // Agents in the bins left of bin
+    size_t bin = 0;
+    for (uint32_t r = 1; r < regions; r++) {
+        const double target = static_cast<double>(total) * r / regions;
+        while (bin < histogram.size() && before + histogram[bin] < target) before += histogram[bin++];
+        // Interpolate inside the bin the cut falls in
+        const double inBin = bin < histogram.size() && histogram[bin] > 0
+            ? (target - before) / histogram[bin] : 0.0;
+        layout.bounds[r] = static_cast<float>((bin + inBin) * binWidth);
+    }
+
+    // Keep every strip at least one ghost band wide, so ghosts only go to direct neighbors
+    for (uint32_t r = 1; r < regions; r++) {
+        layout.bounds[r] = std::max(layout.bounds[r], layout.bounds[r - 1] + minWidth);
+    }
+    for (uint32_t r = regions - 1; r > 0; r--) {
+        layout.bounds[r] = std::min(layout.bounds[r], layout.bounds[r + 1] - minWidth);
+    }
+    return layout;
+}
+
+uint32_t histogramBin(float x, float width, uint32_t bins) {
+    float t = std::clamp(x / width, 0.0f, 1.0f);
+    return std::min(static_cast<uint32_t>(t * bins), bins - 1);
+}
+
+// Message to one neighbor: counts, then migrant records, then ghost records
+struct MessageHeader {
+    uint32_t migrants;
+    uint32_t ghosts;
+};
+}
+
+RegionLayout RegionLayout::uniform(uint32_t regions, float worldWidth) {
+    RegionLayout layout;
+    layout.bounds.resize(regions + 1);
+    for (uint32_t r = 0; r <= regions; r++) {
+        layout.bounds[r] = worldWidth * r / regions;
+    }
+    return layout;
+}
+
+uint32_t RegionLayout::regionOf(float x) const {
+    // Interior boundaries at or left of x
+    auto interiorFirst = bounds.begin() + 1;
+    auto interiorLast = bounds.end() - 1;
+    return static_cast<uint32_t>(std::upper_bound(interiorFirst, interiorLast, x) - interiorFirst);
+}
+
+RegionNode::RegionNode(const RegionConfig& regionConfig, RegionTransport& regionTransport)
+    : config(regionConfig)
+    , transport(regionTransport)
+{
+    const uint32_t rank = transport.rank();
+    if (rank > 0) peers.push_back(rank - 1);
+    if (rank + 1 < transport.size()) peers.push_back(rank + 1);
+}
+
+bool RegionNode::init() {
+    sim = std::make_unique<Simulation>(config.world, config.workers);
+    sim->setSeed(config.seed);
+    sim->setMaxThinkInterval(config.maxThinkInterval);
+    sim->setHordesEnabled(config.hordes);
+    sim->init(config.agents, config.mix);
+    sim->setPaused(false);
+
+    // Every rank sees the whole initial population, so the first cut needs no exchange
+    const EntityHot& entities = sim->getEntities();
+    std::vector<uint64_t> histogram(kHistogramBins, 0);
+    for (size_t i = 0; i < entities.count; i++) {
+        histogram[histogramBin(entities.posX[i], config.world.width, kHistogramBins)]++;
+    }
+    layout = config.rebalanceInterval > 0
+        ? balancedLayout(histogram, transport.size(), config.world.width, config.ghostBand)
+        : RegionLayout::uniform(transport.size(), config.world.width);
+    if (config.world.width < config.ghostBand * transport.size()) {
+        spdlog::warn("World width {} leaves strips narrower than the ghost band ({}) for {} ranks",
+                     config.world.width, config.ghostBand, transport.size());
+    }
+
+    std::vector<uint32_t> others;
+    for (uint32_t i = 0; i < entities.count; i++) {
+        if (layout.regionOf(entities.posX[i]) != transport.rank()) others.push_back(i);
+    }
+    sim->removeAgents(others);
+    spdlog::info("Rank {}: x [{:.0f}, {:.0f}), {} of {} agents", transport.rank(),
+                 layout.bounds[transport.rank()], layout.bounds[transport.rank() + 1],
+                 sim->getAgentCount(), config.agents);
+
+    // Everyone must be done with init before the first exchange
+    std::vector<uint64_t> counts;
+    return allGather(sim->getAgentCount(), counts);
+}
+
+bool RegionNode::step(float dt) {
+    lastStats = RegionStepStats{};
+    auto start = Clock::now();
+    if (!exchangeWithNeighbors()) return false;
+    lastStats.exchangeMs = msSince(start);
+
+    start = Clock::now();
+    sim->tick(dt);
+    sim->removeGhosts();
+    lastStats.tickMs = msSince(start);
+
+    if (config.rebalanceInterval > 0 && sim->getTickCount() % config.rebalanceInterval == 0) {
+        start = Clock::now();
+        if (!rebalance()) return false;
+        lastStats.exchangeMs += msSince(start);
+    }
+    return true;
+}
+
+bool RegionNode::exchangeWithNeighbors() {
+    const uint32_t rank = transport.rank();
+    const float left = layout.bounds[rank];
+    const float right = layout.bounds[rank + 1];
+    const bool hasLeft = rank > 0;
+    const bool hasRight = rank + 1 < transport.size();
+
+    // Side 0 is the left neighbor, side 1 the right one
+    for (int side = 0; side < 2; side++) {
+        migrants[side].clear();
+        ghosts[side].clear();
+    }
+    const EntityHot& entities = sim->getEntities();
+    for (uint32_t i = 0; i < entities.count; i++) {
+        const float x = entities.posX[i];
+        const uint32_t owner = layout.regionOf(x);
+        if (owner != rank && entities.state[i] != AgentState::Fighting) {
+            migrants[owner < rank ? 0 : 1].push_back(i);
+            continue;
+        }
+        if (hasLeft && x < left + config.ghostBand) ghosts[0].push_back(i);
+        if (hasRight && x >= right - config.ghostBand) ghosts[1].push_back(i);
+    }
+
+    outgoing.resize(peers.size());
+    for (size_t n = 0; n < peers.size(); n++) {
+        const int side = peers[n] < rank ? 0 : 1;
+        MessageHeader header{static_cast<uint32_t>(migrants[side].size()),
+                             static_cast<uint32_t>(ghosts[side].size())};
+        outgoing[n].resize(sizeof(header));
+        std::memcpy(outgoing[n].data(), &header, sizeof(header));
+        sim->packAgents(migrants[side].data(), migrants[side].size(), outgoing[n]);
+        sim->packAgents(ghosts[side].data(), ghosts[side].size(), outgoing[n]);
+        lastStats.migratedOut += header.migrants;
+        lastStats.ghostsSent += header.ghosts;
+    }
+    // Indices change as agents are removed, so only after everything is packed
+    migrants[0].insert(migrants[0].end(), migrants[1].begin(), migrants[1].end());
+    sim->removeAgents(migrants[0]);
+
+    if (!transport.exchange(peers, outgoing, incoming)) return false;
+
+    // Migrants of both neighbors first, so owned agents stay ahead of the ghosts
+    const size_t recordBytes = sim->getAgentRecordBytes();
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t n = 0; n < peers.size(); n++) {
+            MessageHeader header;
+            if (incoming[n].size() < sizeof(header)) return false;
+            std::memcpy(&header, incoming[n].data(), sizeof(header));
+            if (incoming[n].size() != sizeof(header) + (size_t(header.migrants) + header.ghosts) * recordBytes) {
+                spdlog::error("Rank {}: malformed exchange from rank {} ({} bytes)", rank, peers[n], incoming[n].size());
+                return false;
+            }
+            const uint8_t* records = incoming[n].data() + sizeof(header);
+            if (pass == 0) {
+                sim->unpackAgents(records, header.migrants, false);
+                lastStats.migratedIn += header.migrants;
+            } else {
+                sim->unpackAgents(records + header.migrants * recordBytes, header.ghosts, true);
+                lastStats.ghostsReceived += header.ghosts;
+            }
+        }
+    }
+    return true;
+}
+
+bool RegionNode::rebalance() {
+    const EntityHot& entities = sim->getEntities();
+    std::vector<uint32_t> histogram(kHistogramBins, 0);
+    for (size_t i = 0; i < entities.count; i++) {
+        histogram[histogramBin(entities.posX[i], config.world.width, kHistogramBins)]++;
+    }
+    std::vector<uint8_t> mine(histogram.size() * sizeof(uint32_t));
+    std::memcpy(mine.data(), histogram.data(), mine.size());
+    std::vector<std::vector<uint8_t>> all;
+    if (!allGatherBytes(mine, all)) return false;
+
+    // Whole-world histogram and per-rank load, identical on every rank
+    std::vector<uint64_t> total(kHistogramBins, 0);
+    uint64_t sum = 0, busiest = 0;
+    for (const auto& bytes : all) {
+        if (bytes.size() != mine.size()) return false;
+        std::memcpy(histogram.data(), bytes.data(), bytes.size());
+        uint64_t load = 0;
+        for (uint32_t b = 0; b < kHistogramBins; b++) {
+            total[b] += histogram[b];
+            load += histogram[b];
+        }
+        sum += load;
+        busiest = std::max(busiest, load);
+    }
+    const double mean = static_cast<double>(sum) / transport.size();
+    if (sum == 0 || busiest <= mean * config.rebalanceThreshold) return true;
+
+    layout = balancedLayout(total, transport.size(), config.world.width, config.ghostBand);
+    lastStats.rebalanced = true;
+    rebalances++;
+    if (transport.rank() == 0) {
+        spdlog::info("Tick {}: rebalanced regions (busiest rank {} agents, mean {:.0f})",
+                     sim->getTickCount(), busiest, mean);
+    }
+    return true;
+}
+
+bool RegionNode::allGather(uint64_t value, std::vector<uint64_t>& perRank) {
+    std::vector<uint8_t> mine(sizeof(value));
+    std::memcpy(mine.data(), &value, sizeof(value));
+    std::vector<std::vector<uint8_t>> all;
+    if (!allGatherBytes(mine, all)) return false;
+    perRank.resize(all.size());
+    for (size_t r = 0; r < all.size(); r++) {
+        if (all[r].size() != sizeof(uint64_t)) return false;
+        std::memcpy(&perRank[r], all[r].data(), sizeof(uint64_t));
+    }
+    return true;
+}
+
+bool RegionNode::allGatherBytes(const std::vector<uint8_t>& mine, std::vector<std::vector<uint8_t>>& all) {
+    const uint32_t rank = transport.rank();
+    std::vector<uint32_t> everyone;
+    for (uint32_t r = 0; r < transport.size(); r++) {
+        if (r != rank) everyone.push_back(r);
+    }
+    std::vector<std::vector<uint8_t>> sends(everyone.size(), mine);
+    std::vector<std::vector<uint8_t>> received;
+    if (!transport.exchange(everyone, sends, received)) return false;
+
+    all.assign(transport.size(), {});
+    all[rank] = mine;
+    for (size_t n = 0; n < everyone.size(); n++) {
+        all[everyone[n]] = std::move(received[n]);
+    }
+    return true;
+}
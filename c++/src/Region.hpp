@@ -0,0 +1,99 @@
+#pragma once
+#include "Simulation.hpp"
+#include "RegionTransport.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// The world cut into vertical strips along x, one per rank: rank r owns agents with
+// bounds[r] <= x < bounds[r + 1] (the first and last strips extend past the world edge)
+struct RegionLayout {
+    std::vector<float> bounds;  // Region count + 1 entries, ascending
+
+    static RegionLayout uniform(uint32_t regions, float worldWidth);
+    uint32_t count() const { return static_cast<uint32_t>(bounds.size() - 1); }
+    uint32_t regionOf(float x) const;
+};
+
+// One rank's share of a partitioned run. Every rank must use the same settings.
+struct RegionConfig {
+    WorldConfig world;
+    PopulationMix mix;
+    size_t agents = 100000;     // Whole world, split between the ranks
+    uint64_t seed = 1337;
+    uint32_t workers = 0;       // This rank's job system (0 = hardware concurrency)
+    uint32_t maxThinkInterval = Simulation::kDefaultThinkInterval;
+    bool hordes = false;
+    float ghostBand = 150.0f;   // Neighbor agents this close to a boundary are copied in (seek radius)
+    uint32_t rebalanceInterval = 120;  // Ticks between load checks, 0 = fixed strips
+    float rebalanceThreshold = 1.2f;   // Re-cut when the busiest rank holds this much more than the mean
+};
+
+// What one step() did on this rank
+struct RegionStepStats {
+    uint32_t migratedOut = 0;
+    uint32_t migratedIn = 0;
+    uint32_t ghostsSent = 0;
+    uint32_t ghostsReceived = 0;
+    float exchangeMs = 0.0f;  // Packing, transport and unpacking
+    float tickMs = 0.0f;
+    bool rebalanced = false;
+};
+
+// Runs one region of a spatially partitioned simulation.
+//
+// Each rank holds a full-size Simulation (same world, obstacles and seed) with its own
+// JobSystem but only simulates the agents in its strip. Every step, before ticking,
+// neighbors swap two things: agents that left a strip migrate to the neighbor on that
+// side (further ranks forward them on the next step), and agents within ghostBand of a
+// boundary are copied across as ghosts, so perception, separation and spatial queries
+// near the edge see the other side. Ghosts are dropped again after the tick. Agents
+// locked in melee wait for the fight to end before they migrate.
+//
+// Cross-boundary interactions are one-way: an agent sees and avoids ghosts, but bites,
+// melee, shots and feeding only happen between agents the same rank owns. Gunshot
+// markers and hordes stay local to their rank. A run is deterministic for a given rank
+// count but does not reproduce the single-process result.
+//
+// Every rebalanceInterval ticks the ranks all-gather an x histogram of their agents
+// and, if the load is uneven (a horde gathered on one strip), move the boundaries to
+// equal-count cuts; agents on the wrong side migrate over the following steps.
+class RegionNode {
+public:
+    RegionNode(const RegionConfig& config, RegionTransport& transport);
+
+    // Builds the same initial world on every rank and keeps this rank's strip. Collective.
+    bool init();
+    // Exchange migrants and ghosts with the neighbors, then tick. Collective; false if
+    // the transport failed.
+    bool step(float dt);
+
+    Simulation& getSimulation() { return *sim; }
+    const RegionLayout& getLayout() const { return layout; }
+    const RegionStepStats& getLastStepStats() const { return lastStats; }
+    uint32_t getRebalanceCount() const { return rebalances; }
+
+    // One value from every rank, in rank order. Collective.
+    bool allGather(uint64_t value, std::vector<uint64_t>& perRank);
+
+private:
+    static constexpr uint32_t kHistogramBins = 256;
+
+    RegionConfig config;
+    RegionTransport& transport;
+    std::unique_ptr<Simulation> sim;
+    RegionLayout layout;
+    RegionStepStats lastStats;
+    uint32_t rebalances = 0;
+
+    // Scratch reused every step
+    std::vector<uint32_t> peers;  // Left and/or right neighbor
+    std::vector<std::vector<uint8_t>> outgoing;
+    std::vector<std::vector<uint8_t>> incoming;
+    std::vector<uint32_t> migrants[2];
+    std::vector<uint32_t> ghosts[2];
+
+    bool allGatherBytes(const std::vector<uint8_t>& mine, std::vector<std::vector<uint8_t>>& all);
+    bool exchangeWithNeighbors();
+    bool rebalance();
+};
@@ -0,0 +1,244 @@
+#include "platform.h"
+#include "RegionTransport.hpp"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool RegionTransport::exchange(const std::vector<uint32_t>& peers, const std::vector<std::vector<uint8_t>>& outgoing,
+                               std::vector<std::vector<uint8_t>>& incoming, uint32_t timeoutMs) {
+    // Each message goes out as an 8-byte length and then its payload
+    struct Progress {
+        uint64_t sendLength;
+        size_t sent = 0;
+        uint8_t header[sizeof(uint64_t)];
+        size_t headerReceived = 0;
+        size_t received = 0;
+        bool done = false;
+    };
+    const size_t peerCount = peers.size();
+    std::vector<Progress> progress(peerCount);
+    incoming.resize(peerCount);
+    for (size_t n = 0; n < peerCount; n++) {
+        progress[n].sendLength = outgoing[n].size();
+        incoming[n].clear();
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto lastProgress = Clock::now();
+    size_t remaining = peerCount;
+    while (remaining > 0) {
+        bool moved = false;
+        for (size_t n = 0; n < peerCount; n++) {
+            Progress& p = progress[n];
+            if (p.done) continue;
+            const uint32_t peer = peers[n];
+
+            const size_t sendTotal = sizeof(uint64_t) + p.sendLength;
+            if (p.sent < sizeof(uint64_t)) {
+                uint8_t header[sizeof(uint64_t)];
+                std::memcpy(header, &p.sendLength, sizeof(header));
+                size_t put = trySend(peer, header + p.sent, sizeof(header) - p.sent);
+                p.sent += put;
+                moved |= put > 0;
+            }
+            if (p.sent >= sizeof(uint64_t) && p.sent < sendTotal) {
+                size_t offset = p.sent - sizeof(uint64_t);
+                size_t put = trySend(peer, outgoing[n].data() + offset, p.sendLength - offset);
+                p.sent += put;
+                moved |= put > 0;
+            }
+
+            if (p.headerReceived < sizeof(uint64_t)) {
+                size_t got = tryReceive(peer, p.header + p.headerReceived, sizeof(uint64_t) - p.headerReceived);
+                p.headerReceived += got;
+                moved |= got > 0;
+                if (p.headerReceived == sizeof(uint64_t)) {
+                    uint64_t length;
+                    std::memcpy(&length, p.header, sizeof(length));
+                    incoming[n].resize(length);
+                }
+            }
+            if (p.headerReceived == sizeof(uint64_t) && p.received < incoming[n].size()) {
+                size_t got = tryReceive(peer, incoming[n].data() + p.received, incoming[n].size() - p.received);
+                p.received += got;
+                moved |= got > 0;
+            }
+
+            if (p.sent == sendTotal && p.headerReceived == sizeof(uint64_t) && p.received == incoming[n].size()) {
+                p.done = true;
+                remaining--;
+            }
+        }
+
+        if (moved) {
+            lastProgress = Clock::now();
+        } else if (Clock::now() - lastProgress > std::chrono::milliseconds(timeoutMs)) {
+            spdlog::error("Rank {}: exchange with {} peer(s) stalled for {} ms", rank(), remaining, timeoutMs);
+            return false;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    return true;
+}
+
+namespace {
+constexpr uint32_t kSegmentMagic = 0x52475854;  // "TXGR"
+
+struct SegmentHeader {
+    uint32_t magic;
+    uint32_t rankCount;
+    uint64_t ringBytes;
+    std::atomic<uint32_t> ready;     // Set by rank 0 once the rings are initialized
+    std::atomic<uint32_t> attached;  // Ranks that have mapped the segment
+};
+constexpr size_t kHeaderBytes = 64;
+static_assert(sizeof(SegmentHeader) <= kHeaderBytes);
+}
+
+// Counters only grow; head - tail is the fill level. The producer owns head and the
+// consumer owns tail, each on its own cache line.
+struct ShmRingTransport::Ring {
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+    uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+};
+
+ShmRingTransport::Ring* ShmRingTransport::ring(uint32_t from, uint32_t to) const {
+    return reinterpret_cast<Ring*>(base + kHeaderBytes + (static_cast<size_t>(from) * rankCount + to) * ringStride);
+}
+
+std::unique_ptr<ShmRingTransport> ShmRingTransport::open(const std::string& name, uint32_t rank, uint32_t size,
+                                                         size_t ringBytes, uint32_t timeoutMs) {
+#if !defined(_WIN32)
+    if (size == 0 || rank >= size) {
+        spdlog::error("Invalid rank {} of {}", rank, size);
+        return nullptr;
+    }
+    std::unique_ptr<ShmRingTransport> transport(new ShmRingTransport());
+    transport->myRank = rank;
+    transport->rankCount = size;
+    transport->ringBytes = std::bit_ceil(std::max<size_t>(ringBytes, 4096));
+    transport->ringStride = sizeof(Ring) + transport->ringBytes;
+    transport->mappedBytes = kHeaderBytes + static_cast<size_t>(size) * size * transport->ringStride;
+
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    int fd = -1;
+    if (rank == 0) {
+        ::shm_unlink(name.c_str());  // Left over from a crashed run
+        fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd >= 0 && ::ftruncate(fd, static_cast<off_t>(transport->mappedBytes)) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    } else {
+        // Wait for rank 0 to create the segment and size it
+        while (Clock::now() < deadline) {
+            fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+            struct stat st;
+            if (fd >= 0 && ::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == transport->mappedBytes) break;
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    if (fd < 0) {
+        spdlog::error("Rank {}: cannot open shared memory segment {}", rank, name);
+        if (rank == 0) ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void* mapped = ::mmap(nullptr, transport->mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        spdlog::error("Rank {}: cannot map {} bytes of {}", rank, transport->mappedBytes, name);
+        if (rank == 0) ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+    transport->base = static_cast<uint8_t*>(mapped);
+
+    auto* header = reinterpret_cast<SegmentHeader*>(transport->base);
+    if (rank == 0) {
+        // ftruncate zero-filled the segment: every ring starts empty
+        header->magic = kSegmentMagic;
+        header->rankCount = size;
+        header->ringBytes = transport->ringBytes;
+        header->attached.store(1, std::memory_order_relaxed);
+        header->ready.store(1, std::memory_order_release);
+        while (header->attached.load(std::memory_order_acquire) < size && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ::shm_unlink(name.c_str());
+        if (header->attached.load(std::memory_order_acquire) < size) {
+            spdlog::error("Only {} of {} ranks attached to {}", header->attached.load(), size, name);
+            return nullptr;
+        }
+    } else {
+        while (header->ready.load(std::memory_order_acquire) == 0 && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (header->ready.load(std::memory_order_acquire) == 0 || header->magic != kSegmentMagic ||
+            header->rankCount != size || header->ringBytes != transport->ringBytes) {
+            spdlog::error("Rank {}: shared memory segment {} does not match this run", rank, name);
+            return nullptr;
+        }
+        header->attached.fetch_add(1, std::memory_order_acq_rel);
+    }
+    spdlog::info("Rank {}/{} attached to {} ({:.1f} MB of rings)", rank, size, name,
+                 transport->mappedBytes / (1024.0 * 1024.0));
+    return transport;
+#else
+    (void)ringBytes;
+    (void)timeoutMs;
+    spdlog::error("Shared memory transport is not available on this platform ({} rank {}/{})", name, rank, size);
+    return nullptr;
+#endif
+}
+
+ShmRingTransport::~ShmRingTransport() {
+#if !defined(_WIN32)
+    if (base) ::munmap(base, mappedBytes);
+#endif
+}
+
+size_t ShmRingTransport::trySend(uint32_t peer, const uint8_t* data, size_t bytes) {
+    Ring* r = ring(myRank, peer);
+    const uint64_t head = r->head.load(std::memory_order_relaxed);
+    const uint64_t tail = r->tail.load(std::memory_order_acquire);
+    const size_t n = std::min<size_t>(bytes, ringBytes - (head - tail));
+    if (n == 0) return 0;
+
+    // Copy in at most two pieces around the end of the buffer
+    const size_t at = head & (ringBytes - 1);
+    const size_t first = std::min(n, ringBytes - at);
+    std::memcpy(r->data() + at, data, first);
+    std::memcpy(r->data(), data + first, n - first);
+    r->head.store(head + n, std::memory_order_release);
+    return n;
+}
+
+size_t ShmRingTransport::tryReceive(uint32_t peer, uint8_t* out, size_t maxBytes) {
+    Ring* r = ring(peer, myRank);
+    const uint64_t tail = r->tail.load(std::memory_order_relaxed);
+    const uint64_t head = r->head.load(std::memory_order_acquire);
+    const size_t n = std::min<size_t>(maxBytes, head - tail);
+    if (n == 0) return 0;
+
+    const size_t at = tail & (ringBytes - 1);
+    const size_t first = std::min(n, ringBytes - at);
+    std::memcpy(out, r->data() + at, first);
+    std::memcpy(out + first, r->data(), n - first);
+    r->tail.store(tail + n, std::memory_order_release);
+    return n;
+}
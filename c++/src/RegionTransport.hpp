@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Moves bytes between the processes (ranks) of a partitioned run (Region.hpp).
+//
+// Implementations only provide non-blocking per-peer byte streams; exchange() builds
+// whole messages on top of them. Streams may accept or deliver any part of the bytes
+// offered, so exchange() keeps every send and receive moving at once and two ranks
+// sending each other more than a buffer's worth can't deadlock.
+class RegionTransport {
+public:
+    virtual ~RegionTransport() = default;
+
+    virtual uint32_t rank() const = 0;
+    virtual uint32_t size() const = 0;
+
+    // Copy up to bytes to / from the stream with peer; returns how many moved (0 if full/empty)
+    virtual size_t trySend(uint32_t peer, const uint8_t* data, size_t bytes) = 0;
+    virtual size_t tryReceive(uint32_t peer, uint8_t* out, size_t maxBytes) = 0;
+
+    // Send outgoing[n] to peers[n] and receive one message from each into incoming[n].
+    // Both sides must list each other. False if a peer made no progress for timeoutMs.
+    bool exchange(const std::vector<uint32_t>& peers, const std::vector<std::vector<uint8_t>>& outgoing,
+                  std::vector<std::vector<uint8_t>>& incoming, uint32_t timeoutMs = 30000);
+};
+
+// Ranks on one machine: a POSIX shared-memory segment holding one single-producer /
+// single-consumer ring per ordered pair of ranks. Rank 0 creates the segment and
+// unlinks its name once every rank has mapped it, so nothing is left in /dev/shm.
+// The name must be unique per run (e.g. include the launcher's pid).
+class ShmRingTransport : public RegionTransport {
+public:
+    static std::unique_ptr<ShmRingTransport> open(const std::string& name, uint32_t rank, uint32_t size,
+                                                  size_t ringBytes = 4u << 20, uint32_t timeoutMs = 30000);
+    ~ShmRingTransport() override;
+
+    uint32_t rank() const override { return myRank; }
+    uint32_t size() const override { return rankCount; }
+    size_t trySend(uint32_t peer, const uint8_t* data, size_t bytes) override;
+    size_t tryReceive(uint32_t peer, uint8_t* out, size_t maxBytes) override;
+
+private:
+    struct Ring;
+
+    ShmRingTransport() = default;
+    Ring* ring(uint32_t from, uint32_t to) const;
+
+    uint32_t myRank = 0;
+    uint32_t rankCount = 0;
+    size_t ringBytes = 0;     // Data bytes per ring (power of two)
+    size_t ringStride = 0;    // Header + data
+    uint8_t* base = nullptr;  // Mapped segment
+    size_t mappedBytes = 0;
+};
@@ -0,0 +1,292 @@
+#include "platform.h"
+#include "Replay.hpp"
+#include "Simulation.hpp"
+#include "Snapshot.hpp"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr char kMagic[4] = {'T', 'X', 'R', 'P'};
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t seed;
+    float dt;
+    uint32_t keyframeInterval;
+    uint64_t startTick;
+    uint64_t endTick;
+    uint64_t inputCount;
+    uint64_t keyframeCount;
+};
+
+struct KeyframeHeader {
+    uint64_t tick;
+    uint64_t bytes;
+};
+
+uint64_t floatBits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+float bitsFloat(uint64_t v) {
+    uint32_t bits = static_cast<uint32_t>(v);
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+}  // namespace
+
+// ---- ReplayLog ----
+
+bool ReplayLog::save(const std::string& path) const {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        spdlog::error("Replay: cannot open {} for writing", path);
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.seed = seed;
+    header.dt = dt;
+    header.keyframeInterval = keyframeInterval;
+    header.startTick = startTick;
+    header.endTick = endTick;
+    header.inputCount = inputs.size();
+    header.keyframeCount = keyframes.size();
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+    if (ok && !inputs.empty()) {
+        ok = std::fwrite(inputs.data(), sizeof(ReplayInput), inputs.size(), f) == inputs.size();
+    }
+    for (const auto& kf : keyframes) {
+        if (!ok) break;
+        KeyframeHeader kh{kf.tick, kf.snapshot.size()};
+        ok = std::fwrite(&kh, sizeof(kh), 1, f) == 1 &&
+             std::fwrite(kf.snapshot.data(), 1, kf.snapshot.size(), f) == kf.snapshot.size();
+    }
+    std::fclose(f);
+
+    if (!ok) {
+        spdlog::error("Replay: short write to {}", path);
+        return false;
+    }
+    spdlog::info("Replay saved: {} (ticks {}-{}, {} inputs, {} keyframes, {:.1f} MB)",
+                 path, startTick, endTick, inputs.size(), keyframes.size(),
+                 keyframeBytes() / (1024.0f * 1024.0f));
+    return true;
+}
+
+bool ReplayLog::load(const std::string& path) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        spdlog::error("Replay: cannot read {}", path);
+        return false;
+    }
+
+    FileHeader header;
+    if (std::fread(&header, sizeof(header), 1, f) != 1 ||
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        spdlog::error("Replay: {} is not a tactix replay", path);
+        std::fclose(f);
+        return false;
+    }
+    if (header.version != kVersion) {
+        spdlog::error("Replay: unsupported version {} (expected {})", header.version, kVersion);
+        std::fclose(f);
+        return false;
+    }
+
+    ReplayLog loaded;
+    loaded.seed = header.seed;
+    loaded.dt = header.dt;
+    loaded.keyframeInterval = header.keyframeInterval;
+    loaded.startTick = header.startTick;
+    loaded.endTick = header.endTick;
+    loaded.inputs.resize(static_cast<size_t>(header.inputCount));
+
+    bool ok = loaded.inputs.empty() ||
+              std::fread(loaded.inputs.data(), sizeof(ReplayInput), loaded.inputs.size(), f) == loaded.inputs.size();
+    for (uint64_t i = 0; ok && i < header.keyframeCount; i++) {
+        KeyframeHeader kh;
+        ok = std::fread(&kh, sizeof(kh), 1, f) == 1;
+        if (!ok) break;
+        ReplayKeyframe kf;
+        kf.tick = kh.tick;
+        kf.snapshot.resize(static_cast<size_t>(kh.bytes));
+        ok = std::fread(kf.snapshot.data(), 1, kf.snapshot.size(), f) == kf.snapshot.size();
+        loaded.keyframes.push_back(std::move(kf));
+    }
+    std::fclose(f);
+
+    if (!ok || loaded.keyframes.empty()) {
+        spdlog::error("Replay: {} is truncated", path);
+        return false;
+    }
+    *this = std::move(loaded);
+    return true;
+}
+
+size_t ReplayLog::keyframeBytes() const {
+    size_t bytes = 0;
+    for (const auto& kf : keyframes) bytes += kf.snapshot.size();
+    return bytes;
+}
+
+// ---- ReplayRecorder ----
+
+void ReplayRecorder::begin(const Simulation& sim, float dt) {
+    uint32_t interval = std::max<uint32_t>(1, log.keyframeInterval);
+    log = ReplayLog{};
+    log.keyframeInterval = interval;
+    log.seed = sim.getSeed();
+    log.dt = dt;
+    log.startTick = sim.getTickCount();
+    log.endTick = log.startTick;
+    recording = true;
+
+    keyframe(sim);
+    push(sim, ReplayInput::Paused, sim.isPaused() ? 1 : 0);
+    recordedQuality = static_cast<uint64_t>(sim.getQualityLevel());
+    push(sim, ReplayInput::Quality, recordedQuality);
+    spdlog::info("Replay recording started at tick {} (seed {})", log.startTick, log.seed);
+}
+
+void ReplayRecorder::end(const Simulation& sim) {
+    if (!recording) return;
+    log.endTick = sim.getTickCount();
+    recording = false;
+    spdlog::info("Replay recording stopped at tick {} ({} inputs, {} keyframes)",
+                 log.endTick, log.inputs.size(), log.keyframes.size());
+}
+
+void ReplayRecorder::setAgentCount(Simulation& sim, size_t count) {
+    sim.setAgentCount(count);
+    push(sim, ReplayInput::AgentCount, count);
+}
+
+void ReplayRecorder::setPaused(Simulation& sim, bool paused) {
+    sim.setPaused(paused);
+    push(sim, ReplayInput::Paused, paused ? 1 : 0);
+}
+
+void ReplayRecorder::setTimeScale(const Simulation& sim, float timeScale) {
+    push(sim, ReplayInput::TimeScale, floatBits(timeScale));
+}
+
+void ReplayRecorder::afterTick(const Simulation& sim) {
+    if (!recording) return;
+    uint64_t tick = sim.getTickCount();
+    log.endTick = tick;
+    // The governor changes quality at the end of a tick, in effect from the next one
+    const uint64_t quality = static_cast<uint64_t>(sim.getQualityLevel());
+    if (quality != recordedQuality) {
+        recordedQuality = quality;
+        push(sim, ReplayInput::Quality, quality);
+    }
+    if (tick % log.keyframeInterval == 0 && log.keyframes.back().tick != tick) {
+        keyframe(sim);
+    }
+}
+
+void ReplayRecorder::push(const Simulation& sim, ReplayInput::Kind kind, uint64_t value) {
+    if (!recording) return;
+    log.inputs.push_back({sim.getTickCount(), kind, 0, value});
+}
+
+void ReplayRecorder::keyframe(const Simulation& sim) {
+    ReplayKeyframe kf;
+    kf.tick = sim.getTickCount();
+    Snapshot::write(sim, kf.snapshot);
+    log.keyframes.push_back(std::move(kf));
+}
+
+// ---- ReplayPlayer ----
+
+void ReplayPlayer::open(ReplayLog replay) {
+    log = std::move(replay);
+    positioned = nullptr;
+}
+
+bool ReplayPlayer::load(const std::string& path) {
+    ReplayLog replay;
+    if (!replay.load(path)) return false;
+    open(std::move(replay));
+    return true;
+}
+
+bool ReplayPlayer::seek(Simulation& sim, uint64_t targetTick) {
+    if (!isOpen()) return false;
+    auto start = std::chrono::steady_clock::now();
+    targetTick = std::clamp(targetTick, log.startTick, log.endTick);
+
+    // Nearest keyframe at or before the target
+    auto kf = std::upper_bound(log.keyframes.begin(), log.keyframes.end(), targetTick,
+                               [](uint64_t tick, const ReplayKeyframe& k) { return tick < k.tick; });
+    --kf;
+
+    // Running forward from where we already are beats restoring an older keyframe
+    uint64_t current = sim.getTickCount();
+    bool runForward = positioned == &sim && current <= targetTick && current >= kf->tick;
+    if (!runForward) {
+        if (!Snapshot::read(sim, kf->snapshot.data(), kf->snapshot.size())) {
+            positioned = nullptr;
+            return false;
+        }
+        positioned = &sim;
+        current = kf->tick;
+    }
+
+    // Inputs stamped with a tick are applied just before that tick runs. Pause inputs
+    // don't touch state (paused ticks are no-ops), so re-simulation ignores them.
+    auto input = std::lower_bound(log.inputs.begin(), log.inputs.end(), current,
+                                  [](const ReplayInput& in, uint64_t tick) { return in.tick < tick; });
+    
+    // Quality isn't in snapshots: take the last level recorded before this point, and
+    // keep the live governor from picking its own while re-simulating
+    const float liveBudget = sim.getGovernor().getBudget();
+    sim.setTickBudget(0.0f);
+    QualityLevel quality = QualityLevel::Full;
+    for (auto in = log.inputs.begin(); in != input; ++in) {
+        if (in->kind == ReplayInput::Quality) quality = static_cast<QualityLevel>(in->value);
+    }
+    sim.setQualityLevel(quality);
+    
+    sim.setPaused(false);
+    while (sim.getTickCount() < targetTick) {
+        uint64_t tick = sim.getTickCount();
+        for (; input != log.inputs.end() && input->tick == tick; ++input) {
+            if (input->kind == ReplayInput::AgentCount) {
+                sim.setAgentCount(static_cast<size_t>(input->value));
+            } else if (input->kind == ReplayInput::Quality) {
+                sim.setQualityLevel(static_cast<QualityLevel>(input->value));
+            }
+        }
+        sim.tick(log.dt);
+    }
+    sim.setPaused(true);
+    sim.setTickBudget(liveBudget);
+
+    lastSeekTicks = targetTick - current;
+    lastSeekMs = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() * 1000.0f;
+    return true;
+}
+
+float ReplayPlayer::getTimeScaleAt(uint64_t tick, float fallback) const {
+    float scale = fallback;
+    for (const auto& in : log.inputs) {
+        if (in.tick > tick) break;
+        if (in.kind == ReplayInput::TimeScale) scale = bitsFloat(in.value);
+    }
+    return scale;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Simulation;
+
+// One recorded user input. Stamped with the sim tick count when it happened and
+// applied before the next tick runs, so replay sees it at the same point.
+struct ReplayInput {
+    enum Kind : uint32_t {
+        AgentCount = 0,  // value = agent count
+        Paused = 1,      // value = 0/1
+        TimeScale = 2,   // value = float bits
+        Quality = 3,     // value = QualityLevel the governor switched to
+    };
+    uint64_t tick;
+    Kind kind;
+    uint32_t reserved;
+    uint64_t value;
+};
+
+// Full state at a tick (Snapshot::write blob), taken before that tick's inputs
+struct ReplayKeyframe {
+    uint64_t tick;
+    std::vector<uint8_t> snapshot;
+};
+
+// Everything needed to reproduce a run: seed, per-tick inputs and periodic keyframes
+struct ReplayLog {
+    uint64_t seed = 0;
+    float dt = 1.0f / 60.0f;
+    uint32_t keyframeInterval = 600;
+    uint64_t startTick = 0;
+    uint64_t endTick = 0;  // Last recorded tick
+    std::vector<ReplayInput> inputs;
+    std::vector<ReplayKeyframe> keyframes;
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+    size_t keyframeBytes() const;
+};
+
+// Records inputs as they're applied to a live simulation.
+// Route every state-changing input through the recorder while recording.
+class ReplayRecorder {
+public:
+    explicit ReplayRecorder(uint32_t keyframeInterval = 600) { log.keyframeInterval = keyframeInterval; }
+
+    void begin(const Simulation& sim, float dt);  // Keyframes the current state
+    void end(const Simulation& sim);
+    bool isRecording() const { return recording; }
+    const ReplayLog& getLog() const { return log; }
+
+    // Apply to the simulation and log
+    void setAgentCount(Simulation& sim, size_t count);
+    void setPaused(Simulation& sim, bool paused);
+    void setTimeScale(const Simulation& sim, float timeScale);
+
+    // Keyframe every keyframeInterval ticks; logs governor quality changes
+    void afterTick(const Simulation& sim);
+
+private:
+    ReplayLog log;
+    bool recording = false;
+    uint64_t recordedQuality = 0;
+
+    void push(const Simulation& sim, ReplayInput::Kind kind, uint64_t value);
+    void keyframe(const Simulation& sim);
+};
+
+// Plays a log back. Seeking restores the nearest keyframe at or before the target
+// and re-simulates headlessly, or just runs forward when the target is ahead of
+// the current position.
+class ReplayPlayer {
+public:
+    void open(ReplayLog replay);
+    bool load(const std::string& path);
+    bool isOpen() const { return !log.keyframes.empty(); }
+    const ReplayLog& getLog() const { return log; }
+
+    // Leaves the simulation paused at min(targetTick, endTick). The governor is off
+    // while re-simulating; quality follows the recorded levels.
+    bool seek(Simulation& sim, uint64_t targetTick);
+
+    // Recorded pacing at a tick (for real-time playback)
+    float getTimeScaleAt(uint64_t tick, float fallback = 1.0f) const;
+
+    uint64_t getLastSeekTicks() const { return lastSeekTicks; }
+    float getLastSeekMs() const { return lastSeekMs; }
+
+private:
+    ReplayLog log;
+    Simulation* positioned = nullptr;  // Simulation currently on this log's timeline
+    uint64_t lastSeekTicks = 0;
+    float lastSeekMs = 0.0f;
+};
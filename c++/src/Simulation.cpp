@@ -1,75 +1,150 @@
 #include "platform.h"
 #include "Simulation.hpp"
+#include "AllocationCounter.hpp"
 #include <raylib.h>
 #include <cmath>
 #include <chrono>
+#include <cstring>
+#include <algorithm>
 #include "spdlog/spdlog.h"
 
-Simulation::Simulation(int w, int h)
-    : screenWidth(w), screenHeight(h)
-    , spatialHash(static_cast<float>(w), static_cast<float>(h), 50.0f)  // 50 pixel cells (Design Doc §5.1)
+namespace {
+// Streams for Simulation::workerRandom (one per random decision a worker can make)
+enum RandomStream : uint32_t {
+    StreamBuildingPushX = 0,
+    StreamBuildingPushY,
+    StreamTreePushX,
+    StreamTreePushY,
+    StreamFleeStrategy,
+    StreamAimDelay,
+    StreamPatrolX,
+    StreamPatrolY,
+    StreamHordeX,  // Keyed by the horde's first member
+    StreamHordeY,
+};
+
+// Streams for SpawnRandom (keyed by batch and index instead of tick and entity)
+enum SpawnStream : uint32_t {
+    SpawnPosX = 0,
+    SpawnPosY,
+    SpawnVelX,
+    SpawnVelY,
+    SpawnPatrolX,
+    SpawnPatrolY,
+    SpawnHeroKind,
+};
+
+// Agents per spawn job; filling is cheap so chunks are larger than the tick's
+constexpr size_t kSpawnChunkSize = 4096;
+
+// Rays per line-of-sight job, a whole number of visibility words
+constexpr uint32_t kRayChunkSize = 256;
+static_assert(kRayChunkSize % RayBatch::kRaysPerWord == 0);
+
+constexpr float kGunshotHearingRadius = 300.0f;  // Zombie gunshot attraction range
+
+// What the spatial grid counts per cell: living agents by type, corpses apart
+enum CellKind : uint8_t {
+    KindCivilian = static_cast<uint8_t>(AgentType::Civilian),
+    KindZombie = static_cast<uint8_t>(AgentType::Zombie),
+    KindHero = static_cast<uint8_t>(AgentType::Hero),
+    KindCorpse,
+};
+static_assert(KindCorpse < SpatialHash::kMaxKinds);
+
+constexpr uint32_t kindMask(CellKind kind) { return SpatialHash::kindBit(kind); }
+}
+
+Simulation::Simulation(const WorldConfig& worldConfig, uint32_t workerCount, bool pinWorkers)
+    : Simulation(worldConfig, std::make_unique<JobSystem>(workerCount, pinWorkers), nullptr)
+{
+}
+
+Simulation::Simulation(const WorldConfig& worldConfig, JobSystem& sharedJobs)
+    : Simulation(worldConfig, nullptr, &sharedJobs)
+{
+}
+
+Simulation::Simulation(const WorldConfig& worldConfig, std::unique_ptr<JobSystem> ownJobs, JobSystem* sharedJobs)
+    : world(worldConfig)
+    , spatialHash(worldConfig.width, worldConfig.height, worldConfig.cellSize, worldConfig.spatialMode)
+    , ownedJobSystem(std::move(ownJobs))
+    , jobSystem(sharedJobs ? *sharedJobs : *ownedJobSystem)
+{
+    // One arena per pool worker, plus one for whichever thread calls tick()
+    frameArenas.resize(jobSystem.getWorkerCount() + 1);
+}
+
+Simulation::Simulation(int w, int h, uint32_t workerCount)
+    : Simulation(WorldConfig{static_cast<float>(w), static_cast<float>(h)}, workerCount)
 {
-    neighborBuffer.reserve(200);  // Pre-allocate for typical neighbor count
 }
 
 void Simulation::init(size_t count) {
-    spdlog::info("Initializing {} agents with zombie simulation", count);
-    entities.reserve(count);
-    prevPosX.reserve(count);
-    prevPosY.reserve(count);
+    init(count, PopulationMix{});
+}
 
-    // Population distribution: 90% civilians, 5% zombies, 5% heroes
-    size_t civilianCount = static_cast<size_t>(count * 0.90f);
-    size_t zombieCount = static_cast<size_t>(count * 0.05f);
+void Simulation::init(size_t count, const PopulationMix& mix) {
+    spdlog::info("Initializing {} agents with zombie simulation", count);
+    populationMix = mix;
+    entities.ensureCapacity(entities.count + count);  // One growth for all three batches below
+    
+    // Population distribution: 90% civilians, 5% zombies, 5% heroes by default
+    size_t civilianCount = static_cast<size_t>(count * mix.civilians);
+    size_t zombieCount = static_cast<size_t>(count * mix.zombies);
     size_t heroCount = count - civilianCount - zombieCount;
+    const int worldW = static_cast<int>(world.width);
+    const int worldH = static_cast<int>(world.height);
 
     // Spawn civilians near buildings (residential areas)
-    for (size_t i = 0; i < civilianCount; i++) {
-        float px, py;
-        if (i < buildings.size() && !buildings.empty()) {
+    spawnBatch(civilianCount, [this, worldW, worldH](const SpawnRandom& r) {
+        SpawnParams p;
+        if (r.index < buildings.size() && !buildings.empty()) {
             // Spawn near a building
-            const auto& building = buildings[i % buildings.size()];
-            px = building.x + building.width / 2.0f + (float)GetRandomValue(-60, 60);
-            py = building.y + building.height / 2.0f + (float)GetRandomValue(-60, 60);
+            const auto& building = buildings[r.index % buildings.size()];
+            p.posX = building.x + building.width / 2.0f + (float)r.range(SpawnPosX, -60, 60);
+            p.posY = building.y + building.height / 2.0f + (float)r.range(SpawnPosY, -60, 60);
         } else {
-            px = (float)GetRandomValue(0, screenWidth);
-            py = (float)GetRandomValue(0, screenHeight);
+            p.posX = (float)r.range(SpawnPosX, 0, worldW);
+            p.posY = (float)r.range(SpawnPosY, 0, worldH);
         }
-        float vx = (float)GetRandomValue(-10, 10);
-        float vy = (float)GetRandomValue(-10, 10);
-        entities.spawn(px, py, vx, vy, AgentType::Civilian);
-        prevPosX.push_back(px);
-        prevPosY.push_back(py);
-    }
+        p.velX = (float)r.range(SpawnVelX, -10, 10);
+        p.velY = (float)r.range(SpawnVelY, -10, 10);
+        p.type = AgentType::Civilian;
+        return p;
+    });
     
     // Spawn zombies at graveyard (bottom-left area)
-    for (size_t i = 0; i < zombieCount; i++) {
-        float px = (float)GetRandomValue(50, 250);  // Graveyard zone
-        float py = (float)GetRandomValue(screenHeight - 250, screenHeight - 50);
-        float vx = (float)GetRandomValue(-8, 8);
-        float vy = (float)GetRandomValue(-8, 8);
-        entities.spawn(px, py, vx, vy, AgentType::Zombie);
-        prevPosX.push_back(px);
-        prevPosY.push_back(py);
-    }
+    spawnBatch(zombieCount, [worldH](const SpawnRandom& r) {
+        SpawnParams p;
+        p.posX = (float)r.range(SpawnPosX, 50, 250);  // Graveyard zone
+        p.posY = (float)r.range(SpawnPosY, worldH - 250, worldH - 50);
+        p.velX = (float)r.range(SpawnVelX, -8, 8);
+        p.velY = (float)r.range(SpawnVelY, -8, 8);
+        p.type = AgentType::Zombie;
+        return p;
+    });
     
     // Spawn heroes spread out (strategic positions)
-    for (size_t i = 0; i < heroCount; i++) {
+    spawnBatch(heroCount, [worldW](const SpawnRandom& r) {
         // Spread heroes around perimeter
-        float px = (float)GetRandomValue(screenWidth / 3, screenWidth * 2 / 3);
-        float py = (float)GetRandomValue(50, 200);  // Top area
-        float vx = (float)GetRandomValue(-12, 12);
-        float vy = (float)GetRandomValue(-12, 12);
-        entities.spawn(px, py, vx, vy, AgentType::Hero);
-        prevPosX.push_back(px);
-        prevPosY.push_back(py);
-    }
+        SpawnParams p;
+        p.posX = (float)r.range(SpawnPosX, worldW / 3, worldW * 2 / 3);
+        p.posY = (float)r.range(SpawnPosY, 50, 200);  // Top area
+        p.velX = (float)r.range(SpawnVelX, -12, 12);
+        p.velY = (float)r.range(SpawnVelY, -12, 12);
+        p.type = AgentType::Hero;
+        return p;
+    });
     
     // Calculate memory usage
-    size_t memoryPerEntity = sizeof(float) * 6 + sizeof(AgentType) + sizeof(uint8_t);  
+    size_t memoryPerEntity = getMemoryPerAgent();
     float totalMB = (memoryPerEntity * count) / (1024.0f * 1024.0f);
     spdlog::info("Memory usage: {:.2f} MB ({} bytes/entity)", totalMB, memoryPerEntity);
-    spdlog::info("Spatial grid: {} cells", spatialHash.getCellCount());
+    spdlog::info("World: {:.0f}x{:.0f}, spatial grid ({}): {} cells ({} allocated)",
+                 world.width, world.height,
+                 world.spatialMode == SpatialHashMode::Hashed ? "hashed" : "blocks",
+                 spatialHash.getCellCount(), spatialHash.getAllocatedCellCount());
     spdlog::info("Population - Civilians: {}, Zombies: {}, Heroes: {}", 
                  civilianCount, zombieCount, heroCount);
     
@@ -78,32 +153,270 @@ void Simulation::init(size_t count) {
     
     // Set graveyard bounds
     graveyard.x = 50;
-    graveyard.y = screenHeight - 250;
+    graveyard.y = world.height - 250;
     graveyard.width = 200;
     graveyard.height = 200;
 }
 
 void Simulation::generateObstacles() {
+    const int worldW = static_cast<int>(world.width);
+    const int worldH = static_cast<int>(world.height);
+    
+    // Density of the original 1280x720 map, capped: every agent still tests every obstacle
+    const float areaScale = std::clamp(world.width * world.height / (1280.0f * 720.0f), 1.0f, 4.0f);
+    
     // City blocks (buildings)
-    const int blockCount = 8;
+    const int blockCount = static_cast<int>(8 * areaScale);
     for (int i = 0; i < blockCount; i++) {
-        float x = (float)GetRandomValue(100, screenWidth - 200);
-        float y = (float)GetRandomValue(100, screenHeight - 200);
-        float w = (float)GetRandomValue(80, 150);
-        float h = (float)GetRandomValue(80, 150);
+        float x = (float)rng.range(100, worldW - 200);
+        float y = (float)rng.range(100, worldH - 200);
+        float w = (float)rng.range(80, 150);
+        float h = (float)rng.range(80, 150);
         buildings.push_back({x, y, w, h});
     }
     
     // Scattered trees
-    const int treeCount = 30;
+    const int treeCount = static_cast<int>(30 * areaScale);
     for (int i = 0; i < treeCount; i++) {
-        float x = (float)GetRandomValue(50, screenWidth - 50);
-        float y = (float)GetRandomValue(50, screenHeight - 50);
-        float r = (float)GetRandomValue(15, 25);
+        float x = (float)rng.range(50, worldW - 50);
+        float y = (float)rng.range(50, worldH - 50);
+        float r = (float)rng.range(15, 25);
         trees.push_back({x, y, r});
     }
     
     spdlog::info("Generated {} buildings and {} trees", buildings.size(), trees.size());
+    rebuildObstacleGrid();
+}
+
+void Simulation::rebuildObstacleGrid() {
+    std::vector<ObstacleGrid::Box> boxes;
+    std::vector<ObstacleGrid::Disc> discs;
+    for (const auto& building : buildings) {
+        boxes.push_back({building.x, building.y, building.width, building.height});
+    }
+    for (const auto& tree : trees) {
+        discs.push_back({tree.x, tree.y, tree.radius});
+    }
+    obstacleGrid.build(boxes, discs, world.width, world.height);
+}
+
+void Simulation::traceRays() {
+    losRays.resetVisibility();
+    const uint32_t count = losRays.size();
+    if (count <= kRayChunkSize) {
+        obstacleGrid.trace(losRays, 0, count);  // Not worth a job
+        return;
+    }
+    for (uint32_t start = 0; start < count; start += kRayChunkSize) {
+        submitJob([this, first = start, last = std::min(start + kRayChunkSize, count)]() {
+            obstacleGrid.trace(losRays, first, last);
+        });
+    }
+    waitJobs();
+}
+
+void Simulation::updateGunshotHearing(size_t first) {
+    gunshotHearing.resize(recentGunshots.size());
+    if (!lineOfSightEnabled) {
+        for (size_t g = first; g < gunshotHearing.size(); g++) {
+            std::fill(std::begin(gunshotHearing[g].audible), std::end(gunshotHearing[g].audible), ~uint64_t(0));
+        }
+        return;
+    }
+    
+    // A ray from the shot to every cell center; only buildings muffle sound
+    const float cellSize = 2.0f * kGunshotHearingRadius / kHearingCells;
+    losRays.clear();
+    losRays.mask = ObstacleGrid::KindBox;
+    for (size_t g = first; g < recentGunshots.size(); g++) {
+        const Gunshot& gunshot = recentGunshots[g];
+        const float originX = gunshot.x - kGunshotHearingRadius + 0.5f * cellSize;
+        const float originY = gunshot.y - kGunshotHearingRadius + 0.5f * cellSize;
+        for (uint32_t cy = 0; cy < kHearingCells; cy++) {
+            for (uint32_t cx = 0; cx < kHearingCells; cx++) {
+                losRays.add(gunshot.x, gunshot.y, originX + cx * cellSize, originY + cy * cellSize);
+            }
+        }
+    }
+    traceRays();
+    
+    // Each mask is a whole number of words, so they copy straight out of the batch
+    constexpr size_t kWords = std::size(GunshotHearing{}.audible);
+    static_assert(kHearingCells * kHearingCells == kWords * RayBatch::kRaysPerWord);
+    for (size_t g = first; g < recentGunshots.size(); g++) {
+        const uint64_t* words = losRays.visible.data() + (g - first) * kWords;
+        std::copy(words, words + kWords, gunshotHearing[g].audible);
+    }
+}
+
+bool Simulation::hearsGunshot(size_t gunshot, float x, float y) const {
+    const float cellsPerUnit = kHearingCells / (2.0f * kGunshotHearingRadius);
+    auto cell = [&](float v, float center) {
+        float c = std::floor((v - center + kGunshotHearingRadius) * cellsPerUnit);
+        return static_cast<uint32_t>(std::clamp(c, 0.0f, static_cast<float>(kHearingCells - 1)));
+    };
+    const uint32_t bit = cell(y, recentGunshots[gunshot].y) * kHearingCells + cell(x, recentGunshots[gunshot].x);
+    return (gunshotHearing[gunshot].audible[bit / 64] >> (bit % 64)) & 1u;
+}
+
+void Simulation::spawnBatch(size_t count, const SpawnGenerator& generator) {
+    if (count == 0) return;
+    
+    // Grow once: capacity jumps to a power of two, then resize value-initializes the
+    // new tail of every column (a memset), so only non-zero fields are written below
+    const size_t batchStart = entities.count;
+    const size_t newCount = batchStart + count;
+    entities.ensureCapacity(newCount);
+    entities.resize(newCount);
+    stateTimers.reserve(entities.capacity());  // Pending timers never outgrow the agents in practice
+    reserveAgentLists();
+    if (prevPosX.capacity() < newCount) {
+        prevPosX.reserve(entities.capacity());
+        prevPosY.reserve(entities.capacity());
+    }
+    prevPosX.resize(newCount);
+    prevPosY.resize(newCount);
+    
+    // One draw from the main stream keys the whole batch, so results don't depend on
+    // how the chunks below are scheduled
+    const uint64_t batchKey = rng.next();
+    for (size_t start = batchStart; start < newCount; start += kSpawnChunkSize) {
+        size_t end = std::min(start + kSpawnChunkSize, newCount);
+        submitJob([this, start, end, batchStart, batchKey, &generator]() {
+            fillSpawnChunk(start, end, batchStart, batchKey, generator);
+        });
+    }
+    waitJobs();
+}
+
+void Simulation::fillSpawnChunk(size_t start, size_t end, size_t batchStart, uint64_t batchKey,
+                                const SpawnGenerator& generator) {
+    // Columns the generator decides, written agent by agent
+    for (size_t i = start; i < end; i++) {
+        SpawnRandom random{batchKey, static_cast<uint32_t>(i - batchStart)};
+        SpawnParams p = generator(random);
+        entities.posX[i] = p.posX;
+        entities.posY[i] = p.posY;
+        entities.velX[i] = p.velX;
+        entities.velY[i] = p.velY;
+        entities.type[i] = p.type;
+        
+        // Random initial patrol target and hero personality (50% hunter, 50% defender)
+        entities.patrolTargetX[i] = patrolCoordinate(p.posX, world.width, random.range(SpawnPatrolX, -1000, 1000) / 1000.0f);
+        entities.patrolTargetY[i] = patrolCoordinate(p.posY, world.height, random.range(SpawnPatrolY, -1000, 1000) / 1000.0f);
+        entities.setHeroType(i, p.type == AgentType::Hero ? static_cast<uint8_t>(random.range(SpawnHeroKind, 0, 1)) : 0);
+    }
+    
+    // Derived and constant columns, one tight pass each
+    for (size_t i = start; i < end; i++) {
+        // Initial direction from velocity, facing right when (nearly) still
+        float vx = entities.velX[i];
+        float vy = entities.velY[i];
+        float speed = std::sqrt(vx * vx + vy * vy);
+        bool moving = speed > 0.01f;
+        entities.dirX[i] = moving ? vx / speed : 1.0f;
+        entities.dirY[i] = moving ? vy / speed : 0.0f;
+    }
+    for (size_t i = start; i < end; i++) {
+        AgentType t = entities.type[i];
+        entities.health[i] = t == AgentType::Hero ? 5 : (t == AgentType::Zombie ? 3 : 0);  // Heroes 5, Zombies 3, Civilians 0
+    }
+    std::fill(entities.state.begin() + start, entities.state.begin() + end, AgentState::Patrol);
+    std::fill(entities.combatTarget.begin() + start, entities.combatTarget.begin() + end, UINT32_MAX);  // No target
+    // Due on the first tick; a zero would read as 32k ticks ahead for 16-bit think ticks
+    std::fill(entities.nextThinkTick.begin() + start, entities.nextThinkTick.begin() + end,
+              static_cast<ThinkTick>(timerNow()));
+    std::copy(entities.posX.begin() + start, entities.posX.begin() + end, prevPosX.begin() + start);
+    std::copy(entities.posY.begin() + start, entities.posY.begin() + end, prevPosY.begin() + start);
+}
+
+void Simulation::removeEntity(size_t idx) {
+    size_t last = entities.count - 1;
+    unlistState(idx);
+    entities.swapRemove(idx);
+    if (idx != last) {
+        prevPosX[idx] = prevPosX[last];
+        prevPosY[idx] = prevPosY[last];
+        
+        // The moved agent keeps its list slot but now lives at idx
+        int list = stateListOf(entities.state[idx]);
+        if (list >= 0) {
+            stateLists[list][entities.stateSlot[idx]] = static_cast<uint32_t>(idx);
+        }
+        
+        // The moved agent's pending timer was scheduled under its old index
+        int32_t ahead = static_cast<int32_t>(entities.stateDeadline[idx] - timerNow());
+        if (hasStateTimer(idx) && ahead >= 0) {
+            stateTimers.schedule(static_cast<uint32_t>(idx), tickCount + ahead, tickCount);
+        }
+    }
+    prevPosX.pop_back();
+    prevPosY.pop_back();
+}
+
+void Simulation::startStateTimer(size_t i, float seconds) {
+    uint32_t deadline = ticksFromNow(seconds);
+    entities.stateDeadline[i] = deadline;
+    stateTimers.schedule(static_cast<uint32_t>(i), tickCount + (deadline - timerNow()), tickCount);
+}
+
+void Simulation::setState(size_t i, AgentState s) {
+    if (stateListOf(entities.state[i]) == stateListOf(s)) {
+        entities.state[i] = s;
+        return;
+    }
+    unlistState(i);
+    entities.state[i] = s;
+    int list = stateListOf(s);
+    if (list >= 0) {
+        entities.stateSlot[i] = static_cast<uint32_t>(stateLists[list].size());
+        stateLists[list].push_back(static_cast<uint32_t>(i));
+    }
+}
+
+void Simulation::unlistState(size_t i) {
+    int list = stateListOf(entities.state[i]);
+    if (list < 0) return;
+    auto& members = stateLists[list];
+    uint32_t slot = entities.stateSlot[i];
+    uint32_t moved = members.back();
+    members[slot] = moved;
+    entities.stateSlot[moved] = slot;
+    members.pop_back();
+}
+
+void Simulation::reserveAgentLists() {
+    // Any one list can hold every agent; a no-op unless capacity grew
+    for (auto& members : stateLists) members.reserve(entities.capacity());
+    for (auto& agents : behaviorLists) agents.reserve(entities.capacity());
+}
+
+void Simulation::rebuildStateLists() {
+    for (auto& members : stateLists) members.clear();
+    reserveAgentLists();
+    for (size_t i = 0; i < entities.count; i++) {
+        int list = stateListOf(entities.state[i]);
+        if (list >= 0) {
+            entities.stateSlot[i] = static_cast<uint32_t>(stateLists[list].size());
+            stateLists[list].push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+void Simulation::rebuildStateTimers() {
+    stateTimers.clear();
+    stateTimers.reserve(entities.capacity());
+    for (size_t i = 0; i < entities.count; i++) {
+        int32_t ahead = static_cast<int32_t>(entities.stateDeadline[i] - timerNow());
+        if (hasStateTimer(i) && ahead >= 0) {
+            stateTimers.schedule(static_cast<uint32_t>(i), tickCount + ahead, tickCount);
+        }
+    }
+}
+
+float Simulation::getInfectionProgress(size_t i) const {
+    if (entities.state[i] != AgentState::Bitten) return 0.0f;
+    return 1.0f - std::max(0.0f, secondsUntil(entities.stateDeadline[i]) / 15.0f);
 }
 
 void Simulation::setAgentCount(size_t count) {
@@ -112,54 +425,35 @@ void Simulation::setAgentCount(size_t count) {
     if (count > entities.count) {
         // Add more agents with proper distribution
         size_t toAdd = count - entities.count;
-        size_t civiliansToAdd = static_cast<size_t>(toAdd * 0.90f);
-        size_t zombiesToAdd = static_cast<size_t>(toAdd * 0.05f);
+        size_t civiliansToAdd = static_cast<size_t>(toAdd * populationMix.civilians);
+        size_t zombiesToAdd = static_cast<size_t>(toAdd * populationMix.zombies);
         size_t heroesToAdd = toAdd - civiliansToAdd - zombiesToAdd;
+        const int worldW = static_cast<int>(world.width);
+        const int worldH = static_cast<int>(world.height);
         
-        for (size_t i = 0; i < civiliansToAdd; i++) {
-            float px = (float)GetRandomValue(0, screenWidth);
-            float py = (float)GetRandomValue(0, screenHeight);
-            float vx = (float)GetRandomValue(-20, 20);
-            float vy = (float)GetRandomValue(-20, 20);
-            entities.spawn(px, py, vx, vy, AgentType::Civilian);
-            prevPosX.push_back(px);
-            prevPosY.push_back(py);
-        }
-        
-        for (size_t i = 0; i < zombiesToAdd; i++) {
-            float px = (float)GetRandomValue(0, screenWidth);
-            float py = (float)GetRandomValue(0, screenHeight);
-            float vx = (float)GetRandomValue(-15, 15);
-            float vy = (float)GetRandomValue(-15, 15);
-            entities.spawn(px, py, vx, vy, AgentType::Zombie);
-            prevPosX.push_back(px);
-            prevPosY.push_back(py);
-        }
-        
-        for (size_t i = 0; i < heroesToAdd; i++) {
-            float px = (float)GetRandomValue(0, screenWidth);
-            float py = (float)GetRandomValue(0, screenHeight);
-            float vx = (float)GetRandomValue(-25, 25);
-            float vy = (float)GetRandomValue(-25, 25);
-            entities.spawn(px, py, vx, vy, AgentType::Hero);
-            prevPosX.push_back(px);
-            prevPosY.push_back(py);
-        }
-        spdlog::info("Added {} agents (total: {})", toAdd, entities.count);
+        // Uniform over the world; velocity range per type
+        auto uniform = [worldW, worldH](const SpawnRandom& r, int speed, AgentType agentType) {
+            SpawnParams p;
+            p.posX = (float)r.range(SpawnPosX, 0, worldW);
+            p.posY = (float)r.range(SpawnPosY, 0, worldH);
+            p.velX = (float)r.range(SpawnVelX, -speed, speed);
+            p.velY = (float)r.range(SpawnVelY, -speed, speed);
+            p.type = agentType;
+            return p;
+        };
+        auto spawnStart = std::chrono::steady_clock::now();
+        spawnBatch(civiliansToAdd, [&uniform](const SpawnRandom& r) { return uniform(r, 20, AgentType::Civilian); });
+        spawnBatch(zombiesToAdd, [&uniform](const SpawnRandom& r) { return uniform(r, 15, AgentType::Zombie); });
+        spawnBatch(heroesToAdd, [&uniform](const SpawnRandom& r) { return uniform(r, 25, AgentType::Hero); });
+        float spawnMs = std::chrono::duration<float>(std::chrono::steady_clock::now() - spawnStart).count() * 1000.0f;
+        spdlog::info("Added {} agents in {:.1f} ms (total: {})", toAdd, spawnMs, entities.count);
     } else {
         // Remove agents
         size_t toRemove = entities.count - count;
-        entities.count = count;
-        entities.posX.resize(count);
-        entities.posY.resize(count);
-        entities.velX.resize(count);
-        entities.velY.resize(count);
-        entities.dirX.resize(count);
-        entities.dirY.resize(count);
-        entities.type.resize(count);
-        entities.health.resize(count);
+        entities.resize(count);
         prevPosX.resize(count);
         prevPosY.resize(count);
+        rebuildStateLists();
         spdlog::info("Removed {} agents (total: {})", toRemove, entities.count);
     }
 }
@@ -167,21 +461,38 @@ void Simulation::setAgentCount(size_t count) {
 void Simulation::tick(float dt) {
     if (paused) return;  // Skip tick if paused
     
+    using Clock = std::chrono::steady_clock;
+    auto msSince = [](Clock::time_point from) {
+        return std::chrono::duration<float>(Clock::now() - from).count() * 1000.0f;
+    };
+    auto tickStart = Clock::now();
+    tickEvents = TickEvents{};
+    stepDt = dt;
+    const QualityLevel quality = governor.getLevel();
+    behaviorNeighborCap = quality >= QualityLevel::ReducedQueries ? 48u : UINT32_MAX;
+    separationNeighborCap = quality >= QualityLevel::ReducedQueries ? 12u : UINT32_MAX;
+    coarseSeparation = quality >= QualityLevel::CoarseSeparation;
+    AllocationCounter::trackCurrentThread();
+    const uint64_t allocationsAtStart = AllocationCounter::getCount();
+    
     // Store previous positions for interpolation
     for (size_t i = 0; i < entities.count; i++) {
         prevPosX[i] = entities.posX[i];
         prevPosY[i] = entities.posY[i];
     }
     
-    // Update gunshot lifetimes and remove expired ones
-    for (auto it = recentGunshots.begin(); it != recentGunshots.end();) {
-        it->lifetime -= dt;
-        if (it->lifetime <= 0.0f) {
-            it = recentGunshots.erase(it);
-        } else {
-            ++it;
+    // Update gunshot lifetimes and remove expired ones, with their hearing masks
+    size_t keptGunshots = 0;
+    for (size_t g = 0; g < recentGunshots.size(); g++) {
+        recentGunshots[g].lifetime -= dt;
+        if (recentGunshots[g].lifetime > 0.0f) {
+            recentGunshots[keptGunshots] = recentGunshots[g];
+            gunshotHearing[keptGunshots] = gunshotHearing[g];
+            keptGunshots++;
         }
     }
+    recentGunshots.resize(keptGunshots);
+    gunshotHearing.resize(keptGunshots);
     
     // Update gunshot line visuals (fade quickly)
     for (auto it = gunshotLines.begin(); it != gunshotLines.end();) {
@@ -194,18 +505,48 @@ void Simulation::tick(float dt) {
     }
     
     // Process ranged kills from heroes (collect from behavior chunk)
-    std::vector<size_t> zombiesToKill;
+    ArenaVector<size_t> zombiesToKill = makeArenaVector<size_t>(frameArena());
+    auto isShooting = [this](size_t i) {
+        return entities.type[i] == AgentType::Hero && !entities.ghost[i] &&
+               entities.state[i] == AgentState::Pursuing &&
+               entities.shootCooldown[i] > 1.45f;  // Just shot (cooldown near max)
+    };
+    
+    // Line of fire of every shot as one batch. Shots resolve below in the same order
+    // and re-check everything, since an earlier shot can turn its shooter.
+    ArenaVector<uint32_t> shooters = makeArenaVector<uint32_t>(frameArena());
+    losRays.clear();
+    losRays.mask = ObstacleGrid::KindBox | ObstacleGrid::KindDisc;
     for (size_t i = 0; i < entities.count; i++) {
-        if (entities.type[i] == AgentType::Hero && 
-            entities.state[i] == AgentState::Pursuing &&
-            entities.shootCooldown[i] > 1.45f) {  // Just shot (cooldown near max)
-            
+        if (!isShooting(i)) continue;
+        size_t shooterIdx = (size_t)entities.lastSeenX[i];
+        size_t targetIdx = (size_t)entities.lastSeenY[i];
+        if (shooterIdx < entities.count && targetIdx < entities.count) {
+            shooters.push_back(static_cast<uint32_t>(i));
+            losRays.add(entities.posX[shooterIdx], entities.posY[shooterIdx],
+                        entities.posX[targetIdx], entities.posY[targetIdx]);
+        }
+    }
+    const bool occludeShots = lineOfSightEnabled && !shooters.empty();
+    if (occludeShots) traceRays();
+    
+    const size_t firstNewGunshot = recentGunshots.size();
+    for (uint32_t shot = 0; shot < shooters.size(); shot++) {
+        const size_t i = shooters[shot];
+        if (isShooting(i)) {
             // Decode shooter and target from lastSeen hack
             size_t shooterIdx = (size_t)entities.lastSeenX[i];
             size_t targetIdx = (size_t)entities.lastSeenY[i];
             
             if (shooterIdx < entities.count && targetIdx < entities.count &&
-                entities.type[targetIdx] == AgentType::Zombie) {
+                entities.type[targetIdx] == AgentType::Zombie && !entities.ghost[targetIdx]) {
+                
+                // No clear line: hold fire and aim again shortly
+                if (occludeShots && !losRays.isVisible(shot)) {
+                    entities.shootCooldown[i] = 0.25f;
+                    tickEvents.shotsBlocked++;
+                    continue;
+                }
                 
                 float heroX = entities.posX[shooterIdx];
                 float heroY = entities.posY[shooterIdx];
@@ -214,6 +555,7 @@ void Simulation::tick(float dt) {
                 
                 // Create gunshot sound marker
                 recentGunshots.push_back({heroX, heroY, 3.0f});
+                tickEvents.shotsFired++;
                 
                 // Create visual line
                 gunshotLines.push_back({heroX, heroY, zombieX, zombieY, 0.15f});
@@ -224,6 +566,7 @@ void Simulation::tick(float dt) {
                     if (entities.health[targetIdx] == 0) {
                         // Zombie dies after 3 hits
                         zombiesToKill.push_back(targetIdx);
+                        tickEvents.zombiesShot++;
                     }
                 }
                 
@@ -232,106 +575,113 @@ void Simulation::tick(float dt) {
                     entities.health[shooterIdx]--;
                     if (entities.health[shooterIdx] == 0) {
                         entities.type[shooterIdx] = AgentType::Zombie;
+                        thinkNow(shooterIdx);  // Re-evaluate as a zombie next tick
                         entities.health[shooterIdx] = 3;  // New zombie has 3 health
-                        spdlog::info("Hero {} exhausted after 5 kills, turned zombie!", shooterIdx);
+                        tickEvents.heroesTurned++;
+                        eventLog.emit(EventKind::HeroExhausted, tickCount, static_cast<uint32_t>(shooterIdx));
                     }
                 }
             }
         }
     }
     
+    updateGunshotHearing(firstNewGunshot);
+    
     // Remove killed zombies
     std::sort(zombiesToKill.begin(), zombiesToKill.end(), std::greater<size_t>());
     for (size_t idx : zombiesToKill) {
-        // Remove by swapping with last and popping
-        if (idx < entities.count - 1) {
-            size_t last = entities.count - 1;
-            entities.posX[idx] = entities.posX[last];
-            entities.posY[idx] = entities.posY[last];
-            entities.velX[idx] = entities.velX[last];
-            entities.velY[idx] = entities.velY[last];
-            entities.dirX[idx] = entities.dirX[last];
-            entities.dirY[idx] = entities.dirY[last];
-            entities.type[idx] = entities.type[last];
-            entities.state[idx] = entities.state[last];
-            entities.health[idx] = entities.health[last];
-            entities.lastSeenX[idx] = entities.lastSeenX[last];
-            entities.lastSeenY[idx] = entities.lastSeenY[last];
-            entities.searchTimer[idx] = entities.searchTimer[last];
-            entities.patrolTargetX[idx] = entities.patrolTargetX[last];
-            entities.patrolTargetY[idx] = entities.patrolTargetY[last];
-            entities.shootCooldown[idx] = entities.shootCooldown[last];
-            entities.aimTimer[idx] = entities.aimTimer[last];
-            entities.fleeStrategy[idx] = entities.fleeStrategy[last];
-            entities.heroType[idx] = entities.heroType[last];
-            prevPosX[idx] = prevPosX[last];
-            prevPosY[idx] = prevPosY[last];
-        }
-        entities.posX.pop_back();
-        entities.posY.pop_back();
-        entities.velX.pop_back();
-        entities.velY.pop_back();
-        entities.dirX.pop_back();
-        entities.dirY.pop_back();
-        entities.type.pop_back();
-        entities.state.pop_back();
-        entities.health.pop_back();
-        entities.lastSeenX.pop_back();
-        entities.lastSeenY.pop_back();
-        entities.searchTimer.pop_back();
-        entities.patrolTargetX.pop_back();
-        entities.patrolTargetY.pop_back();
-        entities.shootCooldown.pop_back();
-        entities.aimTimer.pop_back();
-        entities.fleeStrategy.pop_back();
-        entities.heroType.pop_back();
-        prevPosX.pop_back();
-        prevPosY.pop_back();
-        entities.count--;
+        removeEntity(idx);
     }
+    lastPhaseTimes.housekeeping = msSince(tickStart);
     
     // Rebuild spatial hash (Design Doc §5.3)
     rebuildSpatialHash();
+    lastPhaseTimes.spatialHash = lastSpatialHashTime;
     
     // Reset job counter for metrics
-    jobSystem.resetJobCounter();
+    tickJobs.resetJobCounter();
+    
+    // Hordes steer as a whole before anyone else moves; members sit out the next two phases
+    auto phaseStart = Clock::now();
+    updateHordes();
+    const float hordeTime = msSince(phaseStart);
     
     // Update behaviors in parallel (Design Doc §6.2)
-    updateSeparation(dt);  // Collision avoidance using spatial queries
-    updateBehaviors(dt);   // Seek/flee/combat behaviors for zombie simulation
-    updateMovement(dt);    // Apply velocities
+    if (fusedPipeline) {
+        phaseStart = Clock::now();
+        updateFused();
+        lastPhaseTimes.separation = 0.0f;
+        lastPhaseTimes.behaviors = hordeTime + msSince(phaseStart);
+        lastPhaseTimes.movement = 0.0f;
+    } else {
+        phaseStart = Clock::now();
+        updateSeparation();  // Collision avoidance using spatial queries
+        lastPhaseTimes.separation = msSince(phaseStart);
+        
+        phaseStart = Clock::now();
+        updateBehaviors();   // Seek/flee/combat behaviors for zombie simulation
+        lastPhaseTimes.behaviors = hordeTime + msSince(phaseStart);
+        
+        phaseStart = Clock::now();
+        updateMovement();    // Apply velocities
+        lastPhaseTimes.movement = msSince(phaseStart);
+    }
     
     // Process infections (main thread, requires state changes)
+    phaseStart = Clock::now();
     updateInfections();
+    lastPhaseTimes.infections = msSince(phaseStart);
     
     // Screen wrapping
+    phaseStart = Clock::now();
     screenWrap();
+    lastPhaseTimes.screenWrap = msSince(phaseStart);
+    
+    tickCount++;
+    simTime += dt;
+    
+    // All chunk jobs have finished, so every arena can rewind
+    for (auto& arena : frameArenas) {
+        arena.reset();
+    }
+    lastTickAllocations = AllocationCounter::getCount() - allocationsAtStart;
+    lastPhaseTimes.total = msSince(tickStart);
+    
+    if (governor.record(lastPhaseTimes.total)) {
+        spdlog::info("Tick {}: quality now {} ({:.1f} ms average, budget {:.1f} ms)", tickCount,
+                     qualityLevelName(governor.getLevel()), governor.getSmoothedMs(), governor.getBudget());
+    }
 }
 
 void Simulation::rebuildSpatialHash() {
     auto start = std::chrono::steady_clock::now();
     
-    spatialHash.clear();
+    // Per-agent cell kind, so the grid also builds its per-cell summaries
+    FrameArena& arena = frameArena();
+    ArenaScope scope(arena);
+    ArenaVector<uint8_t> kinds = makeArenaVector<uint8_t>(arena, entities.count);
+    kinds.resize(entities.count);
     for (size_t i = 0; i < entities.count; i++) {
-        spatialHash.insert(static_cast<uint32_t>(i), entities.posX[i], entities.posY[i]);
+        kinds[i] = entities.state[i] == AgentState::Dead ? static_cast<uint8_t>(KindCorpse) : static_cast<uint8_t>(entities.type[i]);
     }
+    spatialHash.build(entities.posX.data(), entities.posY.data(), entities.count, kinds.data());
     
     auto end = std::chrono::steady_clock::now();
     lastSpatialHashTime = std::chrono::duration<float>(end - start).count() * 1000.0f;  // ms
 }
 
-void Simulation::updateSeparation(float dt) {
+void Simulation::updateSeparation() {
     // Parallelize collision avoidance (Design Doc §6.2)
-    const size_t chunkSize = 256;  // Job granularity
+    const size_t chunkSize = agentChunkSize;  // Job granularity
     
     for (size_t start = 0; start < entities.count; start += chunkSize) {
         size_t end = std::min(start + chunkSize, entities.count);
-        jobSystem.submit([this, start, end, dt]() {
-            updateSeparationChunk(start, end, dt);
-        });
+        submitChunk([this, first = static_cast<uint32_t>(start), last = static_cast<uint32_t>(end)]() {
+            updateSeparationChunk(first, last, stepDt);
+        }, start);
     }
     
-    jobSystem.waitAll();  // Barrier (Design Doc §6.3)
+    waitJobs();  // Barrier (Design Doc §6.3)
 }
 
 void Simulation::updateSeparationChunk(size_t start, size_t end, float dt) {
@@ -340,16 +690,23 @@ void Simulation::updateSeparationChunk(size_t start, size_t end, float dt) {
     const float separationStrength = 300.0f;  // Increased from 200
     const float separationRadiusSq = separationRadius * separationRadius;
     
-    // Thread-local neighbor buffer
-    std::vector<uint32_t> localNeighbors;
-    localNeighbors.reserve(200);
+    // Neighbor buffer from this worker's arena, released when the chunk ends
+    FrameArena& arena = frameArena();
+    ArenaScope scope(arena);
+    ArenaVector<uint32_t> localNeighbors = makeArenaVector<uint32_t>(arena, 200);
     
     for (size_t i = start; i < end; i++) {
+        if (entities.state[i] == AgentState::Dead) continue;  // Corpses stay put
+        if (entities.horde[i] != 0) continue;  // Horde members keep their spacing
+        if (entities.ghost[i]) continue;  // Pushed by its own region
+        if (coarseSeparation && ((i + tickCount) & 1)) continue;  // Other half's turn
+        
         float px = entities.posX[i];
         float py = entities.posY[i];
         
         // Query nearby neighbors (Design Doc §5.4)
         spatialHash.queryNeighbors(px, py, separationRadius, localNeighbors);
+        if (localNeighbors.size() > separationNeighborCap) localNeighbors.resize(separationNeighborCap);
         
         float steerX = 0.0f;
         float steerY = 0.0f;
@@ -358,8 +715,8 @@ void Simulation::updateSeparationChunk(size_t start, size_t end, float dt) {
         for (uint32_t neighborIdx : localNeighbors) {
             if (neighborIdx == i) continue;  // Skip self
             
-            float dx = px - entities.posX[neighborIdx];
-            float dy = py - entities.posY[neighborIdx];
+            float dx = px - prevPosX[neighborIdx];
+            float dy = py - prevPosY[neighborIdx];
             float distSq = dx * dx + dy * dy;
             
             if (distSq < separationRadiusSq && distSq > 0.01f) {
@@ -385,8 +742,8 @@ void Simulation::updateSeparationChunk(size_t start, size_t end, float dt) {
             if (distSq < obstacleAvoidDist * obstacleAvoidDist) {
                 if (distSq < 0.01f) {
                     // Inside obstacle - push out strongly in any direction
-                    steerX += (GetRandomValue(-10, 10) > 0 ? 1.0f : -1.0f) * 10.0f;
-                    steerY += (GetRandomValue(-10, 10) > 0 ? 1.0f : -1.0f) * 10.0f;
+                    steerX += (workerRandom(i, StreamBuildingPushX, -10, 10) > 0 ? 1.0f : -1.0f) * 10.0f;
+                    steerY += (workerRandom(i, StreamBuildingPushY, -10, 10) > 0 ? 1.0f : -1.0f) * 10.0f;
                 } else {
                     float dist = std::sqrt(distSq);
                     float force = (obstacleAvoidDist - dist) / obstacleAvoidDist;
@@ -406,8 +763,8 @@ void Simulation::updateSeparationChunk(size_t start, size_t end, float dt) {
             if (distSq < avoidRadius * avoidRadius) {
                 if (distSq < 0.01f) {
                     // Inside obstacle - push out strongly
-                    steerX += (GetRandomValue(-10, 10) > 0 ? 1.0f : -1.0f) * 10.0f;
-                    steerY += (GetRandomValue(-10, 10) > 0 ? 1.0f : -1.0f) * 10.0f;
+                    steerX += (workerRandom(i, StreamTreePushX, -10, 10) > 0 ? 1.0f : -1.0f) * 10.0f;
+                    steerY += (workerRandom(i, StreamTreePushY, -10, 10) > 0 ? 1.0f : -1.0f) * 10.0f;
                 } else {
                     float dist = std::sqrt(distSq);
                     float force = (avoidRadius - dist) / avoidRadius;
@@ -417,9 +774,10 @@ void Simulation::updateSeparationChunk(size_t start, size_t end, float dt) {
             }
         }
         
-        // Apply separation steering
-        entities.velX[i] += steerX * separationStrength * dt;
-        entities.velY[i] += steerY * separationStrength * dt;
+        // Apply separation steering (coarse: covers this tick and the skipped one)
+        const float strength = coarseSeparation ? 2.0f * separationStrength : separationStrength;
+        entities.velX[i] += steerX * strength * dt;
+        entities.velY[i] += steerY * strength * dt;
         
         // Limit velocity
         const float maxSpeed = 150.0f;
@@ -432,75 +790,49 @@ void Simulation::updateSeparationChunk(size_t start, size_t end, float dt) {
     }
 }
 
-void Simulation::updateMovement(float dt) {
+void Simulation::updateMovement() {
     // Parallelize movement integration (Design Doc §6.2)
-    const size_t chunkSize = 256;
+    const size_t chunkSize = agentChunkSize;
     
     for (size_t start = 0; start < entities.count; start += chunkSize) {
         size_t end = std::min(start + chunkSize, entities.count);
-        jobSystem.submit([this, start, end, dt]() {
-            updateMovementChunk(start, end, dt);
-        });
+        submitChunk([this, first = static_cast<uint32_t>(start), last = static_cast<uint32_t>(end)]() {
+            updateMovementChunk(first, last, stepDt);
+        }, start);
     }
     
-    jobSystem.waitAll();  // Barrier
+    waitJobs();  // Barrier
 }
 
 void Simulation::updateMovementChunk(size_t start, size_t end, float dt) {
     // SIMD-friendly: compiler auto-vectorizes this loop
     for (size_t i = start; i < end; i++) {
+        if (entities.state[i] == AgentState::Dead) continue;  // Corpses stay put
+        if (entities.ghost[i]) continue;
+        
         float newX = entities.posX[i] + entities.velX[i] * dt;
         float newY = entities.posY[i] + entities.velY[i] * dt;
         
-        // Check collision with buildings
-        bool blocked = false;
-        for (const auto& building : buildings) {
-            if (newX > building.x - 5 && newX < building.x + building.width + 5 &&
-                newY > building.y - 5 && newY < building.y + building.height + 5) {
-                // Inside or very close to building - block movement
-                blocked = true;
-                // Find which side we hit
-                float centerX = building.x + building.width / 2.0f;
-                float centerY = building.y + building.height / 2.0f;
-                float dx = entities.posX[i] - centerX;
-                float dy = entities.posY[i] - centerY;
-                
-                // Push out and deflect velocity
-                if (std::abs(dx) > std::abs(dy)) {
-                    // Hit horizontal side - deflect horizontally, keep Y velocity
-                    newX = entities.posX[i] + (dx > 0 ? 2.0f : -2.0f);
-                    entities.velX[i] = -entities.velX[i] * 0.3f;  // Bounce back weakly
-                    // Keep Y velocity to slide along wall
-                } else {
-                    // Hit vertical side - deflect vertically, keep X velocity
-                    newY = entities.posY[i] + (dy > 0 ? 2.0f : -2.0f);
-                    entities.velY[i] = -entities.velY[i] * 0.3f;  // Bounce back weakly
-                    // Keep X velocity to slide along wall
-                }
-                break;
+        // Horde members only test the obstacles updateHordes() found around their horde
+        const uint32_t horde = entities.horde[i];
+        if (horde == 0) {
+            bool blocked = false;
+            for (const auto& building : buildings) {
+                if ((blocked = collideBuilding(i, building, newX, newY))) break;
             }
-        }
-        
-        // Check collision with trees
-        if (!blocked) {
-            for (const auto& tree : trees) {
-                float dx = newX - tree.x;
-                float dy = newY - tree.y;
-                float distSq = dx * dx + dy * dy;
-                if (distSq < tree.radius * tree.radius) {
-                    // Inside tree - block and push out
-                    blocked = true;
-                    float dist = std::sqrt(distSq + 0.01f);
-                    newX = tree.x + (dx / dist) * (tree.radius + 2.0f);
-                    newY = tree.y + (dy / dist) * (tree.radius + 2.0f);
-                    // Deflect velocity tangentially (slide around)
-                    float normalX = dx / dist;
-                    float normalY = dy / dist;
-                    float velDotNormal = entities.velX[i] * normalX + entities.velY[i] * normalY;
-                    entities.velX[i] -= normalX * velDotNormal * 1.5f;  // Remove normal component
-                    entities.velY[i] -= normalY * velDotNormal * 1.5f;
-                    break;
-                }
+            for (size_t t = 0; !blocked && t < trees.size(); t++) {
+                blocked = collideTree(i, trees[t], newX, newY);
+            }
+        } else {
+            const Horde& h = hordes[horde - 1];
+            const uint32_t* nearby = hordeObstacles.data() + h.obstacleFirst;
+            bool blocked = false;
+            for (uint32_t b = 0; b < h.nearBuildings; b++) {
+                if ((blocked = collideBuilding(i, buildings[nearby[b]], newX, newY))) break;
+            }
+            nearby += h.nearBuildings;
+            for (uint32_t t = 0; !blocked && t < h.nearTrees; t++) {
+                blocked = collideTree(i, trees[nearby[t]], newX, newY);
             }
         }
         
@@ -517,9 +849,56 @@ void Simulation::updateMovementChunk(size_t start, size_t end, float dt) {
     }
 }
 
+bool Simulation::collideBuilding(size_t i, const Building& building, float& newX, float& newY) {
+    if (newX > building.x - 5 && newX < building.x + building.width + 5 &&
+        newY > building.y - 5 && newY < building.y + building.height + 5) {
+        // Inside or very close to building - block movement
+        // Find which side we hit
+        float centerX = building.x + building.width / 2.0f;
+        float centerY = building.y + building.height / 2.0f;
+        float dx = entities.posX[i] - centerX;
+        float dy = entities.posY[i] - centerY;
+        
+        // Push out and deflect velocity
+        if (std::abs(dx) > std::abs(dy)) {
+            // Hit horizontal side - deflect horizontally, keep Y velocity
+            newX = entities.posX[i] + (dx > 0 ? 2.0f : -2.0f);
+            entities.velX[i] = -entities.velX[i] * 0.3f;  // Bounce back weakly
+            // Keep Y velocity to slide along wall
+        } else {
+            // Hit vertical side - deflect vertically, keep X velocity
+            newY = entities.posY[i] + (dy > 0 ? 2.0f : -2.0f);
+            entities.velY[i] = -entities.velY[i] * 0.3f;  // Bounce back weakly
+            // Keep X velocity to slide along wall
+        }
+        return true;
+    }
+    return false;
+}
+
+bool Simulation::collideTree(size_t i, const Tree& tree, float& newX, float& newY) {
+    float dx = newX - tree.x;
+    float dy = newY - tree.y;
+    float distSq = dx * dx + dy * dy;
+    if (distSq < tree.radius * tree.radius) {
+        // Inside tree - block and push out
+        float dist = std::sqrt(distSq + 0.01f);
+        newX = tree.x + (dx / dist) * (tree.radius + 2.0f);
+        newY = tree.y + (dy / dist) * (tree.radius + 2.0f);
+        // Deflect velocity tangentially (slide around)
+        float normalX = dx / dist;
+        float normalY = dy / dist;
+        float velDotNormal = entities.velX[i] * normalX + entities.velY[i] * normalY;
+        entities.velX[i] -= normalX * velDotNormal * 1.5f;  // Remove normal component
+        entities.velY[i] -= normalY * velDotNormal * 1.5f;
+        return true;
+    }
+    return false;
+}
+
 void Simulation::screenWrap() {
-    const float w = static_cast<float>(screenWidth);
-    const float h = static_cast<float>(screenHeight);
+    const float w = world.width;
+    const float h = world.height;
     const float damping = 0.5f; // Bounce damping factor
     
     for (size_t i = 0; i < entities.count; i++) {
@@ -546,6 +925,10 @@ void Simulation::screenWrap() {
     }
 }
 
+size_t Simulation::getMemoryPerAgent() const {
+    return entities.bytesPerEntity() + sizeof(float) * 2;  // + prevPosX/prevPosY
+}
+
 uint32_t Simulation::getMaxCellOccupancy() const {
     return spatialHash.getMaxOccupancy();
 }
@@ -574,518 +957,970 @@ size_t Simulation::getHeroCount() const {
     return count;
 }
 
-void Simulation::updateBehaviors(float dt) {
-    // Parallelize behavior updates
-    const size_t chunkSize = 256;
-    
-    for (size_t start = 0; start < entities.count; start += chunkSize) {
-        size_t end = std::min(start + chunkSize, entities.count);
-        jobSystem.submit([this, start, end, dt]() {
-            updateBehaviorsChunk(start, end, dt);
-        });
-    }
-    
-    jobSystem.waitAll();
+// Per-type behavior (Design Doc §6.2). Each type's decision logic is its own
+// specialization and the shared steering tail is instantiated into every kernel, so
+// each kernel is a small loop over one type's list with its constants folded in and
+// no per-agent branching on type or on the list-managed states.
+//
+// The neighbor scan is gated by the grid's cell summaries: an agent only scans when
+// a kind it reacts to (kTargets) is in its 3x3 cells, and then only the cells holding
+// a kind it reads (kScanned). Horde and squad cohesion use the summed cell positions.
+namespace {
+template <AgentType T> struct BehaviorTraits;
+template <> struct BehaviorTraits<AgentType::Civilian> {
+    static constexpr float kSpeed = 40.0f;  // (was 60)
+    static constexpr uint32_t kTargets = kindMask(KindZombie);
+    static constexpr uint32_t kScanned = kindMask(KindZombie) | kindMask(KindHero);  // Threats, protectors
+};
+template <> struct BehaviorTraits<AgentType::Zombie> {
+    static constexpr float kSpeed = 35.0f;  // Slightly slower (was 55)
+    static constexpr uint32_t kTargets = kindMask(KindCivilian) | kindMask(KindHero);
+    static constexpr uint32_t kScanned = kTargets;
+};
+template <> struct BehaviorTraits<AgentType::Hero> {
+    static constexpr float kSpeed = 50.0f;  // Fastest (was 75)
+    static constexpr uint32_t kTargets = kindMask(KindZombie);
+    static constexpr uint32_t kScanned = kTargets;
+};
+
+constexpr float kSeekRadius = 150.0f;      // Detection range
+constexpr float kSearchDuration = 3.0f;    // Seconds to search last known location
 }
 
-void Simulation::updateBehaviorsChunk(size_t start, size_t end, float dt) {
-    const float seekRadius = 150.0f;  // Detection range
-    const float searchDuration = 3.0f;  // Seconds to search last known location
-    const float wanderStrength = 20.0f;
+template <AgentType T>
+void Simulation::updateBehaviorKernel(size_t first, size_t last, float dt) {
+    // Neighbor buffer from this worker's arena, released when the chunk ends
+    FrameArena& arena = frameArena();
+    ArenaScope scope(arena);
+    ArenaVector<uint32_t> localNeighbors = makeArenaVector<uint32_t>(arena, 200);
+    const std::vector<uint32_t>& agents = behaviorLists[static_cast<size_t>(T)];
     
-    // Thread-local neighbor buffer
-    std::vector<uint32_t> localNeighbors;
-    localNeighbors.reserve(200);
+    const uint32_t now = timerNow();
     
-    for (size_t i = start; i < end; i++) {
-        AgentType myType = entities.type[i];
-        AgentState myState = entities.state[i];
+    for (size_t n = first; n < last; n++) {
+        uint32_t i = agents[n];
+        float px = entities.posX[i];
+        float py = entities.posY[i];
         
-        // Skip dead agents (corpses don't move)
-        if (myState == AgentState::Dead) {
-            entities.velX[i] = 0.0f;
-            entities.velY[i] = 0.0f;
+        Steering steer;
+        if (ticksUntil(entities.nextThinkTick[i], now) > 0) {
+            // Between evaluations: keep the last decision, re-steered from where we are
+            steer.dirX = entities.steerDirX[i];
+            steer.dirY = entities.steerDirY[i];
+            steer.targetCount = entities.steerActive[i];
+            steer.speed = entities.steerSpeed[i];
+            applySteering(i, px, py, steer);
             continue;
         }
         
-        // Fighting agents use special combat movement
-        if (myState == AgentState::Fighting) {
-            uint32_t targetIdx = entities.combatTarget[i];
-            if (targetIdx != UINT32_MAX && targetIdx < entities.count) {
-                // Face the opponent (lock direction)
-                float dx = entities.posX[targetIdx] - entities.posX[i];
-                float dy = entities.posY[targetIdx] - entities.posY[i];
-                float dist = std::sqrt(dx * dx + dy * dy + 0.01f);
-                entities.dirX[i] = dx / dist;
-                entities.dirY[i] = dy / dist;
-                
-                // Smooth struggle animation using elapsed time
-                // Use a combination of frequencies for organic feel
-                static float elapsedTime = 0.0f;
-                elapsedTime += 1.0f / 60.0f;
-                float phase = static_cast<float>(i) * 0.7f;  // Each agent has different phase
-                
-                // Perpendicular to facing direction for side-to-side shake
-                float perpX = -entities.dirY[i];
-                float perpY = entities.dirX[i];
-                
-                // Smooth sine wave shake (no random jitter)
-                float shake = std::sin(elapsedTime * 12.0f + phase) * 1.5f;
-                
-                // Subtle push/pull toward opponent
-                float pushPull = std::sin(elapsedTime * 4.0f + phase) * 0.5f;
-                
-                entities.velX[i] = perpX * shake + entities.dirX[i] * pushPull;
-                entities.velY[i] = perpY * shake + entities.dirY[i] * pushPull;
-            }
-            continue;
+        // Query nearby agents, if anything this type reacts to is around
+        const SpatialHash::Neighborhood near = spatialHash.neighborhood(px, py);
+        const bool urgent = near.has(BehaviorTraits<T>::kTargets);
+        if (urgent) {
+            near.collect(BehaviorTraits<T>::kScanned, localNeighbors);
+            if (localNeighbors.size() > behaviorNeighborCap) localNeighbors.resize(behaviorNeighborCap);
+        } else {
+            localNeighbors.clear();
         }
         
-        // Bitten agents flee desperately with reduced speed
-        if (myState == AgentState::Bitten) {
-            // Speed reduces as infection progresses
-            float healthySpeed = 40.0f;
-            float sickSpeed = healthySpeed * (1.0f - entities.infectionProgress[i] * 0.5f);
-            
-            // Flee from any nearby zombies
-            float fleeX = 0.0f, fleeY = 0.0f;
-            int threatCount = 0;
-            
-            float px = entities.posX[i];
-            float py = entities.posY[i];
-            spatialHash.queryNeighbors(px, py, 100.0f, localNeighbors);
+        // Timers advance by the time since the last evaluation
+        uint32_t elapsedTicks = std::clamp<uint32_t>(static_cast<ThinkTick>(now - entities.lastThinkTick[i]),
+                                                     1u, maxThinkInterval);
+        steer.speed = BehaviorTraits<T>::kSpeed;
+        decideBehavior<T>(i, px, py, localNeighbors, near.total, dt * elapsedTicks, steer);
+        
+        // Cached normalized the way applySteering() uses it, so it fits DirectionValue
+        const float dirLength = std::sqrt(steer.dirX * steer.dirX + steer.dirY * steer.dirY + 0.001f);
+        entities.steerDirX[i] = steer.dirX / dirLength;
+        entities.steerDirY[i] = steer.dirY / dirLength;
+        entities.steerActive[i] = steer.targetCount > 0 ? 1 : 0;
+        entities.steerSpeed[i] = steer.speed;
+        entities.lastThinkTick[i] = static_cast<ThinkTick>(now);
+        scheduleThink(i, urgent);
+        applySteering(i, px, py, steer);
+    }
+}
+
+void Simulation::scheduleThink(uint32_t i, bool urgent) {
+    // Threats or prey in range: every tick. Searching: every other tick (heading for a
+    // last-seen point). Idle and patrolling agents: the full interval.
+    uint32_t interval = maxThinkInterval;
+    if (urgent) {
+        interval = 1;
+    } else if (entities.state[i] == AgentState::Searching) {
+        interval = std::min(2u, maxThinkInterval);
+    }
+    
+    // Next tick where (tick + i) % interval == 0, so calm agents are spread evenly
+    // over the ticks instead of all re-evaluating together
+    const uint32_t now = timerNow();
+    entities.nextThinkTick[i] = static_cast<ThinkTick>(now + interval - (now + i) % interval);
+}
+
+template <>
+void Simulation::decideBehavior<AgentType::Civilian>(uint32_t i, float px, float py,
+                                                     const ArenaVector<uint32_t>& neighbors,
+                                                     const SpatialHash::CellSummary&, float dt, Steering& steer) {
+    AgentState myState = entities.state[i];
+    bool targetFound = false;
+    
+    // Check for nearby zombies and heroes
+    float nearestHeroDist = 1e9f;
+    float nearestHeroX = 0.0f, nearestHeroY = 0.0f;
+    
+    for (uint32_t neighborIdx : neighbors) {
+        if (entities.type[neighborIdx] == AgentType::Zombie) {
+            float dx = px - prevPosX[neighborIdx];
+            float dy = py - prevPosY[neighborIdx];
+            float distSq = dx * dx + dy * dy;
             
-            for (uint32_t neighborIdx : localNeighbors) {
-                if (entities.type[neighborIdx] == AgentType::Zombie) {
-                    float dx = px - entities.posX[neighborIdx];
-                    float dy = py - entities.posY[neighborIdx];
-                    float distSq = dx * dx + dy * dy;
-                    if (distSq > 0.01f) {
-                        float dist = std::sqrt(distSq);
-                        fleeX += (dx / dist);
-                        fleeY += (dy / dist);
-                        threatCount++;
-                    }
-                }
+            if (distSq > 0.01f) {
+                float dist = std::sqrt(distSq);
+                float force = 1.0f - (dist / kSeekRadius);
+                steer.dirX += (dx / dist) * force;
+                steer.dirY += (dy / dist) * force;
+                steer.targetCount++;
+                targetFound = true;
+                
+                // Update memory
+                entities.lastSeenX[i] = prevPosX[neighborIdx];
+                entities.lastSeenY[i] = prevPosY[neighborIdx];
             }
-            
-            if (threatCount > 0) {
-                float len = std::sqrt(fleeX * fleeX + fleeY * fleeY + 0.01f);
-                entities.velX[i] = (fleeX / len) * sickSpeed;
-                entities.velY[i] = (fleeY / len) * sickSpeed;
-            } else {
-                // Wander slowly
-                entities.velX[i] *= 0.95f;
-                entities.velY[i] *= 0.95f;
+        } else if (entities.type[neighborIdx] == AgentType::Hero) {
+            // Track nearest hero for flee-to-protection behavior
+            float dx = prevPosX[neighborIdx] - px;
+            float dy = prevPosY[neighborIdx] - py;
+            float distSq = dx * dx + dy * dy;
+            if (distSq < nearestHeroDist) {
+                nearestHeroDist = distSq;
+                nearestHeroX = prevPosX[neighborIdx];
+                nearestHeroY = prevPosY[neighborIdx];
             }
-            continue;
+        }
+    }
+    
+    if (targetFound) {
+        // Choose flee strategy on first detection (sticky decision)
+        if (myState != AgentState::Fleeing) {
+            entities.setFleeStrategy(i, (workerRandom(i, StreamFleeStrategy, 0, 100) < 30) ? 1 : 0);
         }
         
-        float px = entities.posX[i];
-        float py = entities.posY[i];
+        bool seekProtection = (entities.getFleeStrategy(i) == 1) && nearestHeroDist < 1e8f;
+        
+        if (seekProtection) {
+            // Flee toward nearest hero for protection
+            float dx = nearestHeroX - px;
+            float dy = nearestHeroY - py;
+            float dist = std::sqrt(dx * dx + dy * dy + 0.01f);
+            steer.dirX = dx / dist;
+            steer.dirY = dy / dist;
+        }
         
-        // Query nearby agents
-        spatialHash.queryNeighbors(px, py, seekRadius, localNeighbors);
+        entities.state[i] = AgentState::Fleeing;
+        steer.speed = 45.0f;  // Panic boost (was 65)
+    } else if (myState == AgentState::Fleeing) {
+        entities.state[i] = AgentState::Searching;
+        entities.searchTimer[i] = kSearchDuration;
+    }
+    
+    if (myState == AgentState::Searching) {
+        entities.searchTimer[i] -= dt;
+        steer.dirX = px - entities.lastSeenX[i];
+        steer.dirY = py - entities.lastSeenY[i];
+        steer.targetCount = 1;
+        steer.speed = 50.0f;
         
-        float desiredDirX = 0.0f;
-        float desiredDirY = 0.0f;
-        int targetCount = 0;
-        bool targetFound = false;
+        if (entities.searchTimer[i] <= 0) {
+            entities.state[i] = AgentState::Idle;
+        }
+    }
+}
+
+template <>
+void Simulation::decideBehavior<AgentType::Zombie>(uint32_t i, float px, float py,
+                                                   const ArenaVector<uint32_t>& neighbors,
+                                                   const SpatialHash::CellSummary& near, float dt, Steering& steer) {
+    AgentState myState = entities.state[i];
+    bool targetFound = false;
+    
+    // Seek civilians and heroes
+    float closestDistSq = kSeekRadius * kSeekRadius;
+    
+    // Check for recent gunshots (attracts zombies!) unless a building muffles them
+    const float gunshotAttractionRadius = kGunshotHearingRadius;
+    for (size_t g = 0; g < recentGunshots.size(); g++) {
+        const Gunshot& gunshot = recentGunshots[g];
+        float dx = gunshot.x - px;
+        float dy = gunshot.y - py;
+        float distSq = dx * dx + dy * dy;
+        if (distSq < gunshotAttractionRadius * gunshotAttractionRadius && hearsGunshot(g, px, py)) {
+            float dist = std::sqrt(distSq + 0.01f);
+            float force = 0.5f * (1.0f - dist / gunshotAttractionRadius);
+            steer.dirX += (dx / dist) * force;
+            steer.dirY += (dy / dist) * force;
+            steer.targetCount++;
+        }
+    }
+    
+    for (uint32_t neighborIdx : neighbors) {
+        AgentType neighborType = entities.type[neighborIdx];
+        AgentState neighborState = entities.state[neighborIdx];
         
-        // Target speeds for each agent type
-        float targetSpeed = 40.0f;  // Base civilian speed (was 60)
-        if (myType == AgentType::Zombie) targetSpeed = 35.0f;    // Zombies slightly slower (was 55)
-        else if (myType == AgentType::Hero) targetSpeed = 50.0f;  // Heroes fastest (was 75)
+        // Skip dead agents - zombies prefer live prey
+        if (neighborState == AgentState::Dead) continue;
         
-        // Different behaviors based on agent type and state
-        if (myType == AgentType::Civilian) {
-            // Check for nearby zombies and heroes
-            float nearestHeroDist = 1e9f;
-            float nearestHeroX = 0.0f, nearestHeroY = 0.0f;
-            
-            for (uint32_t neighborIdx : localNeighbors) {
-                if (entities.type[neighborIdx] == AgentType::Zombie) {
-                    float dx = px - entities.posX[neighborIdx];
-                    float dy = py - entities.posY[neighborIdx];
-                    float distSq = dx * dx + dy * dy;
-                    
-                    if (distSq > 0.01f) {
-                        float dist = std::sqrt(distSq);
-                        float force = 1.0f - (dist / seekRadius);
-                        desiredDirX += (dx / dist) * force;
-                        desiredDirY += (dy / dist) * force;
-                        targetCount++;
-                        targetFound = true;
-                        
-                        // Update memory
-                        entities.lastSeenX[i] = entities.posX[neighborIdx];
-                        entities.lastSeenY[i] = entities.posY[neighborIdx];
-                    }
-                } else if (entities.type[neighborIdx] == AgentType::Hero) {
-                    // Track nearest hero for flee-to-protection behavior
-                    float dx = entities.posX[neighborIdx] - px;
-                    float dy = entities.posY[neighborIdx] - py;
-                    float distSq = dx * dx + dy * dy;
-                    if (distSq < nearestHeroDist) {
-                        nearestHeroDist = distSq;
-                        nearestHeroX = entities.posX[neighborIdx];
-                        nearestHeroY = entities.posY[neighborIdx];
-                    }
-                }
-            }
+        if (neighborType == AgentType::Civilian || neighborType == AgentType::Hero) {
+            float dx = prevPosX[neighborIdx] - px;
+            float dy = prevPosY[neighborIdx] - py;
+            float distSq = dx * dx + dy * dy;
             
-            if (targetFound) {
-                // Choose flee strategy on first detection (sticky decision)
-                if (myState != AgentState::Fleeing) {
-                    entities.fleeStrategy[i] = (GetRandomValue(0, 100) < 30) ? 1 : 0;
-                }
-                
-                bool seekProtection = (entities.fleeStrategy[i] == 1) && nearestHeroDist < 1e8f;
-                
-                if (seekProtection) {
-                    // Flee toward nearest hero for protection
-                    float dx = nearestHeroX - px;
-                    float dy = nearestHeroY - py;
-                    float dist = std::sqrt(dx * dx + dy * dy + 0.01f);
-                    desiredDirX = dx / dist;
-                    desiredDirY = dy / dist;
-                }
+            if (distSq > 0.01f && distSq < closestDistSq) {
+                float dist = std::sqrt(distSq);
+                float force = 1.0f - (dist / kSeekRadius);
+                steer.dirX += (dx / dist) * force;
+                steer.dirY += (dy / dist) * force;
+                steer.targetCount++;
+                targetFound = true;
                 
-                entities.state[i] = AgentState::Fleeing;
-                targetSpeed = 45.0f;  // Panic boost (was 65)
-            } else if (myState == AgentState::Fleeing) {
-                entities.state[i] = AgentState::Searching;
-                entities.searchTimer[i] = searchDuration;
-            }
-            
-            if (myState == AgentState::Searching) {
-                entities.searchTimer[i] -= dt;
-                desiredDirX = px - entities.lastSeenX[i];
-                desiredDirY = py - entities.lastSeenY[i];
-                targetCount = 1;
-                targetSpeed = 50.0f;
+                // Update memory
+                entities.lastSeenX[i] = prevPosX[neighborIdx];
+                entities.lastSeenY[i] = prevPosY[neighborIdx];
+                closestDistSq = distSq;
                 
-                if (entities.searchTimer[i] <= 0) {
-                    entities.state[i] = AgentState::Idle;
+                // Lunge when close
+                if (dist < 30.0f) {
+                    steer.speed = 45.0f;  // Sprint! (was 65)
                 }
             }
-            
-        } else if (myType == AgentType::Zombie) {
-            // Seek civilians and heroes
-            float closestDistSq = seekRadius * seekRadius;
-            float cohesionX = 0.0f, cohesionY = 0.0f;
-            int zombieCount = 0;
-            
-            // Check for recent gunshots (attracts zombies!)
-            const float gunshotAttractionRadius = 300.0f;
-            for (const auto& gunshot : recentGunshots) {
-                float dx = gunshot.x - px;
-                float dy = gunshot.y - py;
-                float distSq = dx * dx + dy * dy;
-                if (distSq < gunshotAttractionRadius * gunshotAttractionRadius) {
-                    float dist = std::sqrt(distSq + 0.01f);
-                    float force = 0.5f * (1.0f - dist / gunshotAttractionRadius);
-                    desiredDirX += (dx / dist) * force;
-                    desiredDirY += (dy / dist) * force;
-                    targetCount++;
-                }
+        }
+    }
+    
+    if (targetFound) {
+        entities.state[i] = AgentState::Pursuing;
+    } else if (myState == AgentState::Pursuing) {
+        entities.state[i] = AgentState::Searching;
+        entities.searchTimer[i] = kSearchDuration * 2.0f;
+    }
+    
+    if (myState == AgentState::Searching || myState == AgentState::Patrol) {
+        // Form hordes when not actively pursuing, toward the nearby zombies' centroid
+        const uint32_t zombieCount = near.count[KindZombie];
+        if (zombieCount > 0 && !targetFound) {
+            float cohesionX = near.sumX[KindZombie] / zombieCount;
+            float cohesionY = near.sumY[KindZombie] / zombieCount;
+            float dx = cohesionX - px;
+            float dy = cohesionY - py;
+            float dist = std::sqrt(dx * dx + dy * dy + 0.01f);
+            if (dist > 10.0f) {  // Don't cluster too tightly
+                steer.dirX += (dx / dist) * 0.3f;  // Weak cohesion
+                steer.dirY += (dy / dist) * 0.3f;
+                steer.targetCount++;
             }
+        }
+    }
+    
+    if (myState == AgentState::Searching) {
+        entities.searchTimer[i] -= dt;
+        float dx = entities.lastSeenX[i] - px;
+        float dy = entities.lastSeenY[i] - py;
+        float dist = std::sqrt(dx * dx + dy * dy + 0.01f);
+        steer.dirX += dx / dist;
+        steer.dirY += dy / dist;
+        steer.targetCount = steer.targetCount > 0 ? steer.targetCount : 1;
+        steer.speed = 45.0f;
+        
+        if (dist < 5.0f || entities.searchTimer[i] <= 0) {
+            entities.state[i] = AgentState::Patrol;
+        }
+    }
+}
+
+template <>
+void Simulation::decideBehavior<AgentType::Hero>(uint32_t i, float px, float py,
+                                                 const ArenaVector<uint32_t>& neighbors,
+                                                 const SpatialHash::CellSummary& near, float dt, Steering& steer) {
+    AgentState myState = entities.state[i];
+    bool targetFound = false;
+    
+    // Update shoot cooldown and aim timer
+    if (entities.shootCooldown[i] > 0.0f) {
+        entities.shootCooldown[i] -= dt;
+    }
+    if (entities.aimTimer[i] > 0.0f) {
+        entities.aimTimer[i] -= dt;
+    }
+    
+    // Seek zombies aggressively
+    float closestZombieDist = 1e9f;
+    uint32_t closestZombieIdx = UINT32_MAX;
+    
+    for (uint32_t neighborIdx : neighbors) {
+        if (entities.type[neighborIdx] == AgentType::Zombie) {
+            float dx = prevPosX[neighborIdx] - px;
+            float dy = prevPosY[neighborIdx] - py;
+            float distSq = dx * dx + dy * dy;
             
-            for (uint32_t neighborIdx : localNeighbors) {
-                AgentType neighborType = entities.type[neighborIdx];
-                AgentState neighborState = entities.state[neighborIdx];
-                
-                // Skip dead agents - zombies prefer live prey
-                if (neighborState == AgentState::Dead) continue;
+            if (distSq > 0.01f) {
+                float dist = std::sqrt(distSq);
+                float force = 1.0f - (dist / kSeekRadius);
+                steer.dirX += (dx / dist) * force;
+                steer.dirY += (dy / dist) * force;
+                steer.targetCount++;
+                targetFound = true;
                 
-                if (neighborType == AgentType::Civilian || neighborType == AgentType::Hero) {
-                    float dx = entities.posX[neighborIdx] - px;
-                    float dy = entities.posY[neighborIdx] - py;
-                    float distSq = dx * dx + dy * dy;
-                    
-                    if (distSq > 0.01f && distSq < closestDistSq) {
-                        float dist = std::sqrt(distSq);
-                        float force = 1.0f - (dist / seekRadius);
-                        desiredDirX += (dx / dist) * force;
-                        desiredDirY += (dy / dist) * force;
-                        targetCount++;
-                        targetFound = true;
-                        
-                        // Update memory
-                        entities.lastSeenX[i] = entities.posX[neighborIdx];
-                        entities.lastSeenY[i] = entities.posY[neighborIdx];
-                        closestDistSq = distSq;
-                        
-                        // Lunge when close
-                        if (dist < 30.0f) {
-                            targetSpeed = 45.0f;  // Sprint! (was 65)
-                        }
-                    }
-                } else if (neighborType == AgentType::Zombie) {
-                    // Horde behavior - track zombie positions for cohesion
-                    cohesionX += entities.posX[neighborIdx];
-                    cohesionY += entities.posY[neighborIdx];
-                    zombieCount++;
-                }
-            }
-            
-            if (targetFound) {
-                entities.state[i] = AgentState::Pursuing;
-            } else if (myState == AgentState::Pursuing) {
-                entities.state[i] = AgentState::Searching;
-                entities.searchTimer[i] = searchDuration * 2.0f;
-            }
-            
-            if (myState == AgentState::Searching || myState == AgentState::Patrol) {
-                // Form hordes when not actively pursuing
-                if (zombieCount > 0 && !targetFound) {
-                    cohesionX /= zombieCount;
-                    cohesionY /= zombieCount;
-                    float dx = cohesionX - px;
-                    float dy = cohesionY - py;
-                    float dist = std::sqrt(dx * dx + dy * dy + 0.01f);
-                    if (dist > 10.0f) {  // Don't cluster too tightly
-                        desiredDirX += (dx / dist) * 0.3f;  // Weak cohesion
-                        desiredDirY += (dy / dist) * 0.3f;
-                        targetCount++;
-                    }
+                if (dist < closestZombieDist) {
+                    closestZombieDist = dist;
+                    closestZombieIdx = neighborIdx;
                 }
-            }
-            
-            if (myState == AgentState::Searching) {
-                entities.searchTimer[i] -= dt;
-                float dx = entities.lastSeenX[i] - px;
-                float dy = entities.lastSeenY[i] - py;
-                float dist = std::sqrt(dx * dx + dy * dy + 0.01f);
-                desiredDirX += dx / dist;
-                desiredDirY += dy / dist;
-                targetCount = targetCount > 0 ? targetCount : 1;
-                targetSpeed = 45.0f;
                 
-                if (dist < 5.0f || entities.searchTimer[i] <= 0) {
-                    entities.state[i] = AgentState::Patrol;
-                }
+                // Update memory
+                entities.lastSeenX[i] = prevPosX[neighborIdx];
+                entities.lastSeenY[i] = prevPosY[neighborIdx];
             }
-            
-        } else if (myType == AgentType::Hero) {
-            // Update shoot cooldown and aim timer
-            if (entities.shootCooldown[i] > 0.0f) {
-                entities.shootCooldown[i] -= dt;
-            }
-            if (entities.aimTimer[i] > 0.0f) {
-                entities.aimTimer[i] -= dt;
-            }
-            
-            // Seek zombies aggressively
-            float squadX = 0.0f, squadY = 0.0f;
-            int heroCount = 0;
-            float closestZombieDist = 1e9f;
-            uint32_t closestZombieIdx = UINT32_MAX;
-            
-            for (uint32_t neighborIdx : localNeighbors) {
-                if (entities.type[neighborIdx] == AgentType::Zombie) {
-                    float dx = entities.posX[neighborIdx] - px;
-                    float dy = entities.posY[neighborIdx] - py;
-                    float distSq = dx * dx + dy * dy;
-                    
-                    if (distSq > 0.01f) {
-                        float dist = std::sqrt(distSq);
-                        float force = 1.0f - (dist / seekRadius);
-                        desiredDirX += (dx / dist) * force;
-                        desiredDirY += (dy / dist) * force;
-                        targetCount++;
-                        targetFound = true;
-                        
-                        if (dist < closestZombieDist) {
-                            closestZombieDist = dist;
-                            closestZombieIdx = neighborIdx;
-                        }
-                        
-                        // Update memory
-                        entities.lastSeenX[i] = entities.posX[neighborIdx];
-                        entities.lastSeenY[i] = entities.posY[neighborIdx];
-                    }
-                } else if (entities.type[neighborIdx] == AgentType::Hero) {
-                    // Squad coordination - track hero positions
-                    squadX += entities.posX[neighborIdx];
-                    squadY += entities.posY[neighborIdx];
-                    heroCount++;
-                }
-            }
-            
-            if (targetFound) {
-                entities.state[i] = AgentState::Pursuing;
-                
-                bool isHunter = entities.heroType[i] == 1;
-                
-                if (isHunter) {
-                    // Hunters: chase down zombies aggressively
-                    targetSpeed = 55.0f;  // (was 80)
-                } else {
-                    // Defenders: maintain distance, kite backwards
-                    if (closestZombieDist < 70.0f) {
-                        // Too close - back away while shooting
-                        desiredDirX = -desiredDirX;  // Reverse direction
-                        desiredDirY = -desiredDirY;
-                        targetSpeed = 45.0f;  // Back up speed (was 70)
-                    } else {
-                        // Good distance - hold position (slow movement)
-                        targetSpeed = 15.0f;  // (was 20)
-                    }
-                }
-                
-                // Shoot when aim timer completes (check this FIRST before resetting timer)
-                bool justShot = false;
-                if (entities.aimTimer[i] <= 0.0f && entities.aimTimer[i] > -10.0f &&  // Timer just expired
-                    entities.shootCooldown[i] <= 0.0f && 
-                    closestZombieDist < 100.0f && closestZombieIdx != UINT32_MAX) {
-                    entities.shootCooldown[i] = 1.5f;  // 1.5 second cooldown
-                    entities.aimTimer[i] = -100.0f;  // Mark as shot (prevent retriggering)
-                    // Store shoot info for main thread to process
-                    entities.lastSeenX[i] = (float)i;  // Store shooter index
-                    entities.lastSeenY[i] = (float)closestZombieIdx;  // Store target index
-                    justShot = true;
-                }
-                
-                // Start aiming if we have a target and no aim timer (but didn't just shoot)
-                if (!justShot && closestZombieDist < 100.0f && entities.aimTimer[i] <= 0.0f && entities.shootCooldown[i] <= 0.0f) {
-                    // Variable aim delay: 0.3-0.6 seconds
-                    entities.aimTimer[i] = 0.3f + ((float)GetRandomValue(0, 300) / 1000.0f);
-                }
-                
-                // Squad cohesion when pursuing (only for defenders)
-                if (!isHunter && heroCount > 0) {
-                    squadX /= heroCount;
-                    squadY /= heroCount;
-                    float dx = squadX - px;
-                    float dy = squadY - py;
-                    float dist = std::sqrt(dx * dx + dy * dy + 0.01f);
-                    if (dist > 15.0f) {  // Stay somewhat close to squad
-                        desiredDirX += (dx / dist) * 0.3f;  // Stronger coordination for defenders
-                        desiredDirY += (dy / dist) * 0.3f;
-                    }
-                }
-            } else if (myState == AgentState::Pursuing) {
-                entities.state[i] = AgentState::Searching;
-                entities.searchTimer[i] = searchDuration * 1.5f;
+        }
+    }
+    
+    if (targetFound) {
+        entities.state[i] = AgentState::Pursuing;
+        
+        bool isHunter = entities.getHeroType(i) == 1;
+        
+        if (isHunter) {
+            // Hunters: chase down zombies aggressively
+            steer.speed = 55.0f;  // (was 80)
+        } else {
+            // Defenders: maintain distance, kite backwards
+            if (closestZombieDist < 70.0f) {
+                // Too close - back away while shooting
+                steer.dirX = -steer.dirX;  // Reverse direction
+                steer.dirY = -steer.dirY;
+                steer.speed = 45.0f;  // Back up speed (was 70)
+            } else {
+                // Good distance - hold position (slow movement)
+                steer.speed = 15.0f;  // (was 20)
             }
-            
-            if (myState == AgentState::Searching) {
-                entities.searchTimer[i] -= dt;
-                desiredDirX = entities.lastSeenX[i] - px;
-                desiredDirY = entities.lastSeenY[i] - py;
-                float dist = std::sqrt(desiredDirX * desiredDirX + desiredDirY * desiredDirY + 0.01f);
-                targetCount = 1;
-                targetSpeed = 65.0f;
-                
-                if (dist < 5.0f || entities.searchTimer[i] <= 0) {
-                    entities.state[i] = AgentState::Patrol;
-                }
+        }
+        
+        // Shoot when aim timer completes (check this FIRST before resetting timer)
+        bool justShot = false;
+        if (entities.aimTimer[i] <= 0.0f && entities.aimTimer[i] > -10.0f &&  // Timer just expired
+            entities.shootCooldown[i] <= 0.0f && 
+            closestZombieDist < 100.0f && closestZombieIdx != UINT32_MAX) {
+            entities.shootCooldown[i] = 1.5f;  // 1.5 second cooldown
+            entities.aimTimer[i] = -100.0f;  // Mark as shot (prevent retriggering)
+            // Store shoot info for main thread to process
+            entities.lastSeenX[i] = (float)i;  // Store shooter index
+            entities.lastSeenY[i] = (float)closestZombieIdx;  // Store target index
+            justShot = true;
+        }
+        
+        // Start aiming if we have a target and no aim timer (but didn't just shoot)
+        if (!justShot && closestZombieDist < 100.0f && entities.aimTimer[i] <= 0.0f && entities.shootCooldown[i] <= 0.0f) {
+            // Variable aim delay: 0.3-0.6 seconds
+            entities.aimTimer[i] = 0.3f + ((float)workerRandom(i, StreamAimDelay, 0, 300) / 1000.0f);
+        }
+        
+        // Squad cohesion when pursuing (only for defenders), toward the nearby heroes' centroid
+        const uint32_t heroCount = near.count[KindHero];
+        if (!isHunter && heroCount > 0) {
+            float squadX = near.sumX[KindHero] / heroCount;
+            float squadY = near.sumY[KindHero] / heroCount;
+            float dx = squadX - px;
+            float dy = squadY - py;
+            float dist = std::sqrt(dx * dx + dy * dy + 0.01f);
+            if (dist > 15.0f) {  // Stay somewhat close to squad
+                steer.dirX += (dx / dist) * 0.3f;  // Stronger coordination for defenders
+                steer.dirY += (dy / dist) * 0.3f;
             }
         }
+    } else if (myState == AgentState::Pursuing) {
+        entities.state[i] = AgentState::Searching;
+        entities.searchTimer[i] = kSearchDuration * 1.5f;
+    }
+    
+    if (myState == AgentState::Searching) {
+        entities.searchTimer[i] -= dt;
+        steer.dirX = entities.lastSeenX[i] - px;
+        steer.dirY = entities.lastSeenY[i] - py;
+        float dist = std::sqrt(steer.dirX * steer.dirX + steer.dirY * steer.dirY + 0.01f);
+        steer.targetCount = 1;
+        steer.speed = 65.0f;
+        
+        if (dist < 5.0f || entities.searchTimer[i] <= 0) {
+            entities.state[i] = AgentState::Patrol;
+        }
+    }
+}
+
+void Simulation::applySteering(uint32_t i, float px, float py, Steering& steer) {
+    // Patrol behavior - pick random destinations and walk toward them
+    if (entities.state[i] == AgentState::Patrol) {
+        float dx = entities.patrolTargetX[i] - px;
+        float dy = entities.patrolTargetY[i] - py;
+        float distSq = dx * dx + dy * dy;
+        
+        // Reached patrol point or need new one
+        if (distSq < 25.0f || distSq > 1e8f) {
+            entities.patrolTargetX[i] = patrolCoordinate(px, world.width, workerRandom(i, StreamPatrolX, -1000, 1000) / 1000.0f);
+            entities.patrolTargetY[i] = patrolCoordinate(py, world.height, workerRandom(i, StreamPatrolY, -1000, 1000) / 1000.0f);
+            dx = entities.patrolTargetX[i] - px;
+            dy = entities.patrolTargetY[i] - py;
+            distSq = dx * dx + dy * dy;
+        }
         
-        // Patrol behavior - pick random destinations and walk toward them
-        if (entities.state[i] == AgentState::Patrol) {
-            float dx = entities.patrolTargetX[i] - px;
-            float dy = entities.patrolTargetY[i] - py;
+        if (distSq > 0.1f) {
+            float dist = std::sqrt(distSq);
+            steer.dirX = dx / dist;
+            steer.dirY = dy / dist;
+            steer.targetCount = 1;
+            steer.speed *= 0.4f;  // Slow wandering (24/22/30 for civilian/zombie/hero)
+        }
+    }
+    
+    const float targetSpeed = steer.speed;
+    float vx = entities.velX[i];
+    float vy = entities.velY[i];
+    
+    // Apply steering - direct velocity setting for instant direction changes
+    if (steer.targetCount > 0) {
+        // Normalize desired direction
+        float dirLength = std::sqrt(steer.dirX * steer.dirX + steer.dirY * steer.dirY + 0.001f);
+        
+        // Directly set velocity (instant response)
+        vx = (steer.dirX / dirLength) * targetSpeed;
+        vy = (steer.dirY / dirLength) * targetSpeed;
+    } else {
+        // Idle or no target - gradually slow down
+        vx *= 0.9f;
+        vy *= 0.9f;
+    }
+    
+    // Sharp wall avoidance - aggressive direction change near boundaries
+    const float dangerZone = 100.0f;  // Critical distance from wall
+    const float w = world.width;
+    const float h = world.height;
+    
+    bool nearWall = false;
+    float wallAvoidX = 0.0f;
+    float wallAvoidY = 0.0f;
+    
+    // Check proximity to each wall and calculate emergency steering
+    if (px < dangerZone) {
+        nearWall = true;
+        float urgency = 1.0f - (px / dangerZone);
+        // Redirect velocity sharply away from wall
+        wallAvoidX = urgency * 2.0f;  // Strong rightward push
+        // Also redirect current velocity perpendicular to wall
+        if (vx < 0) {
+            vx *= (1.0f - urgency);  // Dampen approach velocity
+        }
+    }
+    if (px > w - dangerZone) {
+        nearWall = true;
+        float urgency = 1.0f - ((w - px) / dangerZone);
+        wallAvoidX = -urgency * 2.0f;  // Strong leftward push
+        if (vx > 0) {
+            vx *= (1.0f - urgency);
+        }
+    }
+    if (py < dangerZone) {
+        nearWall = true;
+        float urgency = 1.0f - (py / dangerZone);
+        wallAvoidY = urgency * 2.0f;  // Strong downward push
+        if (vy < 0) {
+            vy *= (1.0f - urgency);
+        }
+    }
+    if (py > h - dangerZone) {
+        nearWall = true;
+        float urgency = 1.0f - ((h - py) / dangerZone);
+        wallAvoidY = -urgency * 2.0f;  // Strong upward push
+        if (vy > 0) {
+            vy *= (1.0f - urgency);
+        }
+    }
+    
+    // Apply sharp turn when near walls by directly modifying velocity direction
+    if (nearWall) {
+        // Blend wall avoidance direction with current velocity
+        float blendFactor = 0.7f;  // Strong influence
+        vx = vx * (1.0f - blendFactor) + wallAvoidX * targetSpeed * blendFactor;
+        vy = vy * (1.0f - blendFactor) + wallAvoidY * targetSpeed * blendFactor;
+    }
+    
+    // Clamp to max speed
+    float speedSq = vx * vx + vy * vy;
+    float maxSpeed = targetSpeed * 1.1f;
+    if (speedSq > maxSpeed * maxSpeed) {
+        float speed = std::sqrt(speedSq);
+        vx = (vx / speed) * maxSpeed;
+        vy = (vy / speed) * maxSpeed;
+    }
+    entities.velX[i] = vx;
+    entities.velY[i] = vy;
+}
+
+template <AgentType T>
+void Simulation::submitBehaviorKernel(size_t chunkSize) {
+    const auto& list = behaviorLists[static_cast<size_t>(T)];
+    const size_t count = list.size();
+    for (size_t start = 0; start < count; start += chunkSize) {
+        submitChunk([this, first = static_cast<uint32_t>(start),
+                            last = static_cast<uint32_t>(std::min(start + chunkSize, count))]() {
+            updateBehaviorKernel<T>(first, last, stepDt);
+        }, list[start]);  // Lists are in agent order, so chunks map to agent slices too
+    }
+}
+
+void Simulation::fillBehaviorLists() {
+    // Group agents by type so each type runs its own kernel. Agents on a state list
+    // are left out here; they get their state's behavior instead. Horde members were
+    // steered by updateHordes(); ghosts are decided by the region that owns them.
+    for (auto& list : behaviorLists) list.clear();
+    for (uint32_t i = 0; i < entities.count; i++) {
+        if (stateListOf(entities.state[i]) >= 0 || entities.horde[i] != 0 || entities.ghost[i]) continue;
+        behaviorLists[static_cast<size_t>(entities.type[i])].push_back(i);
+    }
+}
+
+void Simulation::updateBehaviors() {
+    // Parallelize behavior updates
+    const size_t chunkSize = agentChunkSize;
+    
+    fillBehaviorLists();
+    submitBehaviorKernel<AgentType::Civilian>(chunkSize);
+    submitBehaviorKernel<AgentType::Zombie>(chunkSize);
+    submitBehaviorKernel<AgentType::Hero>(chunkSize);
+    
+    // Fighting and bitten agents run their own behavior over their lists, in the same
+    // batch: they only write their own velocity/direction, which the chunks above
+    // don't read. Corpses need nothing - their velocity was zeroed when they died.
+    const size_t fighting = stateLists[FightingList].size();
+    for (size_t start = 0; start < fighting; start += chunkSize) {
+        submitJob([this, first = static_cast<uint32_t>(start),
+                          last = static_cast<uint32_t>(std::min(start + chunkSize, fighting))]() {
+            updateFightingChunk(first, last);
+        });
+    }
+    const size_t bitten = stateLists[BittenList].size();
+    for (size_t start = 0; start < bitten; start += chunkSize) {
+        submitJob([this, first = static_cast<uint32_t>(start),
+                          last = static_cast<uint32_t>(std::min(start + chunkSize, bitten))]() {
+            updateBittenChunk(first, last);
+        });
+    }
+    
+    waitJobs();
+}
+
+// Separation, behaviors and movement for the agents in [start, end), in that order, so
+// the chunk's columns are still in cache when the next stage reads them. Other chunks
+// may already have moved their agents, which is why every kernel reads neighbors from
+// prevPosX/Y; an agent's own posX/Y only changes in the last stage.
+void Simulation::updateFusedChunk(size_t start, size_t end, float dt) {
+    updateSeparationChunk(start, end, dt);
+    
+    // The part of each type's list that falls in this chunk (lists are in agent order)
+    for (size_t t = 0; t < behaviorLists.size(); t++) {
+        const auto& list = behaviorLists[t];
+        const size_t first = std::lower_bound(list.begin(), list.end(), static_cast<uint32_t>(start)) - list.begin();
+        const size_t last = std::lower_bound(list.begin() + first, list.end(), static_cast<uint32_t>(end)) - list.begin();
+        if (first == last) continue;
+        switch (static_cast<AgentType>(t)) {
+            case AgentType::Civilian: updateBehaviorKernel<AgentType::Civilian>(first, last, dt); break;
+            case AgentType::Zombie: updateBehaviorKernel<AgentType::Zombie>(first, last, dt); break;
+            case AgentType::Hero: updateBehaviorKernel<AgentType::Hero>(first, last, dt); break;
+        }
+    }
+    
+    // Fighting and bitten agents: their state lists are unordered, the slice isn't
+    FrameArena& arena = frameArena();
+    ArenaScope scope(arena);
+    ArenaVector<uint32_t> localNeighbors = makeArenaVector<uint32_t>(arena, 200);
+    for (size_t i = start; i < end; i++) {
+        const AgentState state = entities.state[i];
+        if (state == AgentState::Fighting) {
+            updateFighting(static_cast<uint32_t>(i));
+        } else if (state == AgentState::Bitten) {
+            updateBitten(static_cast<uint32_t>(i), localNeighbors);
+        }
+    }
+    
+    updateMovementChunk(start, end, dt);
+}
+
+void Simulation::updateFused() {
+    const size_t chunkSize = agentChunkSize;
+    
+    fillBehaviorLists();
+    for (size_t start = 0; start < entities.count; start += chunkSize) {
+        size_t end = std::min(start + chunkSize, entities.count);
+        submitChunk([this, first = static_cast<uint32_t>(start), last = static_cast<uint32_t>(end)]() {
+            updateFusedChunk(first, last, stepDt);
+        }, start);
+    }
+    
+    waitJobs();  // The only barrier between the spatial hash and infections
+}
+
+void Simulation::updateFightingChunk(size_t first, size_t last) {
+    for (size_t n = first; n < last; n++) {
+        updateFighting(stateLists[FightingList][n]);
+    }
+}
+
+void Simulation::updateFighting(uint32_t i) {
+    uint32_t targetIdx = entities.combatTarget[i];
+    if (targetIdx == UINT32_MAX || targetIdx >= entities.count) return;
+    
+    // Face the opponent (lock direction)
+    float dx = prevPosX[targetIdx] - prevPosX[i];
+    float dy = prevPosY[targetIdx] - prevPosY[i];
+    float dist = std::sqrt(dx * dx + dy * dy + 0.01f);
+    entities.dirX[i] = dx / dist;
+    entities.dirY[i] = dy / dist;
+    
+    // Smooth struggle animation using simulated time
+    // Use a combination of frequencies for organic feel
+    float elapsedTime = simTime;
+    float phase = static_cast<float>(i) * 0.7f;  // Each agent has different phase
+    
+    // Perpendicular to facing direction for side-to-side shake
+    float perpX = -entities.dirY[i];
+    float perpY = entities.dirX[i];
+    
+    // Smooth sine wave shake (no random jitter)
+    float shake = std::sin(elapsedTime * 12.0f + phase) * 1.5f;
+    
+    // Subtle push/pull toward opponent
+    float pushPull = std::sin(elapsedTime * 4.0f + phase) * 0.5f;
+    
+    entities.velX[i] = perpX * shake + entities.dirX[i] * pushPull;
+    entities.velY[i] = perpY * shake + entities.dirY[i] * pushPull;
+}
+
+void Simulation::updateBittenChunk(size_t first, size_t last) {
+    // Neighbor buffer from this worker's arena, released when the chunk ends
+    FrameArena& arena = frameArena();
+    ArenaScope scope(arena);
+    ArenaVector<uint32_t> localNeighbors = makeArenaVector<uint32_t>(arena, 200);
+    
+    for (size_t n = first; n < last; n++) {
+        updateBitten(stateLists[BittenList][n], localNeighbors);
+    }
+}
+
+void Simulation::updateBitten(uint32_t i, ArenaVector<uint32_t>& localNeighbors) {
+    // Bitten agents flee desperately with reduced speed
+    // Speed reduces as infection progresses
+    float healthySpeed = 40.0f;
+    float sickSpeed = healthySpeed * (1.0f - getInfectionProgress(i) * 0.5f);
+    
+    // Flee from any nearby zombies
+    float fleeX = 0.0f, fleeY = 0.0f;
+    int threatCount = 0;
+    
+    float px = entities.posX[i];
+    float py = entities.posY[i];
+    const SpatialHash::Neighborhood near = spatialHash.neighborhood(px, py);
+    near.collect(kindMask(KindZombie), localNeighbors);
+    
+    for (uint32_t neighborIdx : localNeighbors) {
+        if (entities.type[neighborIdx] == AgentType::Zombie) {
+            float dx = px - prevPosX[neighborIdx];
+            float dy = py - prevPosY[neighborIdx];
             float distSq = dx * dx + dy * dy;
-            
-            // Reached patrol point or need new one
-            if (distSq < 25.0f || distSq > 1e8f) {
-                entities.patrolTargetX[i] = (float)GetRandomValue(50, 1850);
-                entities.patrolTargetY[i] = (float)GetRandomValue(50, 1030);
-                dx = entities.patrolTargetX[i] - px;
-                dy = entities.patrolTargetY[i] - py;
-                distSq = dx * dx + dy * dy;
-            }
-            
-            if (distSq > 0.1f) {
+            if (distSq > 0.01f) {
                 float dist = std::sqrt(distSq);
-                desiredDirX = dx / dist;
-                desiredDirY = dy / dist;
-                targetCount = 1;
-                targetSpeed *= 0.4f;  // Slow wandering (24/22/30 for civilian/zombie/hero)
+                fleeX += (dx / dist);
+                fleeY += (dy / dist);
+                threatCount++;
             }
         }
+    }
+    
+    if (threatCount > 0) {
+        float len = std::sqrt(fleeX * fleeX + fleeY * fleeY + 0.01f);
+        entities.velX[i] = (fleeX / len) * sickSpeed;
+        entities.velY[i] = (fleeY / len) * sickSpeed;
+    } else {
+        // Wander slowly
+        entities.velX[i] *= 0.95f;
+        entities.velY[i] *= 0.95f;
+    }
+}
+
+// Horde macro-agents. Late in an outbreak thousands of zombies patrol in dense packs,
+// and per agent each one would still query its neighbors, pull toward the pack's
+// centroid and push apart from hundreds of others. A calm pack instead moves as one
+// body: one steering decision per horde, members copy its velocity and keep their
+// spacing, and only movement (obstacle collisions) still runs per member. Anything
+// alive within seek range of a horde, or a gunshot within earshot, releases every
+// member back to individual simulation that same tick.
+namespace {
+constexpr uint32_t kHordeMinSize = 24;           // Zombies needed to found a horde; below half it dissolves
+constexpr uint32_t kHordeRegroupInterval = 30;   // Ticks between formation passes
+constexpr float kHordeGatherRadius = 75.0f;      // Founding members around the seed zombie
+constexpr float kHordeJoinDistance = 25.0f;      // Free zombies this close to a horde's edge join it
+constexpr float kHordeMaxRadius = 300.0f;        // Hordes stop absorbing and merging beyond this
+constexpr float kHordeSpeed = 14.0f;             // Zombie patrol speed (35 * 0.4)
+constexpr uint32_t kHordeAlive = kindMask(KindCivilian) | kindMask(KindHero);
+
+// Ticks a horde gets to reach a target dist away before it picks another: twice the
+// travel time plus a second, so a horde pressed against a building moves on
+float hordeTravelSeconds(float dx, float dy) {
+    return 2.0f * std::sqrt(dx * dx + dy * dy) / kHordeSpeed + 1.0f;
+}
+}
+
+void Simulation::setHordesEnabled(bool enabled) {
+    hordesEnabled = enabled;
+    if (enabled) return;
+    for (size_t i = 0; i < entities.count; i++) {
+        if (entities.horde[i] != 0) leaveHorde(i);
+    }
+    hordes.clear();
+    hordeMemberStart.clear();
+    hordeMembers.clear();
+}
+
+void Simulation::updateHordes() {
+    if (hordes.empty() && !hordesEnabled) return;
+    
+    if (hordesEnabled && tickCount % kHordeRegroupInterval == 0) {
+        formHordes();
+    }
+    refreshHordeMembers();
+    hordeObstacles.clear();
+    
+    bool released = false;
+    for (uint32_t h = 0; h < hordes.size(); h++) {
+        Horde& horde = hordes[h];
         
-        // Apply steering - direct velocity setting for instant direction changes
-        if (targetCount > 0) {
-            // Normalize desired direction
-            float dirLength = std::sqrt(desiredDirX * desiredDirX + desiredDirY * desiredDirY + 0.001f);
-            desiredDirX /= dirLength;
-            desiredDirY /= dirLength;
-            
-            // Directly set velocity (instant response)
-            entities.velX[i] = desiredDirX * targetSpeed;
-            entities.velY[i] = desiredDirY * targetSpeed;
-            
-        } else {
-            // Idle or no target - gradually slow down
-            entities.velX[i] *= 0.9f;
-            entities.velY[i] *= 0.9f;
-        }
-        
-        // Sharp wall avoidance - aggressive direction change near boundaries
-        const float dangerZone = 100.0f;  // Critical distance from wall
-        const float w = static_cast<float>(screenWidth);
-        const float h = static_cast<float>(screenHeight);
-        
-        bool nearWall = false;
-        float wallAvoidX = 0.0f;
-        float wallAvoidY = 0.0f;
-        
-        // Check proximity to each wall and calculate emergency steering
-        if (px < dangerZone) {
-            nearWall = true;
-            float urgency = 1.0f - (px / dangerZone);
-            // Redirect velocity sharply away from wall
-            wallAvoidX = urgency * 2.0f;  // Strong rightward push
-            // Also redirect current velocity perpendicular to wall
-            if (entities.velX[i] < 0) {
-                entities.velX[i] *= (1.0f - urgency);  // Dampen approach velocity
-            }
+        // Prey or heroes within seek range of any member, or a shot the members would hear
+        const float reach = horde.radius + kSeekRadius;
+        bool threatened = !hordesEnabled ||
+                          (spatialHash.kindsInRange(horde.centerX, horde.centerY, reach) & kHordeAlive) != 0;
+        const float hearing = horde.radius + kGunshotHearingRadius;
+        for (size_t g = 0; g < recentGunshots.size() && !threatened; g++) {
+            const Gunshot& gunshot = recentGunshots[g];
+            float dx = gunshot.x - horde.centerX;
+            float dy = gunshot.y - horde.centerY;
+            float distSq = dx * dx + dy * dy;
+            if (distSq >= hearing * hearing) continue;
+            // Heard if the pack's edge nearest the shot is
+            float dist = std::sqrt(distSq);
+            float toEdge = dist > horde.radius ? horde.radius / dist : 1.0f;
+            threatened = hearsGunshot(g, horde.centerX + dx * toEdge, horde.centerY + dy * toEdge);
         }
-        if (px > w - dangerZone) {
-            nearWall = true;
-            float urgency = 1.0f - ((w - px) / dangerZone);
-            wallAvoidX = -urgency * 2.0f;  // Strong leftward push
-            if (entities.velX[i] > 0) {
-                entities.velX[i] *= (1.0f - urgency);
-            }
+        if (threatened) {
+            releaseHorde(h);
+            released = true;
+            continue;
         }
-        if (py < dangerZone) {
-            nearWall = true;
-            float urgency = 1.0f - (py / dangerZone);
-            wallAvoidY = urgency * 2.0f;  // Strong downward push
-            if (entities.velY[i] < 0) {
-                entities.velY[i] *= (1.0f - urgency);
+        
+        // Patrol as one body, with a new destination once there (or stuck on the way)
+        float dx = horde.targetX - horde.centerX;
+        float dy = horde.targetY - horde.centerY;
+        float distSq = dx * dx + dy * dy;
+        if (distSq < 25.0f || timerNow() >= horde.retargetTick) {
+            retargetHorde(horde, hordeMembers[hordeMemberStart[h]]);
+            dx = horde.targetX - horde.centerX;
+            dy = horde.targetY - horde.centerY;
+            distSq = dx * dx + dy * dy;
+        }
+        float dist = std::sqrt(distSq + 0.01f);
+        horde.velX = dx / dist * kHordeSpeed;
+        horde.velY = dy / dist * kHordeSpeed;
+        for (uint32_t m = hordeMemberStart[h]; m < hordeMemberStart[h + 1]; m++) {
+            entities.velX[hordeMembers[m]] = horde.velX;
+            entities.velY[hordeMembers[m]] = horde.velY;
+        }
+        
+        // Obstacles the members could touch this tick, so they test just those
+        const float reachObstacle = horde.radius + 10.0f;  // Building margin plus a tick of movement
+        horde.obstacleFirst = static_cast<uint32_t>(hordeObstacles.size());
+        horde.nearBuildings = 0;
+        horde.nearTrees = 0;
+        for (uint32_t b = 0; b < buildings.size(); b++) {
+            const auto& building = buildings[b];
+            float bx = horde.centerX - std::clamp(horde.centerX, building.x, building.x + building.width);
+            float by = horde.centerY - std::clamp(horde.centerY, building.y, building.y + building.height);
+            if (bx * bx + by * by < reachObstacle * reachObstacle) {
+                hordeObstacles.push_back(b);
+                horde.nearBuildings++;
             }
         }
-        if (py > h - dangerZone) {
-            nearWall = true;
-            float urgency = 1.0f - ((h - py) / dangerZone);
-            wallAvoidY = -urgency * 2.0f;  // Strong upward push
-            if (entities.velY[i] > 0) {
-                entities.velY[i] *= (1.0f - urgency);
+        for (uint32_t t = 0; t < trees.size(); t++) {
+            float tx = horde.centerX - trees[t].x;
+            float ty = horde.centerY - trees[t].y;
+            float reach = reachObstacle + trees[t].radius;
+            if (tx * tx + ty * ty < reach * reach) {
+                hordeObstacles.push_back(t);
+                horde.nearTrees++;
             }
         }
+    }
+    
+    if (released) {
+        refreshHordeMembers();  // Drop the emptied hordes
+    }
+}
+
+void Simulation::retargetHorde(Horde& horde, uint32_t keyEntity) {
+    horde.targetX = patrolCoordinate(horde.centerX, world.width, workerRandom(keyEntity, StreamHordeX, -1000, 1000) / 1000.0f);
+    horde.targetY = patrolCoordinate(horde.centerY, world.height, workerRandom(keyEntity, StreamHordeY, -1000, 1000) / 1000.0f);
+    horde.retargetTick = ticksFromNow(hordeTravelSeconds(horde.targetX - horde.centerX, horde.targetY - horde.centerY));
+}
+
+void Simulation::releaseHorde(uint32_t h) {
+    for (uint32_t m = hordeMemberStart[h]; m < hordeMemberStart[h + 1]; m++) {
+        leaveHorde(hordeMembers[m]);
+    }
+}
+
+void Simulation::refreshHordeMembers() {
+    const uint32_t hordeCount = static_cast<uint32_t>(hordes.size());
+    
+    // Members per horde (at [h], 1-based), dropping any that stopped patrolling
+    hordeMemberStart.assign(hordeCount + 1, 0);
+    for (size_t i = 0; i < entities.count; i++) {
+        uint32_t h = entities.horde[i];
+        if (h == 0) continue;
+        if (h > hordeCount || entities.state[i] != AgentState::Patrol || entities.type[i] != AgentType::Zombie) {
+            leaveHorde(i);
+            continue;
+        }
+        hordeMemberStart[h]++;
+    }
+    
+    // Hordes that shrank below half the founding size dissolve; the rest keep their order
+    hordeRemap.assign(hordeCount + 1, 0);
+    uint32_t kept = 0;
+    for (uint32_t h = 1; h <= hordeCount; h++) {
+        if (hordeMemberStart[h] < kHordeMinSize / 2) continue;
+        hordes[kept] = hordes[h - 1];
+        hordeMemberStart[++kept] = hordeMemberStart[h];
+        hordeRemap[h] = kept;
+    }
+    hordes.resize(kept);
+    hordeMemberStart.resize(kept + 1);
+    for (uint32_t h = 1; h <= kept; h++) {
+        hordeMemberStart[h] += hordeMemberStart[h - 1];  // Now [h] is where 0-based horde h starts
+    }
+    
+    // Fill the lists in index order, renumbering members as we go
+    hordeMembers.resize(hordeMemberStart[kept]);
+    for (size_t i = 0; i < entities.count; i++) {
+        uint32_t h = entities.horde[i];
+        if (h == 0) continue;
+        h = hordeRemap[h];
+        entities.horde[i] = h;
+        if (h == 0) {
+            leaveHorde(i);
+            continue;
+        }
+        hordeMembers[hordeMemberStart[h - 1]++] = static_cast<uint32_t>(i);
+    }
+    // Each start has advanced to the next horde's; shift them back
+    for (uint32_t h = kept; h > 0; h--) {
+        hordeMemberStart[h] = hordeMemberStart[h - 1];
+    }
+    hordeMemberStart[0] = 0;
+    
+    for (uint32_t h = 0; h < kept; h++) {
+        Horde& horde = hordes[h];
+        const uint32_t first = hordeMemberStart[h];
+        const uint32_t last = hordeMemberStart[h + 1];
+        float sumX = 0.0f, sumY = 0.0f;
+        for (uint32_t m = first; m < last; m++) {
+            sumX += entities.posX[hordeMembers[m]];
+            sumY += entities.posY[hordeMembers[m]];
+        }
+        horde.centerX = sumX / (last - first);
+        horde.centerY = sumY / (last - first);
+        float maxDistSq = 0.0f;
+        for (uint32_t m = first; m < last; m++) {
+            float dx = entities.posX[hordeMembers[m]] - horde.centerX;
+            float dy = entities.posY[hordeMembers[m]] - horde.centerY;
+            maxDistSq = std::max(maxDistSq, dx * dx + dy * dy);
+        }
+        horde.radius = std::sqrt(maxDistSq);
+    }
+}
+
+void Simulation::formHordes() {
+    FrameArena& arena = frameArena();
+    ArenaScope scope(arena);
+    ArenaVector<uint32_t> nearby = makeArenaVector<uint32_t>(arena, 256);
+    auto isFree = [this](uint32_t i) {
+        return entities.type[i] == AgentType::Zombie && entities.state[i] == AgentState::Patrol &&
+               entities.horde[i] == 0 && !entities.ghost[i];
+    };
+    
+    // Existing hordes take in free patrolling zombies at their edge...
+    for (uint32_t h = 0; h < hordes.size(); h++) {
+        const Horde& horde = hordes[h];
+        if (horde.radius >= kHordeMaxRadius) continue;
+        const float reach = horde.radius + kHordeJoinDistance;
+        spatialHash.queryRange(horde.centerX, horde.centerY, reach, nearby);
+        for (uint32_t i : nearby) {
+            if (!isFree(i)) continue;
+            float dx = entities.posX[i] - horde.centerX;
+            float dy = entities.posY[i] - horde.centerY;
+            if (dx * dx + dy * dy < reach * reach) entities.horde[i] = h + 1;
+        }
+    }
+    
+    // ...and overlapping hordes merge into the earlier one (the refresh renumbers)
+    hordeRemap.resize(hordes.size() + 1);
+    for (uint32_t h = 0; h <= hordes.size(); h++) hordeRemap[h] = h;
+    for (uint32_t a = 0; a < hordes.size(); a++) {
+        if (hordeRemap[a + 1] != a + 1 || hordes[a].radius >= kHordeMaxRadius) continue;
+        for (uint32_t b = a + 1; b < hordes.size(); b++) {
+            if (hordeRemap[b + 1] != b + 1) continue;
+            float dx = hordes[b].centerX - hordes[a].centerX;
+            float dy = hordes[b].centerY - hordes[a].centerY;
+            float reach = hordes[a].radius + hordes[b].radius;
+            if (dx * dx + dy * dy < reach * reach) hordeRemap[b + 1] = a + 1;
+        }
+    }
+    for (size_t i = 0; i < entities.count; i++) {
+        entities.horde[i] = hordeRemap[entities.horde[i]];
+    }
+    
+    // New hordes around free patrolling zombies with a big, calm pack around them
+    for (uint32_t i = 0; i < entities.count; i++) {
+        if (!isFree(i)) continue;
+        float px = entities.posX[i];
+        float py = entities.posY[i];
+        const SpatialHash::Neighborhood near = spatialHash.neighborhood(px, py);
+        if (near.total.count[KindZombie] < kHordeMinSize || near.has(kHordeAlive)) continue;
+        if (spatialHash.kindsInRange(px, py, kHordeGatherRadius + kSeekRadius) & kHordeAlive) continue;
         
-        // Apply sharp turn when near walls by directly modifying velocity direction
-        if (nearWall) {
-            // Blend wall avoidance direction with current velocity
-            float blendFactor = 0.7f;  // Strong influence
-            entities.velX[i] = entities.velX[i] * (1.0f - blendFactor) + wallAvoidX * targetSpeed * blendFactor;
-            entities.velY[i] = entities.velY[i] * (1.0f - blendFactor) + wallAvoidY * targetSpeed * blendFactor;
+        near.collect(kindMask(KindZombie), nearby);
+        uint32_t members = 0;
+        for (uint32_t j : nearby) {
+            float dx = entities.posX[j] - px;
+            float dy = entities.posY[j] - py;
+            if (isFree(j) && dx * dx + dy * dy < kHordeGatherRadius * kHordeGatherRadius) members++;
         }
+        if (members < kHordeMinSize) continue;
         
-        // Clamp to max speed
-        float speedSq = entities.velX[i] * entities.velX[i] + entities.velY[i] * entities.velY[i];
-        float maxSpeed = targetSpeed * 1.1f;
-        if (speedSq > maxSpeed * maxSpeed) {
-            float speed = std::sqrt(speedSq);
-            entities.velX[i] = (entities.velX[i] / speed) * maxSpeed;
-            entities.velY[i] = (entities.velY[i] / speed) * maxSpeed;
+        const uint32_t id = static_cast<uint32_t>(hordes.size()) + 1;
+        for (uint32_t j : nearby) {
+            float dx = entities.posX[j] - px;
+            float dy = entities.posY[j] - py;
+            if (isFree(j) && dx * dx + dy * dy < kHordeGatherRadius * kHordeGatherRadius) entities.horde[j] = id;
         }
+        Horde horde{};
+        horde.centerX = px;
+        horde.centerY = py;
+        horde.radius = kHordeGatherRadius;
+        horde.targetX = entities.patrolTargetX[i];  // Carry on where the seed was heading
+        horde.targetY = entities.patrolTargetY[i];
+        horde.retargetTick = ticksFromNow(hordeTravelSeconds(horde.targetX - px, horde.targetY - py));
+        hordes.push_back(horde);
     }
 }
 
@@ -1094,116 +1929,114 @@ void Simulation::updateInfections() {
     const float meleeRangeSq = meleeRange * meleeRange;
     const float feedRange = 20.0f;  // Range to feed on corpses
     const float feedRangeSq = feedRange * feedRange;
-    const float dt = 1.0f / 60.0f;
     
-    std::vector<size_t> zombiesToKill;  // Track zombies to remove
-    std::vector<size_t> entitiesToKill;  // Track entities to remove
-    std::vector<size_t> corpsesToRemove;  // Track corpses that get eaten
-    std::vector<uint32_t> localNeighbors;
-    localNeighbors.reserve(200);
+    FrameArena& arena = frameArena();
+    ArenaVector<size_t> zombiesToKill = makeArenaVector<size_t>(arena);  // Track zombies to remove
+    ArenaVector<size_t> entitiesToKill = makeArenaVector<size_t>(arena);  // Track entities to remove
+    ArenaVector<size_t> corpsesToRemove = makeArenaVector<size_t>(arena);  // Track corpses that get eaten
+    ArenaVector<uint32_t> localNeighbors = makeArenaVector<uint32_t>(arena, 200);
     
-    // Update bitten civilians (infection progression)
-    for (size_t i = 0; i < entities.count; i++) {
-        // Update combat cooldown
-        if (entities.combatCooldown[i] > 0.0f) {
-            entities.combatCooldown[i] -= dt;
-        }
+    // Timers that run out this tick (Design Doc §4): only these agents are visited.
+    // Sorted so each step below handles them in index order; entries whose agent
+    // moved, died or changed state since scheduling fail the deadline/state checks.
+    ArenaVector<uint32_t> due = makeArenaVector<uint32_t>(arena);
+    stateTimers.collect(tickCount, due);
+    std::sort(due.begin(), due.end());
+    due.erase(std::unique(due.begin(), due.end()), due.end());
+    const uint32_t now = timerNow();
+    auto expires = [this, now](uint32_t i, AgentState state) {
+        return i < entities.count && entities.state[i] == state && entities.stateDeadline[i] == now &&
+               !entities.ghost[i];
+    };
+    
+    // Bitten civilians whose infection ran out
+    for (uint32_t i : due) {
+        if (!expires(i, AgentState::Bitten)) continue;
         
-        if (entities.state[i] == AgentState::Bitten) {
-            entities.infectionTimer[i] -= dt;
-            entities.infectionProgress[i] = 1.0f - std::max(0.0f, entities.infectionTimer[i] / 15.0f);
-            
-            if (entities.infectionTimer[i] <= 0.0f) {
-                // Infection kills civilian - becomes corpse
-                entities.state[i] = AgentState::Dead;
-                entities.velX[i] = 0.0f;
-                entities.velY[i] = 0.0f;
-                entities.reanimationTimer[i] = 3.0f + (GetRandomValue(0, 50) / 10.0f);
-                spdlog::info("Civilian {} died from infection! Will reanimate in {:.1f}s", i, entities.reanimationTimer[i]);
-            }
-        }
+        // Infection kills civilian - becomes corpse
+        setState(i, AgentState::Dead);
+        entities.velX[i] = 0.0f;
+        entities.velY[i] = 0.0f;
+        float reanimateIn = 3.0f + (rng.range(0, 50) / 10.0f);
+        startStateTimer(i, reanimateIn);
+        tickEvents.infectionDeaths++;
+        eventLog.emit(EventKind::InfectionDeath, tickCount, i, 0, reanimateIn);
     }
     
-    // Update reanimation timers for dead civilians
-    for (size_t i = 0; i < entities.count; i++) {
-        if (entities.state[i] == AgentState::Dead && entities.type[i] == AgentType::Civilian) {
-            entities.reanimationTimer[i] -= dt;
-            
-            if (entities.reanimationTimer[i] <= 0.0f) {
-                // Reanimate as zombie!
-                entities.type[i] = AgentType::Zombie;
-                entities.state[i] = AgentState::Patrol;
-                entities.health[i] = 3;
-                entities.meleeAttackCooldown[i] = 0.0f;
-                entities.velX[i] = (GetRandomValue(-10, 10) / 10.0f) * 20.0f;
-                entities.velY[i] = (GetRandomValue(-10, 10) / 10.0f) * 20.0f;
-                spdlog::info("Corpse {} reanimated as zombie!", i);
-            }
-        }
+    // Dead civilians due to reanimate
+    for (uint32_t i : due) {
+        if (!expires(i, AgentState::Dead) || entities.type[i] != AgentType::Civilian) continue;
+        
+        // Reanimate as zombie!
+        entities.type[i] = AgentType::Zombie;
+        thinkNow(i);  // Re-evaluate as a zombie next tick
+        setState(i, AgentState::Patrol);
+        entities.health[i] = 3;
+        entities.meleeAttackCooldown[i] = 0.0f;
+        entities.velX[i] = (rng.range(-10, 10) / 10.0f) * 20.0f;
+        entities.velY[i] = (rng.range(-10, 10) / 10.0f) * 20.0f;
+        tickEvents.reanimations++;
+        eventLog.emit(EventKind::Reanimated, tickCount, i);
     }
     
-    // Update ongoing combat
-    for (size_t i = 0; i < entities.count; i++) {
-        if (entities.state[i] == AgentState::Fighting) {
-            entities.combatTimer[i] -= dt;
+    // Combats that resolve this tick
+    for (uint32_t i : due) {
+        if (!expires(i, AgentState::Fighting)) continue;
+        
+        // Combat resolves!
+        uint32_t targetIdx = entities.combatTarget[i];
+        if (targetIdx >= entities.count) {
+            // Target gone, exit combat
+            setState(i, AgentState::Patrol);
+            entities.combatTarget[i] = UINT32_MAX;
+            continue;
+        }
+        
+        AgentType myType = entities.type[i];
+        AgentType targetType = entities.type[targetIdx];
+        
+        // Count nearby allies and enemies for bonuses
+        float px = entities.posX[i];
+        float py = entities.posY[i];
+        spatialHash.queryNeighbors(px, py, 50.0f, localNeighbors);
+        
+        int nearbyAllies = 0;
+        int nearbyEnemies = 0;
+        for (uint32_t idx : localNeighbors) {
+            if (idx == i || idx == targetIdx) continue;
+            if (entities.type[idx] == myType) nearbyAllies++;
+            else if (entities.type[idx] == targetType) nearbyEnemies++;
+        }
+        
+        // Resolve combat based on types
+        if (myType == AgentType::Zombie && targetType == AgentType::Civilian) {
+            resolveCivilianVsZombieCombat(i, targetIdx, nearbyAllies, nearbyEnemies, zombiesToKill, entitiesToKill);
+        } else if (myType == AgentType::Civilian && targetType == AgentType::Zombie) {
+            resolveCivilianVsZombieCombat(targetIdx, i, nearbyEnemies, nearbyAllies, zombiesToKill, entitiesToKill);
+        } else if (myType == AgentType::Hero || targetType == AgentType::Hero) {
+            resolveHeroVsZombieCombat(i, targetIdx, zombiesToKill, entitiesToKill);
+        }
+        
+        // Exit combat state
+        setState(i, AgentState::Patrol);
+        entities.combatTarget[i] = UINT32_MAX;
+        entities.combatReadyTick[i] = ticksFromNow(2.0f);  // 2 second cooldown
+        
+        if (targetIdx < entities.count && entities.state[targetIdx] == AgentState::Fighting) {
+            setState(targetIdx, AgentState::Patrol);
+            entities.combatTarget[targetIdx] = UINT32_MAX;
+            entities.combatReadyTick[targetIdx] = ticksFromNow(2.0f);
             
-            if (entities.combatTimer[i] <= 0.0f) {
-                // Combat resolves!
-                uint32_t targetIdx = entities.combatTarget[i];
-                if (targetIdx >= entities.count) {
-                    // Target gone, exit combat
-                    entities.state[i] = AgentState::Patrol;
-                    entities.combatTarget[i] = UINT32_MAX;
-                    continue;
-                }
-                
-                AgentType myType = entities.type[i];
-                AgentType targetType = entities.type[targetIdx];
-                
-                // Count nearby allies and enemies for bonuses
-                float px = entities.posX[i];
-                float py = entities.posY[i];
-                spatialHash.queryNeighbors(px, py, 50.0f, localNeighbors);
-                
-                int nearbyAllies = 0;
-                int nearbyEnemies = 0;
-                for (uint32_t idx : localNeighbors) {
-                    if (idx == i || idx == targetIdx) continue;
-                    if (entities.type[idx] == myType) nearbyAllies++;
-                    else if (entities.type[idx] == targetType) nearbyEnemies++;
-                }
-                
-                // Resolve combat based on types
-                if (myType == AgentType::Zombie && targetType == AgentType::Civilian) {
-                    resolveCivilianVsZombieCombat(i, targetIdx, nearbyAllies, nearbyEnemies, zombiesToKill, entitiesToKill);
-                } else if (myType == AgentType::Civilian && targetType == AgentType::Zombie) {
-                    resolveCivilianVsZombieCombat(targetIdx, i, nearbyEnemies, nearbyAllies, zombiesToKill, entitiesToKill);
-                } else if (myType == AgentType::Hero || targetType == AgentType::Hero) {
-                    resolveHeroVsZombieCombat(i, targetIdx, zombiesToKill, entitiesToKill);
-                }
-                
-                // Exit combat state
-                entities.state[i] = AgentState::Patrol;
-                entities.combatTarget[i] = UINT32_MAX;
-                entities.combatCooldown[i] = 2.0f;  // 2 second cooldown
-                
-                if (targetIdx < entities.count && entities.state[targetIdx] == AgentState::Fighting) {
-                    entities.state[targetIdx] = AgentState::Patrol;
-                    entities.combatTarget[targetIdx] = UINT32_MAX;
-                    entities.combatCooldown[targetIdx] = 2.0f;
-                    
-                    // Push agents apart to prevent immediate re-engagement
-                    float dx = entities.posX[i] - entities.posX[targetIdx];
-                    float dy = entities.posY[i] - entities.posY[targetIdx];
-                    float dist = std::sqrt(dx * dx + dy * dy + 0.01f);
-                    float separationDist = 25.0f;  // Push 25px apart
-                    
-                    entities.posX[i] += (dx / dist) * separationDist * 0.5f;
-                    entities.posY[i] += (dy / dist) * separationDist * 0.5f;
-                    entities.posX[targetIdx] -= (dx / dist) * separationDist * 0.5f;
-                    entities.posY[targetIdx] -= (dy / dist) * separationDist * 0.5f;
-                }
-            }
+            // Push agents apart to prevent immediate re-engagement
+            float dx = entities.posX[i] - entities.posX[targetIdx];
+            float dy = entities.posY[i] - entities.posY[targetIdx];
+            float dist = std::sqrt(dx * dx + dy * dy + 0.01f);
+            float separationDist = 25.0f;  // Push 25px apart
+            
+            entities.posX[i] += (dx / dist) * separationDist * 0.5f;
+            entities.posY[i] += (dy / dist) * separationDist * 0.5f;
+            entities.posX[targetIdx] -= (dx / dist) * separationDist * 0.5f;
+            entities.posY[targetIdx] -= (dy / dist) * separationDist * 0.5f;
         }
     }
     
@@ -1211,7 +2044,9 @@ void Simulation::updateInfections() {
     for (size_t i = 0; i < entities.count; i++) {
         if (entities.type[i] != AgentType::Zombie) continue;
         if (entities.state[i] == AgentState::Fighting || entities.state[i] == AgentState::Dead) continue;
-        if (entities.combatCooldown[i] > 0.0f) continue;  // Still on cooldown
+        if (entities.combatReadyTick[i] > now) continue;  // Still on cooldown
+        if (entities.horde[i] != 0) continue;  // Nobody alive within seek range of a horde
+        if (entities.ghost[i]) continue;
         
         float px = entities.posX[i];
         float py = entities.posY[i];
@@ -1226,7 +2061,8 @@ void Simulation::updateInfections() {
             
             // Skip if already fighting, dead, or bitten
             if (otherState == AgentState::Dead || otherState == AgentState::Fighting || otherState == AgentState::Bitten) continue;
-            if (entities.combatCooldown[j] > 0.0f) continue;  // Target on cooldown
+            if (entities.combatReadyTick[j] > now) continue;  // Target on cooldown
+            if (entities.ghost[j]) continue;  // Owned by another region
             if (otherType != AgentType::Civilian && otherType != AgentType::Hero) continue;
             
             float dx = entities.posX[i] - entities.posX[j];
@@ -1235,8 +2071,8 @@ void Simulation::updateInfections() {
             
             if (distSq < meleeRangeSq) {
                 // Initiate combat!
-                entities.state[i] = AgentState::Fighting;
-                entities.state[j] = AgentState::Fighting;
+                setState(i, AgentState::Fighting);
+                setState(j, AgentState::Fighting);
                 entities.combatTarget[i] = j;
                 entities.combatTarget[j] = i;
                 
@@ -1248,21 +2084,23 @@ void Simulation::updateInfections() {
                 
                 // Combat duration: 2-4 seconds (heroes fight faster)
                 float duration = (otherType == AgentType::Hero) ? 
-                    (1.0f + GetRandomValue(0, 10) / 10.0f) : 
-                    (2.0f + GetRandomValue(0, 20) / 10.0f);
+                    (1.0f + rng.range(0, 10) / 10.0f) : 
+                    (2.0f + rng.range(0, 20) / 10.0f);
                     
-                entities.combatTimer[i] = duration;
-                entities.combatTimer[j] = duration;
+                startStateTimer(i, duration);
+                startStateTimer(j, duration);
+                tickEvents.combatsStarted++;
                 
-                spdlog::info("Combat initiated: {} vs {} ({:.1f}s)", i, j, duration);
+                eventLog.emit(EventKind::CombatStarted, tickCount, static_cast<uint32_t>(i), j, duration);
                 break;  // One combat initiation per zombie per frame
             }
         }
     }
     
     // Zombie corpse feeding - regenerate health by consuming bodies
-    for (size_t i = 0; i < entities.count; i++) {
-        if (entities.type[i] != AgentType::Zombie) continue;
+    const bool anyCorpses = !stateLists[DeadList].empty();
+    for (size_t i = 0; anyCorpses && i < entities.count; i++) {
+        if (entities.type[i] != AgentType::Zombie || entities.ghost[i]) continue;
         
         // Only feed if injured (health < 3)
         if (entities.health[i] >= 3) continue;
@@ -1278,6 +2116,7 @@ void Simulation::updateInfections() {
             // Look for corpses
             if (entities.state[j] != AgentState::Dead) continue;
             if (entities.type[j] != AgentType::Civilian) continue;  // Only feed on civilian corpses
+            if (entities.ghost[j]) continue;
             
             float dx = entities.posX[i] - entities.posX[j];
             float dy = entities.posY[i] - entities.posY[j];
@@ -1287,7 +2126,8 @@ void Simulation::updateInfections() {
                 // Zombie feeds on corpse
                 entities.health[i] = std::min(static_cast<uint8_t>(3), static_cast<uint8_t>(entities.health[i] + 1));
                 corpsesToRemove.push_back(j);
-                spdlog::info("Zombie {} fed on corpse {}, health now {}", i, j, entities.health[i]);
+                tickEvents.corpsesEaten++;
+                eventLog.emit(EventKind::ZombieFed, tickCount, static_cast<uint32_t>(i), j, entities.health[i]);
                 break;  // One corpse per zombie per frame
             }
         }
@@ -1298,136 +2138,20 @@ void Simulation::updateInfections() {
     corpsesToRemove.erase(std::unique(corpsesToRemove.begin(), corpsesToRemove.end()), corpsesToRemove.end());
     
     for (size_t idx : corpsesToRemove) {
-        // Remove by swapping with last element and reducing count
-        size_t lastIdx = entities.count - 1;
-        if (idx != lastIdx) {
-            entities.posX[idx] = entities.posX[lastIdx];
-            entities.posY[idx] = entities.posY[lastIdx];
-            entities.velX[idx] = entities.velX[lastIdx];
-            entities.velY[idx] = entities.velY[lastIdx];
-            entities.dirX[idx] = entities.dirX[lastIdx];
-            entities.dirY[idx] = entities.dirY[lastIdx];
-            entities.type[idx] = entities.type[lastIdx];
-            entities.state[idx] = entities.state[lastIdx];
-            entities.health[idx] = entities.health[lastIdx];
-            entities.lastSeenX[idx] = entities.lastSeenX[lastIdx];
-            entities.lastSeenY[idx] = entities.lastSeenY[lastIdx];
-            entities.searchTimer[idx] = entities.searchTimer[lastIdx];
-            entities.patrolTargetX[idx] = entities.patrolTargetX[lastIdx];
-            entities.patrolTargetY[idx] = entities.patrolTargetY[lastIdx];
-            entities.shootCooldown[idx] = entities.shootCooldown[lastIdx];
-            entities.aimTimer[idx] = entities.aimTimer[lastIdx];
-            entities.fleeStrategy[idx] = entities.fleeStrategy[lastIdx];
-            entities.heroType[idx] = entities.heroType[lastIdx];
-            entities.reanimationTimer[idx] = entities.reanimationTimer[lastIdx];
-            entities.meleeAttackCooldown[idx] = entities.meleeAttackCooldown[lastIdx];
-            entities.combatTarget[idx] = entities.combatTarget[lastIdx];
-            entities.combatTimer[idx] = entities.combatTimer[lastIdx];
-            entities.combatCooldown[idx] = entities.combatCooldown[lastIdx];
-            entities.infectionTimer[idx] = entities.infectionTimer[lastIdx];
-            entities.infectionProgress[idx] = entities.infectionProgress[lastIdx];
-            prevPosX[idx] = prevPosX[lastIdx];
-            prevPosY[idx] = prevPosY[lastIdx];
-        }
-        entities.count--;
-        entities.posX.pop_back();
-        entities.posY.pop_back();
-        entities.velX.pop_back();
-        entities.velY.pop_back();
-        entities.dirX.pop_back();
-        entities.dirY.pop_back();
-        entities.type.pop_back();
-        entities.state.pop_back();
-        entities.health.pop_back();
-        entities.lastSeenX.pop_back();
-        entities.lastSeenY.pop_back();
-        entities.searchTimer.pop_back();
-        entities.patrolTargetX.pop_back();
-        entities.patrolTargetY.pop_back();
-        entities.shootCooldown.pop_back();
-        entities.aimTimer.pop_back();
-        entities.fleeStrategy.pop_back();
-        entities.heroType.pop_back();
-        entities.reanimationTimer.pop_back();
-        entities.meleeAttackCooldown.pop_back();
-        entities.combatTarget.pop_back();
-        entities.combatTimer.pop_back();
-        entities.combatCooldown.pop_back();
-        entities.infectionTimer.pop_back();
-        entities.infectionProgress.pop_back();
-        prevPosX.pop_back();
-        prevPosY.pop_back();
+        removeEntity(idx);
     }
     
     // Remove killed zombies (iterate backwards to maintain indices)
     std::sort(zombiesToKill.begin(), zombiesToKill.end(), std::greater<size_t>());
     for (size_t idx : zombiesToKill) {
-        // Remove by swapping with last element and reducing count
-        size_t lastIdx = entities.count - 1;
-        if (idx != lastIdx) {
-            entities.posX[idx] = entities.posX[lastIdx];
-            entities.posY[idx] = entities.posY[lastIdx];
-            entities.velX[idx] = entities.velX[lastIdx];
-            entities.velY[idx] = entities.velY[lastIdx];
-            entities.dirX[idx] = entities.dirX[lastIdx];
-            entities.dirY[idx] = entities.dirY[lastIdx];
-            entities.type[idx] = entities.type[lastIdx];
-            entities.state[idx] = entities.state[lastIdx];
-            entities.health[idx] = entities.health[lastIdx];
-            entities.lastSeenX[idx] = entities.lastSeenX[lastIdx];
-            entities.lastSeenY[idx] = entities.lastSeenY[lastIdx];
-            entities.searchTimer[idx] = entities.searchTimer[lastIdx];
-            entities.patrolTargetX[idx] = entities.patrolTargetX[lastIdx];
-            entities.patrolTargetY[idx] = entities.patrolTargetY[lastIdx];
-            entities.shootCooldown[idx] = entities.shootCooldown[lastIdx];
-            entities.aimTimer[idx] = entities.aimTimer[lastIdx];
-            entities.fleeStrategy[idx] = entities.fleeStrategy[lastIdx];
-            entities.heroType[idx] = entities.heroType[lastIdx];
-            entities.reanimationTimer[idx] = entities.reanimationTimer[lastIdx];
-            entities.meleeAttackCooldown[idx] = entities.meleeAttackCooldown[lastIdx];
-            entities.combatTarget[idx] = entities.combatTarget[lastIdx];
-            entities.combatTimer[idx] = entities.combatTimer[lastIdx];
-            entities.combatCooldown[idx] = entities.combatCooldown[lastIdx];
-            entities.infectionTimer[idx] = entities.infectionTimer[lastIdx];
-            entities.infectionProgress[idx] = entities.infectionProgress[lastIdx];
-            prevPosX[idx] = prevPosX[lastIdx];
-            prevPosY[idx] = prevPosY[lastIdx];
-        }
-        entities.count--;
-        entities.posX.pop_back();
-        entities.posY.pop_back();
-        entities.velX.pop_back();
-        entities.velY.pop_back();
-        entities.dirX.pop_back();
-        entities.dirY.pop_back();
-        entities.type.pop_back();
-        entities.state.pop_back();
-        entities.health.pop_back();
-        entities.lastSeenX.pop_back();
-        entities.lastSeenY.pop_back();
-        entities.searchTimer.pop_back();
-        entities.patrolTargetX.pop_back();
-        entities.patrolTargetY.pop_back();
-        entities.shootCooldown.pop_back();
-        entities.aimTimer.pop_back();
-        entities.fleeStrategy.pop_back();
-        entities.heroType.pop_back();
-        entities.reanimationTimer.pop_back();
-        entities.meleeAttackCooldown.pop_back();
-        entities.combatTarget.pop_back();
-        entities.combatTimer.pop_back();
-        entities.combatCooldown.pop_back();
-        entities.infectionTimer.pop_back();
-        entities.infectionProgress.pop_back();
-        prevPosX.pop_back();
-        prevPosY.pop_back();
+        removeEntity(idx);
     }
 }
 
 void Simulation::resolveCivilianVsZombieCombat(size_t zombieIdx, size_t civilianIdx,
                                                 int zombieAllies, int civilianAllies,
-                                                std::vector<size_t>& zombiesToKill,
-                                                std::vector<size_t>& entitiesToKill) {
+                                                ArenaVector<size_t>& zombiesToKill,
+                                                ArenaVector<size_t>& entitiesToKill) {
     // Calculate outcome probabilities based on group sizes
     float survivalBonus = std::min(0.30f, civilianAllies * 0.15f);
     float hordePenalty = std::min(0.25f, zombieAllies * 0.08f);
@@ -1438,54 +2162,58 @@ void Simulation::resolveCivilianVsZombieCombat(size_t zombieIdx, size_t civilian
     float deathChance = 0.45f + hordePenalty - survivalBonus;
     
     // Roll outcome
-    int roll = GetRandomValue(0, 99);
+    int roll = rng.range(0, 99);
     float cumulative = 0.0f;
     
     if (roll < (cumulative += killChance * 100.0f)) {
         // Civilian kills zombie!
         zombiesToKill.push_back(zombieIdx);
-        entities.state[civilianIdx] = AgentState::Fleeing;  // Run away
-        spdlog::info("Civilian {} killed zombie {}!", civilianIdx, zombieIdx);
+        setState(civilianIdx, AgentState::Fleeing);  // Run away
+        tickEvents.zombiesKilledByCivilians++;
+        eventLog.emit(EventKind::CivilianKilledZombie, tickCount, static_cast<uint32_t>(civilianIdx), static_cast<uint32_t>(zombieIdx));
     }
     else if (roll < (cumulative += killButBittenChance * 100.0f)) {
         // Pyrrhic victory - kills zombie but gets bitten
         zombiesToKill.push_back(zombieIdx);
-        entities.state[civilianIdx] = AgentState::Bitten;
-        entities.infectionTimer[civilianIdx] = 5.0f + (GetRandomValue(0, 100) / 10.0f);  // 5-15 seconds
-        entities.infectionProgress[civilianIdx] = 0.0f;
-        spdlog::info("Civilian {} killed zombie {} but was bitten!", civilianIdx, zombieIdx);
+        setState(civilianIdx, AgentState::Bitten);
+        startStateTimer(civilianIdx, 5.0f + (rng.range(0, 100) / 10.0f));  // 5-15 seconds
+        tickEvents.zombiesKilledByCivilians++;
+        tickEvents.civiliansBitten++;
+        eventLog.emit(EventKind::CivilianPyrrhicKill, tickCount, static_cast<uint32_t>(civilianIdx), static_cast<uint32_t>(zombieIdx));
     }
     else if (roll < (cumulative += bittenEscapeChance * 100.0f)) {
         // Bitten and escapes
-        entities.state[civilianIdx] = AgentState::Bitten;
-        entities.infectionTimer[civilianIdx] = 5.0f + (GetRandomValue(0, 100) / 10.0f);
-        entities.infectionProgress[civilianIdx] = 0.0f;
-        spdlog::info("Civilian {} escaped but was bitten!", civilianIdx);
+        setState(civilianIdx, AgentState::Bitten);
+        startStateTimer(civilianIdx, 5.0f + (rng.range(0, 100) / 10.0f));
+        tickEvents.civiliansBitten++;
+        eventLog.emit(EventKind::CivilianBitten, tickCount, static_cast<uint32_t>(civilianIdx));
     }
     else {
         // Killed - becomes corpse
-        entities.state[civilianIdx] = AgentState::Dead;
+        setState(civilianIdx, AgentState::Dead);
         entities.velX[civilianIdx] = 0.0f;
         entities.velY[civilianIdx] = 0.0f;
-        entities.reanimationTimer[civilianIdx] = 3.0f + (GetRandomValue(0, 50) / 10.0f);
-        spdlog::info("Civilian {} was killed by zombie {}!", civilianIdx, zombieIdx);
+        startStateTimer(civilianIdx, 3.0f + (rng.range(0, 50) / 10.0f));
+        tickEvents.civiliansKilled++;
+        eventLog.emit(EventKind::CivilianKilled, tickCount, static_cast<uint32_t>(civilianIdx), static_cast<uint32_t>(zombieIdx));
     }
 }
 
 void Simulation::resolveHeroVsZombieCombat(size_t heroIdx, size_t zombieIdx,
-                                           std::vector<size_t>& zombiesToKill,
-                                           std::vector<size_t>& entitiesToKill) {
+                                           ArenaVector<size_t>& zombiesToKill,
+                                           ArenaVector<size_t>& entitiesToKill) {
     // Determine which is hero
     size_t actualHeroIdx = (entities.type[heroIdx] == AgentType::Hero) ? heroIdx : zombieIdx;
     size_t actualZombieIdx = (actualHeroIdx == heroIdx) ? zombieIdx : heroIdx;
     
-    int roll = GetRandomValue(0, 99);
+    int roll = rng.range(0, 99);
     
     if (roll < 80) {
         // Hero wins - kills zombie
         zombiesToKill.push_back(actualZombieIdx);
-        entities.state[actualHeroIdx] = AgentState::Pursuing;  // Continue hunting
-        spdlog::info("Hero {} killed zombie {}!", actualHeroIdx, actualZombieIdx);
+        setState(actualHeroIdx, AgentState::Pursuing);  // Continue hunting
+        tickEvents.zombiesKilledByHeroes++;
+        eventLog.emit(EventKind::HeroKilledZombie, tickCount, static_cast<uint32_t>(actualHeroIdx), static_cast<uint32_t>(actualZombieIdx));
     }
     else {
         // Hero takes damage
@@ -1493,6 +2221,7 @@ void Simulation::resolveHeroVsZombieCombat(size_t heroIdx, size_t zombieIdx,
             entities.health[actualZombieIdx]--;
             if (entities.health[actualZombieIdx] == 0) {
                 zombiesToKill.push_back(actualZombieIdx);
+                tickEvents.zombiesKilledByHeroes++;
             }
         }
         
@@ -1501,11 +2230,132 @@ void Simulation::resolveHeroVsZombieCombat(size_t heroIdx, size_t zombieIdx,
             if (entities.health[actualHeroIdx] == 0) {
                 // Hero exhausted, becomes zombie
                 entities.type[actualHeroIdx] = AgentType::Zombie;
+                thinkNow(actualHeroIdx);  // Re-evaluate as a zombie next tick
                 entities.health[actualHeroIdx] = 3;
-                spdlog::info("Hero {} exhausted and turned zombie!", actualHeroIdx);
+                tickEvents.heroesTurned++;
+                eventLog.emit(EventKind::HeroExhausted, tickCount, static_cast<uint32_t>(actualHeroIdx));
             }
         }
-        spdlog::info("Hero {} vs Zombie {} - both damaged!", actualHeroIdx, actualZombieIdx);
+        eventLog.emit(EventKind::HeroTraded, tickCount, static_cast<uint32_t>(actualHeroIdx), static_cast<uint32_t>(actualZombieIdx));
+    }
+}
+
+// Spatial partitioning (Region.hpp). A record is every column of one agent back to
+// back in forEachColumn order, then its interpolation position. Regions run the same
+// build and tick in lockstep, so deadlines (absolute ticks) carry over unchanged;
+// indices into the sender's columns (combat targets, hordes) do not.
+size_t Simulation::getAgentRecordBytes() const {
+    return entities.bytesPerEntity() + 2 * sizeof(float);
+}
+
+void Simulation::packAgents(const uint32_t* indices, size_t count, std::vector<uint8_t>& out) const {
+    size_t offset = out.size();
+    out.resize(offset + count * getAgentRecordBytes());
+    uint8_t* dst = out.data() + offset;
+    for (size_t n = 0; n < count; n++) {
+        const uint32_t i = indices[n];
+        entities.forEachColumn([&dst, i](const char*, const auto& column) {
+            std::memcpy(dst, &column[i], sizeof(column[i]));
+            dst += sizeof(column[i]);
+        });
+        std::memcpy(dst, &prevPosX[i], sizeof(float));
+        std::memcpy(dst + sizeof(float), &prevPosY[i], sizeof(float));
+        dst += 2 * sizeof(float);
+    }
+}
+
+void Simulation::unpackAgents(const uint8_t* records, size_t count, bool asGhosts) {
+    if (count == 0) return;
+    const size_t first = entities.count;
+    const size_t newCount = first + count;
+    entities.ensureCapacity(newCount);
+    entities.resize(newCount);
+    stateTimers.reserve(entities.capacity());
+    reserveAgentLists();
+    prevPosX.resize(newCount);
+    prevPosY.resize(newCount);
+    
+    const uint8_t* src = records;
+    for (size_t i = first; i < newCount; i++) {
+        entities.forEachColumn([&src, i](const char*, auto& column) {
+            std::memcpy(&column[i], src, sizeof(column[i]));
+            src += sizeof(column[i]);
+        });
+        std::memcpy(&prevPosX[i], src, sizeof(float));
+        std::memcpy(&prevPosY[i], src + sizeof(float), sizeof(float));
+        src += 2 * sizeof(float);
+        
+        // Sender-side indices mean nothing here: a fighter keeps its (owned) timer
+        // but loses its opponent, and hordes are formed per region
+        entities.combatTarget[i] = UINT32_MAX;
+        entities.horde[i] = 0;
+        thinkNow(i);
+        entities.ghost[i] = asGhosts ? 1 : 0;
+        // A hero that fired this tick already had its shot resolved by the sender
+        // (see the ranged kill pass in tick())
+        if (entities.shootCooldown[i] > 1.45f) entities.shootCooldown[i] = 1.45f;
+        
+        int list = stateListOf(entities.state[i]);
+        if (list >= 0) {
+            entities.stateSlot[i] = static_cast<uint32_t>(stateLists[list].size());
+            stateLists[list].push_back(static_cast<uint32_t>(i));
+        }
+        int32_t ahead = static_cast<int32_t>(entities.stateDeadline[i] - timerNow());
+        if (!asGhosts && hasStateTimer(i) && ahead >= 0) {
+            stateTimers.schedule(static_cast<uint32_t>(i), tickCount + ahead, tickCount);
+        }
+    }
+    if (asGhosts) ghostCount += count;
+}
+
+void Simulation::removeKeepingCombat(size_t idx) {
+    const size_t last = entities.count - 1;
+    removeEntity(idx);
+    if (idx == last || entities.state[idx] != AgentState::Fighting) return;
+    uint32_t opponent = entities.combatTarget[idx];
+    if (opponent < entities.count && entities.combatTarget[opponent] == last) {
+        entities.combatTarget[opponent] = static_cast<uint32_t>(idx);
+    }
+}
+
+void Simulation::removeAgents(std::vector<uint32_t>& indices) {
+    std::sort(indices.begin(), indices.end(), std::greater<uint32_t>());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    for (uint32_t idx : indices) {
+        removeKeepingCombat(idx);
+    }
+}
+
+void Simulation::setVelocities(const uint32_t* indices, size_t count, const float* velX, const float* velY) {
+    for (size_t n = 0; n < count; n++) {
+        const uint32_t i = indices[n];
+        if (i >= entities.count) continue;
+        entities.velX[i] = velX[n];
+        entities.velY[i] = velY[n];
+    }
+}
+
+void Simulation::killAgents(std::vector<uint32_t>& indices) {
+    indices.erase(std::remove_if(indices.begin(), indices.end(), [this](uint32_t i) {
+        return i >= entities.count || entities.ghost[i];
+    }), indices.end());
+    // Opponents leave combat when their timer runs out instead of fighting whoever
+    // moves into the slot
+    for (uint32_t i : indices) {
+        if (entities.state[i] != AgentState::Fighting) continue;
+        const uint32_t opponent = entities.combatTarget[i];
+        if (opponent < entities.count) entities.combatTarget[opponent] = UINT32_MAX;
+    }
+    removeAgents(indices);
+}
+
+void Simulation::removeGhosts() {
+    // Ghosts were appended after every owned agent, so most are removed from the end
+    // and only the few owned agents swapped into their slots during the tick move back
+    for (size_t i = entities.count; ghostCount > 0 && i-- > 0;) {
+        if (!entities.ghost[i]) continue;
+        removeKeepingCombat(i);
+        ghostCount--;
     }
 }
 
@@ -1513,7 +2363,7 @@ void Simulation::draw(float alpha) {
     // Draw simulation world boundary
     const float borderThickness = 3.0f;
     DrawRectangleLinesEx(
-        Rectangle{0, 0, static_cast<float>(screenWidth), static_cast<float>(screenHeight)},
+        Rectangle{0, 0, world.width, world.height},
         borderThickness,
         Color{100, 150, 255, 255}
     );
@@ -1537,19 +2387,25 @@ void Simulation::draw(float alpha) {
     
     // Debug: Draw grid
     if (debugGrid) {
-        const float cellSize = 50.0f;
-        for (int x = 0; x < screenWidth; x += static_cast<int>(cellSize)) {
-            DrawLine(x, 0, x, screenHeight, Color{80, 255, 100, 180});
+        const int cellSize = static_cast<int>(world.cellSize);
+        const int w = static_cast<int>(world.width);
+        const int h = static_cast<int>(world.height);
+        for (int x = 0; x < w; x += cellSize) {
+            DrawLine(x, 0, x, h, Color{80, 255, 100, 180});
+        }
+        for (int y = 0; y < h; y += cellSize) {
+            DrawLine(0, y, w, y, Color{80, 255, 100, 180});
         }
-        for (int y = 0; y < screenHeight; y += static_cast<int>(cellSize)) {
-            DrawLine(0, y, screenWidth, y, Color{80, 255, 100, 180});
+        for (const Horde& horde : hordes) {
+            DrawCircleLines(static_cast<int>(horde.centerX), static_cast<int>(horde.centerY), horde.radius,
+                            Color{200, 60, 60, 200});
         }
     }
     
     // Interpolated rendering with directional triangles
     // Triangles show movement direction - useful for AI visualization
     const float agentSize = 4.0f;
-    const float wrapThreshold = static_cast<float>(screenWidth) * 0.5f;  // Detect wrapping
+    const float wrapThreshold = world.width * 0.5f;  // Detect wrapping
     
     for (size_t i = 0; i < entities.count; i++) {
         // Check if agent wrapped this frame (large position delta)
@@ -1591,7 +2447,7 @@ void Simulation::draw(float alpha) {
             agentColor = Color{120, 40, 40, 255};
         } else if (entities.state[i] == AgentState::Bitten) {
             // Bitten civilians - color shifts from white → yellow → sickly green
-            float progress = entities.infectionProgress[i];
+            float progress = getInfectionProgress(i);
             uint8_t r = static_cast<uint8_t>(220 - progress * 70);   // 220 → 150
             uint8_t g = static_cast<uint8_t>(220 - progress * 20);   // 220 → 200
             uint8_t b = static_cast<uint8_t>(220 - progress * 120);  // 220 → 100
@@ -2,9 +2,23 @@
 #include "platform.h"
 
 #include <vector>
+#include <array>
 #include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include <functional>
+#include <memory>
+#include <bit>
 #include "SpatialHash.hpp"
 #include "JobSystem.hpp"
+#include "Random.hpp"
+#include "EventLog.hpp"
+#include "FrameArena.hpp"
+#include "Quantized.hpp"
+#include "TimerWheel.hpp"
+#include "TickGovernor.hpp"
+#include "LineOfSight.hpp"
 #include <raylib.h>
 
 // Agent types for zombie simulation
@@ -26,14 +40,31 @@ enum class AgentState : uint8_t {
     Bitten = 7     // Infected, dying slowly
 };
 
+// Storage types of the small per-agent columns. TACTIX_COMPACT_STATE quantizes them
+// and keeps think ticks as their low 16 bits (88 instead of 111 bytes per agent); the
+// default build keeps plain floats. Positions, velocities, targets and the 32-bit
+// index and deadline columns (stateDeadline, stateSlot, horde, ...) are full width
+// either way.
+#ifdef TACTIX_COMPACT_STATE
+using TimerValue = Quantized<int16_t, 10>;     // Seconds: +-32 s in ~1 ms steps
+using DirectionValue = Quantized<int16_t, 14>; // Unit vector component
+using SpeedValue = Quantized<int16_t, 7>;      // Units/s: +-256 in 1/128 steps
+using ThinkTick = uint16_t;                    // Wraps: compare with Simulation::ticksUntil
+#else
+using TimerValue = float;
+using DirectionValue = float;
+using SpeedValue = float;
+using ThinkTick = uint32_t;
+#endif
+
 // Structure of Arrays (SoA) for cache-friendly memory layout (Design Doc §2.1)
 struct EntityHot {
     std::vector<float> posX;
     std::vector<float> posY;
     std::vector<float> velX;
     std::vector<float> velY;
-    std::vector<float> dirX;  // Normalized direction for rendering
-    std::vector<float> dirY;
+    std::vector<DirectionValue> dirX;  // Normalized direction for rendering
+    std::vector<DirectionValue> dirY;
     std::vector<AgentType> type;  // Agent type
     std::vector<AgentState> state;  // Current AI state
     std::vector<uint8_t> health;  // Hero health (kills remaining), unused for others
@@ -41,123 +72,382 @@ struct EntityHot {
     // Memory system for persistent behavior
     std::vector<float> lastSeenX;  // Last known target position
     std::vector<float> lastSeenY;
-    std::vector<float> searchTimer;  // Time spent searching
+    std::vector<TimerValue> searchTimer;  // Time spent searching
     std::vector<float> patrolTargetX;  // Patrol destination
     std::vector<float> patrolTargetY;
-    std::vector<float> shootCooldown;  // Hero shooting cooldown
-    std::vector<float> aimTimer;  // Hero aiming delay before shot
+    std::vector<TimerValue> shootCooldown;  // Hero shooting cooldown
+    std::vector<TimerValue> aimTimer;  // Hero aiming delay before shot
+#ifdef TACTIX_COMPACT_STATE
+    std::vector<uint8_t> traits;  // Bit 0: flee strategy, bit 1: hero type
+#else
     std::vector<uint8_t> fleeStrategy;  // Civilian: 0=panic, 1=seek_hero
     std::vector<uint8_t> heroType;  // Hero: 0=defender, 1=hunter
-    std::vector<float> reanimationTimer;  // Time until corpse reanimates as zombie
-    std::vector<float> meleeAttackCooldown;  // Zombie melee attack cooldown
+#endif
+    std::vector<TimerValue> meleeAttackCooldown;  // Zombie melee attack cooldown
     std::vector<uint32_t> combatTarget;  // Index of opponent in locked combat
-    std::vector<float> combatTimer;  // Time remaining in combat
-    std::vector<float> combatCooldown;  // Cooldown before can enter combat again
-    std::vector<float> infectionTimer;  // Time until death from bite wound
-    std::vector<float> infectionProgress;  // 0-1 visual infection progression
+    // Tick the current timed state ends: Bitten -> dies, Dead -> reanimates,
+    // Fighting -> combat resolves (scheduled in Simulation::stateTimers)
+    std::vector<uint32_t> stateDeadline;
+    std::vector<uint32_t> combatReadyTick;  // First tick the agent can enter combat again
+    std::vector<uint32_t> stateSlot;  // Position in its state list (Dead/Fighting/Bitten only)
+    
+    // AI level of detail: perception and decisions run on nextThinkTick, and the
+    // resulting steering is reapplied every tick in between
+    std::vector<ThinkTick> nextThinkTick;
+    std::vector<ThinkTick> lastThinkTick;
+    std::vector<DirectionValue> steerDirX;  // Desired direction from the last decision (normalized)
+    std::vector<DirectionValue> steerDirY;
+    std::vector<SpeedValue> steerSpeed;
+    std::vector<uint8_t> steerActive;  // 0: no target, slow down
+    std::vector<uint32_t> horde;  // 1-based index into Simulation::hordes, 0 = simulated individually
+    std::vector<uint8_t> ghost;  // 1: read-only copy of an agent another region owns (Region.hpp)
     
     size_t count = 0;
     
+    // Visit every per-entity column with its name (snapshots, bulk resize/removal)
+    template <typename Fn>
+    void forEachColumn(Fn&& fn) {
+        fn("posX", posX); fn("posY", posY);
+        fn("velX", velX); fn("velY", velY);
+        fn("dirX", dirX); fn("dirY", dirY);
+        fn("type", type); fn("state", state); fn("health", health);
+        fn("lastSeenX", lastSeenX); fn("lastSeenY", lastSeenY);
+        fn("searchTimer", searchTimer);
+        fn("patrolTargetX", patrolTargetX); fn("patrolTargetY", patrolTargetY);
+        fn("shootCooldown", shootCooldown); fn("aimTimer", aimTimer);
+#ifdef TACTIX_COMPACT_STATE
+        fn("traits", traits);
+#else
+        fn("fleeStrategy", fleeStrategy); fn("heroType", heroType);
+#endif
+        fn("meleeAttackCooldown", meleeAttackCooldown);
+        fn("combatTarget", combatTarget);
+        fn("stateDeadline", stateDeadline); fn("combatReadyTick", combatReadyTick);
+        fn("stateSlot", stateSlot);
+        fn("nextThinkTick", nextThinkTick); fn("lastThinkTick", lastThinkTick);
+        fn("steerDirX", steerDirX); fn("steerDirY", steerDirY);
+        fn("steerSpeed", steerSpeed); fn("steerActive", steerActive);
+        fn("horde", horde); fn("ghost", ghost);
+    }
+    template <typename Fn>
+    void forEachColumn(Fn&& fn) const {
+        const_cast<EntityHot*>(this)->forEachColumn([&](const char* name, const auto& column) {
+            fn(name, column);
+        });
+    }
+    
     void reserve(size_t n) {
-        posX.reserve(n);
-        posY.reserve(n);
-        velX.reserve(n);
-        velY.reserve(n);
-        dirX.reserve(n);
-        dirY.reserve(n);
-        type.reserve(n);
-        state.reserve(n);
-        health.reserve(n);
-        lastSeenX.reserve(n);
-        lastSeenY.reserve(n);
-        searchTimer.reserve(n);
-    }
-    
-    void spawn(float px, float py, float vx, float vy, AgentType agentType) {
-        posX.push_back(px);
-        posY.push_back(py);
-        velX.push_back(vx);
-        velY.push_back(vy);
-        // Initial direction from velocity
-        float speed = std::sqrt(vx * vx + vy * vy);
-        if (speed > 0.01f) {
-            dirX.push_back(vx / speed);
-            dirY.push_back(vy / speed);
-        } else {
-            dirX.push_back(1.0f);  // Default facing right
-            dirY.push_back(0.0f);
-        }
-        type.push_back(agentType);
-        state.push_back(AgentState::Patrol);  // Start patrolling
-        health.push_back(agentType == AgentType::Hero ? 5 : (agentType == AgentType::Zombie ? 3 : 0));  // Heroes 5, Zombies 3, Civilians 0
-        lastSeenX.push_back(0.0f);
-        lastSeenY.push_back(0.0f);
-        searchTimer.push_back(0.0f);
-        // Random initial patrol target
-        patrolTargetX.push_back((float)GetRandomValue(50, 1850));
-        patrolTargetY.push_back((float)GetRandomValue(50, 1030));
-        shootCooldown.push_back(0.0f);
-        aimTimer.push_back(0.0f);
-        fleeStrategy.push_back(0);  // Default panic flee
-        heroType.push_back(agentType == AgentType::Hero ? GetRandomValue(0, 1) : 0);  // 50% hunter, 50% defender
-        reanimationTimer.push_back(0.0f);
-        meleeAttackCooldown.push_back(0.0f);
-        combatTarget.push_back(UINT32_MAX);  // No target
-        combatTimer.push_back(0.0f);
-        combatCooldown.push_back(0.0f);
-        infectionTimer.push_back(0.0f);
-        infectionProgress.push_back(0.0f);
-        count++;
+        forEachColumn([n](const char*, auto& column) { column.reserve(n); });
+    }
+    
+    size_t capacity() const { return posX.capacity(); }
+    
+    // Civilian flee strategy (0=panic, 1=seek_hero) and hero type (0=defender, 1=hunter)
+#ifdef TACTIX_COMPACT_STATE
+    uint8_t getFleeStrategy(size_t i) const { return traits[i] & 1; }
+    uint8_t getHeroType(size_t i) const { return (traits[i] >> 1) & 1; }
+    void setFleeStrategy(size_t i, uint8_t v) { traits[i] = static_cast<uint8_t>((traits[i] & ~1u) | (v & 1)); }
+    void setHeroType(size_t i, uint8_t v) { traits[i] = static_cast<uint8_t>((traits[i] & ~2u) | ((v & 1) << 1)); }
+#else
+    uint8_t getFleeStrategy(size_t i) const { return fleeStrategy[i]; }
+    uint8_t getHeroType(size_t i) const { return heroType[i]; }
+    void setFleeStrategy(size_t i, uint8_t v) { fleeStrategy[i] = v; }
+    void setHeroType(size_t i, uint8_t v) { heroType[i] = v; }
+#endif
+    
+    // Grow every column to the next power of two >= n in one step, so a bulk spawn
+    // reallocates each column at most once
+    void ensureCapacity(size_t n) {
+        if (n <= capacity()) return;
+        reserve(std::bit_ceil(n));
+    }
+    
+    // Truncate (or zero-extend) every column to n entities
+    void resize(size_t n) {
+        forEachColumn([n](const char*, auto& column) { column.resize(n); });
+        count = n;
+    }
+    
+    // O(1) removal: move the last entity into idx, then drop the last slot
+    void swapRemove(size_t idx) {
+        size_t last = count - 1;
+        forEachColumn([idx, last](const char*, auto& column) {
+            if (idx != last) column[idx] = column[last];
+            column.pop_back();
+        });
+        count--;
+    }
+    
+    // Bytes of per-entity column storage (all SoA columns above)
+    size_t bytesPerEntity() const {
+        size_t bytes = 0;
+        forEachColumn([&bytes](const char*, const auto& column) {
+            bytes += sizeof(typename std::decay_t<decltype(column)>::value_type);
+        });
+        return bytes;
     }
 };
 
+// Keyed random draws for one agent of a spawn batch: the value depends only on the
+// batch, the agent's index in it and the stream, never on which worker fills it
+struct SpawnRandom {
+    uint64_t batchKey;
+    uint32_t index;  // Position within the batch
+    int range(uint32_t stream, int min, int max) const {
+        return Rng::rangeAt(batchKey, 0, index, stream, min, max);
+    }
+};
+
+// Initial values for one spawned agent; everything else starts at its default
+struct SpawnParams {
+    float posX, posY;
+    float velX, velY;
+    AgentType type;
+};
+
+// Called once per agent from job workers, so it must be safe to run concurrently
+using SpawnGenerator = std::function<SpawnParams(const SpawnRandom&)>;
+
+// World bounds and partitioning, independent of the window/viewport
+struct WorldConfig {
+    float width = 1280.0f;
+    float height = 720.0f;
+    float cellSize = 50.0f;       // Spatial hash cell (Design Doc §5.1)
+    float patrolRange = 1000.0f;  // Patrol targets are picked within this distance of the agent
+    SpatialHashMode spatialMode = SpatialHashMode::Blocks;  // Hashed suits huge, mostly empty worlds
+};
+
+// Initial population split; heroes take whatever civilians and zombies leave
+struct PopulationMix {
+    float civilians = 0.90f;
+    float zombies = 0.05f;
+};
+
+// Wall-clock cost of each tick phase in ms (filled by Simulation::tick)
+struct TickPhaseTimes {
+    float housekeeping = 0.0f;  // Interpolation copy, gunshot decay, ranged kills
+    float spatialHash = 0.0f;
+    // The fused pipeline runs these three as one pass, reported as behaviors
+    float separation = 0.0f;
+    float behaviors = 0.0f;     // Including horde steering
+    float movement = 0.0f;
+    float infections = 0.0f;
+    float screenWrap = 0.0f;
+    float total = 0.0f;
+};
+
+// Outcome counts for one tick (main-thread events, reset at the start of each tick)
+struct TickEvents {
+    uint32_t shotsFired = 0;
+    uint32_t zombiesShot = 0;           // Ranged kills
+    uint32_t combatsStarted = 0;
+    uint32_t civiliansBitten = 0;
+    uint32_t civiliansKilled = 0;       // Killed outright in melee
+    uint32_t infectionDeaths = 0;       // Bitten civilians whose infection ran out
+    uint32_t reanimations = 0;
+    uint32_t corpsesEaten = 0;
+    uint32_t zombiesKilledByCivilians = 0;
+    uint32_t zombiesKilledByHeroes = 0;  // Melee
+    uint32_t heroesTurned = 0;          // Exhausted heroes that became zombies
+    uint32_t shotsBlocked = 0;          // Shots held because a building or tree was in the way
+};
+
 class Simulation {
 public:
-    Simulation(int screenWidth, int screenHeight);
+    // workerCount == 0 lets the job system pick from the CPUs available to the process;
+    // pinWorkers binds each worker to one CPU (JobSystem)
+    explicit Simulation(const WorldConfig& world, uint32_t workerCount = 0, bool pinWorkers = false);
+    // World the size of the viewport (the original behaviour)
+    Simulation(int screenWidth, int screenHeight, uint32_t workerCount = 0);
+    // Runs its jobs on a pool shared with other simulations (must outlive this one)
+    Simulation(const WorldConfig& world, JobSystem& sharedJobs);
 
     void init(size_t count);
+    void init(size_t count, const PopulationMix& mix);
+    
+    // Deterministic seed for everything random in the simulation (set before init)
+    void setSeed(uint64_t s) { seed = s; rng.reseed(s); }
+    uint64_t getSeed() const { return seed; }
+    uint64_t getTickCount() const { return tickCount; }
     void setAgentCount(size_t count);  // Dynamically adjust agent count
+    // Append count agents: every column grows once, then chunks are filled in parallel
+    void spawnBatch(size_t count, const SpawnGenerator& generator);
+    // Bulk edits for external drivers (tactix.h). Velocities last until the agents'
+    // behaviors next steer them. Killed agents are removed like a zombie shot dead:
+    // the last agents move into the freed slots and fighting opponents are released.
+    void setVelocities(const uint32_t* indices, size_t count, const float* velX, const float* velY);
+    void killAgents(std::vector<uint32_t>& indices);  // Ignores out-of-range and ghost indices
     size_t getAgentCount() const { return entities.count; }
+    const WorldConfig& getWorld() const { return world; }
     void tick(float dt);  // Fixed timestep update (Design Doc §4)
     void draw(float alpha);  // Interpolated rendering (Design Doc §8.1)
     
     // Metrics access
     float getLastSpatialHashTime() const { return lastSpatialHashTime; }
+    const TickPhaseTimes& getLastPhaseTimes() const { return lastPhaseTimes; }
+    const TickEvents& getLastTickEvents() const { return tickEvents; }
+    EventLog& getEventLog() { return eventLog; }  // Per-event log lines (async, rate limited)
+    const EntityHot& getEntities() const { return entities; }  // Read-only view for exporters
+    float getSimTime() const { return simTime; }
+    size_t getMemoryPerAgent() const;  // SoA columns + interpolation buffers
     uint32_t getMaxCellOccupancy() const;
+    float getInfectionProgress(size_t i) const;  // 0-1 for bitten agents, 0 otherwise
     bool isDebugGridEnabled() const { return debugGrid; }
     void toggleDebugGrid() { debugGrid = !debugGrid; }
-    uint32_t getJobsExecuted() const { return jobSystem.getJobsExecuted(); }
+    uint32_t getJobsExecuted() const { return tickJobs.getJobsExecuted(); }
     uint32_t getWorkerCount() const { return jobSystem.getWorkerCount(); }
+    uint32_t getJobsStolen() const { return jobSystem.getJobsStolen(); }  // Whole pool, since creation
+    // Global allocations during the last tick (0 unless built with TACTIX_COUNT_ALLOCATIONS)
+    uint64_t getLastTickAllocations() const { return lastTickAllocations; }
     
     // Pause control
     bool isPaused() const { return paused; }
     void togglePause() { paused = !paused; }
     void setPaused(bool p) { paused = p; }
     
+    // Longest gap between an agent's behavior evaluations, in ticks (1 = every tick).
+    // Agents with threats or prey nearby always re-evaluate every tick.
+    static constexpr uint32_t kDefaultThinkInterval = 8;
+    static constexpr uint32_t kMaxThinkInterval = 1024;  // Well inside a 16-bit ThinkTick's range
+    void setMaxThinkInterval(uint32_t ticks) { maxThinkInterval = std::clamp(ticks, 1u, kMaxThinkInterval); }
+    uint32_t getMaxThinkInterval() const { return maxThinkInterval; }
+    
+    // Tick-cost governor (off by default): with a budget set, tick() steps quality down
+    // when ticks keep running over it and back up once there is headroom. Levels take
+    // effect from the next tick; setQualityLevel() pins one while the budget is 0.
+    void setTickBudget(float ms) { governor.setBudget(ms); }
+    QualityLevel getQualityLevel() const { return governor.getLevel(); }
+    void setQualityLevel(QualityLevel level) { governor.setLevel(level); }
+    const TickGovernor& getGovernor() const { return governor; }
+    
+    // Agents per job in the per-agent phases. Results don't depend on it (tactix_bench
+    // --verify-determinism checks that), only the scheduling overhead does.
+    static constexpr uint32_t kDefaultChunkSize = 256;
+    void setChunkSize(uint32_t agents) { agentChunkSize = std::max(1u, agents); }
+    uint32_t getChunkSize() const { return agentChunkSize; }
+    
+    // Separation, behaviors and movement as one pass over agent chunks with a single
+    // barrier (on by default), instead of three passes with a barrier each. Neighbors
+    // are read from the start-of-tick positions (prevPosX/Y) while each chunk writes
+    // the new ones, so both give the same result; the phased pipeline only exists to
+    // time the three phases separately.
+    void setFusedPipeline(bool enabled) { fusedPipeline = enabled; }
+    bool isFusedPipeline() const { return fusedPipeline; }
+    
+    // Occlusion by buildings and trees (on by default): heroes hold fire without a clear
+    // line to their target, and buildings keep zombies from hearing gunshots behind them.
+    // Rays are collected per phase and traced as one batch (LineOfSight.hpp).
+    void setLineOfSightEnabled(bool enabled) { lineOfSightEnabled = enabled; }
+    bool isLineOfSightEnabled() const { return lineOfSightEnabled; }
+    
+    // Horde macro-agents (off by default): dense, threat-free packs of patrolling
+    // zombies move as one body and skip per-agent separation and behaviors until
+    // something alive comes within reach. Disabling releases every horde.
+    void setHordesEnabled(bool enabled);
+    bool areHordesEnabled() const { return hordesEnabled; }
+    size_t getHordeCount() const { return hordes.size(); }
+    size_t getHordeMemberCount() const { return hordeMembers.size(); }  // As of the last tick
+    
+    // Spatially partitioned runs (Region.hpp). Agents cross between processes as packed
+    // records of every column. Ghosts are copies of a neighbor region's boundary agents:
+    // they are seen and avoided here but never think, move, fight, shoot or get eaten,
+    // and removeGhosts() drops them again after the tick.
+    size_t getAgentRecordBytes() const;
+    void packAgents(const uint32_t* indices, size_t count, std::vector<uint8_t>& out) const;  // Appends
+    void unpackAgents(const uint8_t* records, size_t count, bool asGhosts);
+    void removeAgents(std::vector<uint32_t>& indices);  // Sorts indices; none may be a ghost
+    void removeGhosts();
+    size_t getGhostCount() const { return ghostCount; }
+    
     // Agent type counts
     size_t getCivilianCount() const;
     size_t getZombieCount() const;
     size_t getHeroCount() const;
 
 private:
-    int screenWidth;
-    int screenHeight;
+    friend class Snapshot;  // Serializes the private state below
+    
+    Simulation(const WorldConfig& world, std::unique_ptr<JobSystem> ownJobs, JobSystem* sharedJobs);
+    
+    WorldConfig world;
+    
+    // Deterministic randomness and simulated time (Design Doc §1.1)
+    uint64_t seed = 0x7AC71Cull;
+    Rng rng{seed};
+    uint64_t tickCount = 0;
+    float simTime = 0.0f;  // Seconds of simulated (unpaused) time
 
     EntityHot entities;  // Hot data (SoA)
     
-    // Previous state for interpolation
+    // Previous state for interpolation. Also the start-of-tick positions every worker
+    // reads neighbors from while separation, behaviors and movement run.
     std::vector<float> prevPosX;
     std::vector<float> prevPosY;
     
     // Spatial partitioning (Phase 2)
     SpatialHash spatialHash;
     float lastSpatialHashTime = 0.0f;
+    TickPhaseTimes lastPhaseTimes;
+    TickEvents tickEvents;
+    EventLog eventLog;
+    PopulationMix populationMix;
+    
+    // Job system (Phase 3): our own pool, or one shared with other simulations. Every
+    // job goes into tickJobs, so a barrier only waits for this simulation's work.
+    std::unique_ptr<JobSystem> ownedJobSystem;
+    JobSystem& jobSystem;
+    JobSystem::Group tickJobs;
+    std::vector<JobSystem::BatchJob> stagedJobs;  // Submitted since the last waitJobs()
+    
+    // Per-tick scratch: one arena per job worker plus one for the simulation thread,
+    // all reset at the end of tick() (Design Doc §6)
+    std::vector<FrameArena> frameArenas;
+    
+    // Expiry ticks of infection, reanimation and combat timers (entities.stateDeadline)
+    TimerWheel stateTimers;
     
-    // Job system (Phase 3)
-    JobSystem jobSystem;
+    // Agents in the states few agents are in, so phases can visit just them instead of
+    // branching over everyone. Job workers only move agents between the other states;
+    // entering or leaving these goes through setState() on the simulation thread.
+    enum StateList : uint8_t { DeadList, FightingList, BittenList, kStateListCount };
+    std::array<std::vector<uint32_t>, kStateListCount> stateLists;
     
-    // Neighbor query temp buffer (reused to avoid allocations)
-    mutable std::vector<uint32_t> neighborBuffer;
+    // Per type: the agents that run that type's behavior kernel this tick (everyone
+    // not on a state list), refilled by updateBehaviors()
+    std::array<std::vector<uint32_t>, 3> behaviorLists;
+    uint32_t maxThinkInterval = kDefaultThinkInterval;
+    
+    // Quality the tick in progress runs at (from governor at the start of tick())
+    TickGovernor governor;
+    uint32_t behaviorNeighborCap = UINT32_MAX;    // Neighbors a behavior decision looks at
+    uint32_t separationNeighborCap = UINT32_MAX;  // Neighbors separation pushes against
+    bool coarseSeparation = false;                // Half the agents per tick, double strength
+    bool fusedPipeline = true;
+    uint32_t agentChunkSize = kDefaultChunkSize;
+    
+    // Horde macro-agents. A horde is steered as a whole toward its own patrol target
+    // and every member copies its velocity; entities.horde is the membership, and the
+    // member lists below are rebuilt from it each tick (members of horde h are
+    // hordeMembers[hordeMemberStart[h] .. hordeMemberStart[h + 1]), ascending).
+    struct Horde {
+        float centerX, centerY;  // Member centroid and extent as of the last refresh
+        float radius;
+        float velX, velY;
+        float targetX, targetY;
+        uint32_t retargetTick;  // Pick a new target by then even if not reached (stuck on a wall)
+        // Set each tick: buildings then trees the members could touch, in hordeObstacles
+        uint32_t obstacleFirst;
+        uint32_t nearBuildings, nearTrees;
+    };
+    std::vector<Horde> hordes;
+    std::vector<uint32_t> hordeMemberStart;
+    std::vector<uint32_t> hordeMembers;
+    std::vector<uint32_t> hordeObstacles;  // Building / tree indices near each horde
+    std::vector<uint32_t> hordeRemap;  // Scratch: old 1-based index -> new (0 = dissolved)
+    bool hordesEnabled = false;
+    size_t ghostCount = 0;
+    float stepDt = 0.0f;  // dt of the tick in progress, read by chunk jobs
+    uint64_t lastTickAllocations = 0;
     
     // Debug visualization
     bool debugGrid = false;
@@ -170,6 +460,15 @@ private:
     };
     std::vector<Gunshot> recentGunshots;
     
+    // Where each gunshot in recentGunshots can be heard, same order: one bit per cell
+    // of a kHearingCells x kHearingCells grid centered on the shot and spanning the
+    // hearing range, set if no building stands between the shot and the cell's center
+    static constexpr uint32_t kHearingCells = 24;
+    struct GunshotHearing {
+        uint64_t audible[(kHearingCells * kHearingCells + 63) / 64];
+    };
+    std::vector<GunshotHearing> gunshotHearing;
+    
     // Visual gunshot lines (for rendering)
     struct GunshotLine {
         float fromX, fromY, toX, toY;
@@ -187,27 +486,148 @@ private:
     std::vector<Building> buildings;
     std::vector<Tree> trees;
     
+    // Line of sight against the obstacles above, rebuilt whenever they change
+    ObstacleGrid obstacleGrid;
+    RayBatch losRays;  // Scratch batch, reused by each phase that traces
+    bool lineOfSightEnabled = true;
+    
     // Graveyard zone
     struct { float x, y, width, height; } graveyard = {50, 0, 200, 0};  // Set in init
     
     void generateObstacles();  // Procedural obstacle generation
+    void rebuildObstacleGrid();  // After the obstacles changed (generation, snapshot load)
+    void traceRays();  // Visibility of every ray in losRays, in parallel chunks when large
+    // Hearing masks of recentGunshots[first..], sized to match
+    void updateGunshotHearing(size_t first);
+    bool hearsGunshot(size_t gunshot, float x, float y) const;  // (x, y) within hearing range
+    void fillSpawnChunk(size_t start, size_t end, size_t batchStart, uint64_t batchKey,
+                        const SpawnGenerator& generator);
+    void removeEntity(size_t idx);  // Swap-remove across all columns + interpolation buffers
+    void removeKeepingCombat(size_t idx);  // removeEntity, and the moved agent's opponent follows it
+    
+    // Timers advance 1/60 s per tick (updateInfections' fixed step)
+    static constexpr float kTimerTicksPerSecond = 60.0f;
+    uint32_t timerNow() const { return static_cast<uint32_t>(tickCount); }
+    uint32_t ticksFromNow(float seconds) const {
+        return timerNow() + std::max(1u, static_cast<uint32_t>(std::ceil(seconds * kTimerTicksPerSecond - 1e-3f)));
+    }
+    float secondsUntil(uint32_t deadline) const {
+        return static_cast<int32_t>(deadline - timerNow()) / kTimerTicksPerSecond;
+    }
+    bool hasStateTimer(size_t i) const {
+        AgentState s = entities.state[i];
+        return s == AgentState::Bitten || s == AgentState::Fighting ||
+               (s == AgentState::Dead && entities.type[i] == AgentType::Civilian);
+    }
+    void startStateTimer(size_t i, float seconds);  // Sets stateDeadline and schedules it
+    
+    static int stateListOf(AgentState s) {
+        switch (s) {
+            case AgentState::Dead: return DeadList;
+            case AgentState::Fighting: return FightingList;
+            case AgentState::Bitten: return BittenList;
+            default: return -1;
+        }
+    }
+    void setState(size_t i, AgentState s);  // Simulation thread; keeps stateLists current
+    void unlistState(size_t i);
+    void rebuildStateLists();  // After bulk column changes (truncation, snapshot load)
+    void rebuildStateTimers();  // After the columns were replaced (snapshot load)
+    void reserveAgentLists();  // After entity capacity grew, so ticks never grow the lists
+    
+    // Patrol target along one axis: within patrolRange of the agent, 50 units inside the world
+    float patrolCoordinate(float from, float extent, float unitRandom) const {
+        float lo = std::max(50.0f, from - world.patrolRange);
+        float hi = std::min(extent - 50.0f, from + world.patrolRange);
+        if (hi < lo) return extent * 0.5f;
+        return lo + (hi - lo) * (unitRandom * 0.5f + 0.5f);
+    }
+    
+    // Worker-thread randomness: keyed by (tick, entity, stream) so chunk scheduling can't change results
+    int workerRandom(size_t entity, uint32_t stream, int min, int max) const {
+        return Rng::rangeAt(seed, tickCount, static_cast<uint32_t>(entity), stream, min, max);
+    }
     
     // Combat resolution helpers
     void resolveCivilianVsZombieCombat(size_t zombieIdx, size_t civilianIdx, 
                                        int zombieAllies, int civilianAllies,
-                                       std::vector<size_t>& zombiesToKill,
-                                       std::vector<size_t>& entitiesToKill);
+                                       ArenaVector<size_t>& zombiesToKill,
+                                       ArenaVector<size_t>& entitiesToKill);
     void resolveHeroVsZombieCombat(size_t heroIdx, size_t zombieIdx,
-                                   std::vector<size_t>& zombiesToKill,
-                                   std::vector<size_t>& entitiesToKill);
+                                   ArenaVector<size_t>& zombiesToKill,
+                                   ArenaVector<size_t>& entitiesToKill);
+    
+    // Scratch arena of the calling thread (job worker or simulation thread)
+    FrameArena& frameArena() { return frameArenas[jobSystem.getCurrentWorkerIndex()]; }
+    
+    // Jobs capture [this, first, last] with 32-bit bounds (and read per-tick values such
+    // as stepDt from members), which fits std::function's inline buffer: submitting
+    // allocates nothing. Submitted jobs are staged and queued together by waitJobs(),
+    // so a phase takes the pool's lock once and wakes the workers once.
+    void submitJob(JobSystem::Job job) { stagedJobs.push_back({std::move(job), JobSystem::kSharedQueue}); }
+    // A chunk starting at agent first: on our own pool the worker that owns that slice
+    // of the agents takes it in every phase, so it finds their columns in its cache
+    void submitChunk(JobSystem::Job job, size_t first) {
+        if (!ownedJobSystem) return submitJob(std::move(job));
+        const size_t workers = jobSystem.getWorkerCount();
+        stagedJobs.push_back({std::move(job),
+                              static_cast<uint32_t>(first * workers / std::max<size_t>(1, entities.count))});
+    }
+    void waitJobs() {
+        jobSystem.submit(stagedJobs, tickJobs);
+        jobSystem.wait(tickJobs);
+    }
 
-    void updateMovement(float dt);
-    void updateSeparation(float dt);  // Collision avoidance
-    void updateBehaviors(float dt);   // Seek/flee/combat behaviors
+    // Phases run their chunks with stepDt
+    void updateMovement();
+    void updateSeparation();  // Collision avoidance
+    void updateBehaviors();   // Seek/flee/combat behaviors
+    void updateFused();       // Separation, behaviors and movement per chunk, one barrier
+    void updateFusedChunk(size_t start, size_t end, float dt);
+    void fillBehaviorLists();
     void updateInfections();          // Handle zombie infections
     void updateSeparationChunk(size_t start, size_t end, float dt);  // Parallel version
     void updateMovementChunk(size_t start, size_t end, float dt);    // Parallel version
-    void updateBehaviorsChunk(size_t start, size_t end, float dt);   // Parallel version
+    // Obstacle collision of agent i moving to (newX, newY): pushes it out and deflects its
+    // velocity, true if it hit
+    bool collideBuilding(size_t i, const Building& building, float& newX, float& newY);
+    bool collideTree(size_t i, const Tree& tree, float& newX, float& newY);
+    
+    // Behavior kernels, one instantiation per agent type (defined in Simulation.cpp)
+    struct Steering {
+        float dirX = 0.0f, dirY = 0.0f;  // Desired direction, not normalized
+        int targetCount = 0;             // 0: no steering this tick, just slow down
+        float speed = 0.0f;
+    };
+    template <AgentType T>
+    void submitBehaviorKernel(size_t chunkSize);
+    template <AgentType T>
+    void updateBehaviorKernel(size_t first, size_t last, float dt);  // Range of behaviorLists[T]
+    template <AgentType T>
+    void decideBehavior(uint32_t i, float px, float py, const ArenaVector<uint32_t>& neighbors,
+                        const SpatialHash::CellSummary& near, float dt, Steering& steer);
+    void applySteering(uint32_t i, float px, float py, Steering& steer);  // Patrol, walls, speed clamp
+    void scheduleThink(uint32_t i, bool urgent);  // Sets nextThinkTick from urgency and state
+    void thinkNow(size_t i) { entities.nextThinkTick[i] = static_cast<ThinkTick>(timerNow()); }
+    // Signed ticks from now to a think tick, by wrapped difference at the stored width
+    static int32_t ticksUntil(ThinkTick tick, uint32_t now) {
+        return static_cast<std::make_signed_t<ThinkTick>>(static_cast<ThinkTick>(tick - now));
+    }
+    
+    // Horde macro-agents (simulation thread, after the spatial hash rebuild)
+    void updateHordes();            // Regroup periodically, release threatened hordes, steer the rest
+    void formHordes();              // Absorb nearby zombies, merge overlapping hordes, seed new ones
+    void refreshHordeMembers();     // Member lists and geometry from entities.horde; drops small hordes
+    void releaseHorde(uint32_t h);  // Members go back to individual simulation
+    void leaveHorde(size_t i) {
+        entities.horde[i] = 0;
+        thinkNow(i);  // Decide for itself on its next tick
+    }
+    void retargetHorde(Horde& horde, uint32_t keyEntity);
+    void updateFightingChunk(size_t first, size_t last);  // Range of stateLists[FightingList]
+    void updateBittenChunk(size_t first, size_t last);    // Range of stateLists[BittenList]
+    void updateFighting(uint32_t i);
+    void updateBitten(uint32_t i, ArenaVector<uint32_t>& localNeighbors);
     void screenWrap();
     void rebuildSpatialHash();  // Rebuild spatial hash each tick
 };
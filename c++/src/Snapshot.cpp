@@ -0,0 +1,381 @@
+#include "platform.h"
+#include "Snapshot.hpp"
+#include "Simulation.hpp"
+#include "spdlog/spdlog.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[4] = {'T', 'X', 'S', 'N'};
+constexpr size_t kBlockAlign = 64;  // Cache-line aligned blocks
+
+// Columns rebuilt from the others after a load rather than stored. List slots depend
+// on the order agents changed state, so two runs that agree on every agent can still
+// disagree here; leaving them out keeps snapshots of equal states byte-identical.
+// Ghost flags are always clear between ticks (Simulation::removeGhosts).
+bool isDerivedColumn(const char* name) {
+    return std::strcmp(name, "stateSlot") == 0 || std::strcmp(name, "ghost") == 0;
+}
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t headerBytes;
+    uint32_t blockCount;
+    uint64_t entityCount;
+    uint64_t totalBytes;
+    int32_t worldWidth;
+    int32_t worldHeight;
+    uint64_t seed;
+    uint64_t rngState;
+    uint64_t tickCount;
+    float simTime;
+    float mixCivilians;
+    float mixZombies;
+    float graveyard[4];  // x, y, width, height
+    uint32_t reserved[9];
+};
+static_assert(sizeof(FileHeader) == 128, "Snapshot header layout changed");
+
+struct BlockEntry {
+    char name[24];
+    uint32_t elementSize;
+    uint32_t reserved;
+    uint64_t offset;  // From start of file
+    uint64_t bytes;
+};
+static_assert(sizeof(BlockEntry) == 48, "Snapshot block entry layout changed");
+
+size_t alignUp(size_t n) {
+    return (n + kBlockAlign - 1) & ~(kBlockAlign - 1);
+}
+
+// Collects (name, element size, pointer, bytes) for every block before writing
+struct BlockSource {
+    const char* name;
+    uint32_t elementSize;
+    const void* data;
+    size_t bytes;
+};
+
+template <typename T>
+BlockSource blockOf(const char* name, const std::vector<T>& v) {
+    return {name, static_cast<uint32_t>(sizeof(T)), v.data(), v.size() * sizeof(T)};
+}
+
+const BlockEntry* findBlock(const BlockEntry* blocks, uint32_t count, const char* name) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (std::strncmp(blocks[i].name, name, sizeof(blocks[i].name)) == 0) return &blocks[i];
+    }
+    return nullptr;
+}
+
+// Bulk-copy a block into a column, checking element size and bounds
+template <typename T>
+bool readBlock(const uint8_t* data, size_t size, const BlockEntry* blocks, uint32_t blockCount,
+               const char* name, std::vector<T>& out, size_t expectedCount) {
+    const BlockEntry* b = findBlock(blocks, blockCount, name);
+    if (!b) {
+        spdlog::error("Snapshot: missing block '{}'", name);
+        return false;
+    }
+    if (b->elementSize != sizeof(T) || b->offset > size || b->bytes > size - b->offset || b->bytes % sizeof(T) != 0) {
+        spdlog::error("Snapshot: block '{}' is malformed", name);
+        return false;
+    }
+    size_t n = b->bytes / sizeof(T);
+    if (expectedCount != SIZE_MAX && n != expectedCount) {
+        spdlog::error("Snapshot: block '{}' has {} entries, expected {}", name, n, expectedCount);
+        return false;
+    }
+    out.resize(n);
+    if (n > 0) std::memcpy(out.data(), data + b->offset, b->bytes);
+    return true;
+}
+
+bool parseHeader(const uint8_t* data, size_t size, FileHeader& header) {
+    if (size < sizeof(FileHeader)) {
+        spdlog::error("Snapshot: file too small ({} bytes)", size);
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(FileHeader));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        spdlog::error("Snapshot: bad magic, not a tactix snapshot");
+        return false;
+    }
+    if (header.version != Snapshot::kVersion) {
+        spdlog::error("Snapshot: unsupported version {} (expected {})", header.version, Snapshot::kVersion);
+        return false;
+    }
+    if (header.headerBytes < sizeof(FileHeader)) {
+        spdlog::error("Snapshot: header is {} bytes, expected at least {}", header.headerBytes, sizeof(FileHeader));
+        return false;
+    }
+    if (header.totalBytes > size ||
+        header.headerBytes + static_cast<uint64_t>(header.blockCount) * sizeof(BlockEntry) > size) {
+        spdlog::error("Snapshot: truncated file ({} of {} bytes)", size, header.totalBytes);
+        return false;
+    }
+    return true;
+}
+
+// Read-only view of a whole file: mmap where available, buffered read otherwise
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#if !defined(_WIN32)
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0) return;
+        size = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) { size = 0; return; }
+        mapped = static_cast<const uint8_t*>(p);
+#else
+        FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return;
+        std::fseek(f, 0, SEEK_END);
+        long len = std::ftell(f);
+        std::fseek(f, 0, SEEK_SET);
+        if (len > 0) {
+            buffer.resize(static_cast<size_t>(len));
+            size = std::fread(buffer.data(), 1, buffer.size(), f);
+        }
+        std::fclose(f);
+#endif
+    }
+
+    ~MappedFile() {
+#if !defined(_WIN32)
+        if (mapped) ::munmap(const_cast<uint8_t*>(mapped), size);
+        if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const {
+#if !defined(_WIN32)
+        return mapped;
+#else
+        return buffer.data();
+#endif
+    }
+    size_t bytes() const { return size; }
+    bool valid() const { return size > 0 && data() != nullptr; }
+
+private:
+    size_t size = 0;
+#if !defined(_WIN32)
+    int fd = -1;
+    const uint8_t* mapped = nullptr;
+#else
+    std::vector<uint8_t> buffer;
+#endif
+};
+
+}  // namespace
+
+void Snapshot::write(const Simulation& sim, std::vector<uint8_t>& out) {
+    std::vector<BlockSource> sources;
+    sim.entities.forEachColumn([&sources](const char* name, const auto& column) {
+        if (isDerivedColumn(name)) return;
+        sources.push_back(blockOf(name, column));
+    });
+    sources.push_back(blockOf("prevPosX", sim.prevPosX));
+    sources.push_back(blockOf("prevPosY", sim.prevPosY));
+    sources.push_back(blockOf("#buildings", sim.buildings));
+    sources.push_back(blockOf("#trees", sim.trees));
+    sources.push_back(blockOf("#gunshots", sim.recentGunshots));
+    sources.push_back(blockOf("#gunshotLines", sim.gunshotLines));
+    sources.push_back(blockOf("#hordes", sim.hordes));
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.headerBytes = sizeof(FileHeader);
+    header.blockCount = static_cast<uint32_t>(sources.size());
+    header.entityCount = sim.entities.count;
+    header.worldWidth = static_cast<int32_t>(sim.world.width);
+    header.worldHeight = static_cast<int32_t>(sim.world.height);
+    header.seed = sim.seed;
+    header.rngState = sim.rng.getState();
+    header.tickCount = sim.tickCount;
+    header.simTime = sim.simTime;
+    header.mixCivilians = sim.populationMix.civilians;
+    header.mixZombies = sim.populationMix.zombies;
+    header.graveyard[0] = sim.graveyard.x;
+    header.graveyard[1] = sim.graveyard.y;
+    header.graveyard[2] = sim.graveyard.width;
+    header.graveyard[3] = sim.graveyard.height;
+
+    // Directory first, then every block at a 64-byte boundary
+    std::vector<BlockEntry> directory(sources.size());
+    size_t offset = alignUp(sizeof(FileHeader) + directory.size() * sizeof(BlockEntry));
+    for (size_t i = 0; i < sources.size(); i++) {
+        BlockEntry& e = directory[i];
+        std::memset(&e, 0, sizeof(e));
+        std::strncpy(e.name, sources[i].name, sizeof(e.name) - 1);
+        e.elementSize = sources[i].elementSize;
+        e.offset = offset;
+        e.bytes = sources[i].bytes;
+        offset = alignUp(offset + sources[i].bytes);
+    }
+    header.totalBytes = offset;
+
+    out.assign(offset, 0);
+    std::memcpy(out.data(), &header, sizeof(header));
+    std::memcpy(out.data() + sizeof(header), directory.data(), directory.size() * sizeof(BlockEntry));
+    for (size_t i = 0; i < sources.size(); i++) {
+        if (sources[i].bytes > 0) {
+            std::memcpy(out.data() + directory[i].offset, sources[i].data, sources[i].bytes);
+        }
+    }
+}
+
+bool Snapshot::readInfo(const uint8_t* data, size_t size, SnapshotInfo& info) {
+    FileHeader header;
+    if (!parseHeader(data, size, header)) return false;
+    info.version = header.version;
+    info.entityCount = header.entityCount;
+    info.worldWidth = header.worldWidth;
+    info.worldHeight = header.worldHeight;
+    info.tickCount = header.tickCount;
+    info.seed = header.seed;
+    return true;
+}
+
+bool Snapshot::read(Simulation& sim, const uint8_t* data, size_t size) {
+    FileHeader header;
+    if (!parseHeader(data, size, header)) return false;
+
+    if (header.worldWidth != static_cast<int32_t>(sim.world.width) ||
+        header.worldHeight != static_cast<int32_t>(sim.world.height)) {
+        spdlog::error("Snapshot: world {}x{} does not match simulation {}x{}",
+                      header.worldWidth, header.worldHeight, sim.world.width, sim.world.height);
+        return false;
+    }
+
+    const BlockEntry* blocks = reinterpret_cast<const BlockEntry*>(data + header.headerBytes);
+    const uint32_t blockCount = header.blockCount;
+    const size_t n = static_cast<size_t>(header.entityCount);
+
+    // Decode into a scratch copy so a bad file leaves the live simulation untouched
+    EntityHot entities;
+    bool ok = true;
+    entities.forEachColumn([&](const char* name, auto& column) {
+        if (isDerivedColumn(name)) {
+            column.resize(n);
+            return;
+        }
+        ok = ok && readBlock(data, size, blocks, blockCount, name, column, n);
+    });
+    entities.count = n;
+    // Out-of-range enums would index past per-type and per-state tables
+    for (size_t i = 0; ok && i < n; i++) {
+        if (entities.type[i] > AgentType::Hero || entities.state[i] > AgentState::Bitten) {
+            spdlog::error("Snapshot: agent {} has invalid type {} or state {}", i,
+                          static_cast<int>(entities.type[i]), static_cast<int>(entities.state[i]));
+            ok = false;
+        }
+    }
+
+    std::vector<float> prevPosX, prevPosY;
+    decltype(sim.buildings) buildings;
+    decltype(sim.trees) trees;
+    decltype(sim.recentGunshots) gunshots;
+    decltype(sim.gunshotLines) gunshotLines;
+    decltype(sim.hordes) hordes;
+    ok = ok && readBlock(data, size, blocks, blockCount, "prevPosX", prevPosX, n);
+    ok = ok && readBlock(data, size, blocks, blockCount, "prevPosY", prevPosY, n);
+    ok = ok && readBlock(data, size, blocks, blockCount, "#buildings", buildings, SIZE_MAX);
+    ok = ok && readBlock(data, size, blocks, blockCount, "#trees", trees, SIZE_MAX);
+    ok = ok && readBlock(data, size, blocks, blockCount, "#gunshots", gunshots, SIZE_MAX);
+    ok = ok && readBlock(data, size, blocks, blockCount, "#gunshotLines", gunshotLines, SIZE_MAX);
+    ok = ok && readBlock(data, size, blocks, blockCount, "#hordes", hordes, SIZE_MAX);
+    if (!ok) return false;
+
+    sim.entities = std::move(entities);
+    sim.prevPosX = std::move(prevPosX);
+    sim.prevPosY = std::move(prevPosY);
+    sim.buildings = std::move(buildings);
+    sim.trees = std::move(trees);
+    sim.recentGunshots = std::move(gunshots);
+    sim.gunshotLines = std::move(gunshotLines);
+    sim.hordes = std::move(hordes);  // Member lists are rebuilt from entities.horde next tick
+    sim.graveyard.x = header.graveyard[0];
+    sim.graveyard.y = header.graveyard[1];
+    sim.graveyard.width = header.graveyard[2];
+    sim.graveyard.height = header.graveyard[3];
+    sim.seed = header.seed;
+    sim.rng.setState(header.rngState);
+    sim.tickCount = header.tickCount;
+    sim.simTime = header.simTime;
+    sim.populationMix.civilians = header.mixCivilians;
+    sim.populationMix.zombies = header.mixZombies;
+    sim.rebuildStateLists();
+    sim.rebuildStateTimers();
+    sim.rebuildObstacleGrid();
+    sim.updateGunshotHearing(0);
+    return true;
+}
+
+bool Snapshot::save(const Simulation& sim, const std::string& path) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> buffer;
+    write(sim, buffer);
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        spdlog::error("Snapshot: cannot open {} for writing", path);
+        return false;
+    }
+    size_t written = std::fwrite(buffer.data(), 1, buffer.size(), f);
+    std::fclose(f);
+    if (written != buffer.size()) {
+        spdlog::error("Snapshot: short write to {}", path);
+        return false;
+    }
+
+    float ms = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() * 1000.0f;
+    spdlog::info("Snapshot saved: {} ({} agents, tick {}, {:.2f} MB, {:.1f} ms)",
+                 path, sim.entities.count, sim.tickCount, buffer.size() / (1024.0f * 1024.0f), ms);
+    return true;
+}
+
+bool Snapshot::load(Simulation& sim, const std::string& path) {
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file(path);
+    if (!file.valid()) {
+        spdlog::error("Snapshot: cannot read {}", path);
+        return false;
+    }
+    if (!read(sim, file.data(), file.bytes())) {
+        return false;
+    }
+
+    float ms = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() * 1000.0f;
+    spdlog::info("Snapshot loaded: {} ({} agents, tick {}, {:.1f} ms)",
+                 path, sim.entities.count, sim.tickCount, ms);
+    return true;
+}
+
+bool Snapshot::peek(const std::string& path, SnapshotInfo& info) {
+    MappedFile file(path);
+    if (!file.valid()) {
+        spdlog::error("Snapshot: cannot read {}", path);
+        return false;
+    }
+    return readInfo(file.data(), file.bytes(), info);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Simulation;
+
+// Summary of a snapshot, readable without loading it (e.g. to size a Simulation first)
+struct SnapshotInfo {
+    uint32_t version = 0;
+    uint64_t entityCount = 0;
+    int32_t worldWidth = 0;
+    int32_t worldHeight = 0;
+    uint64_t tickCount = 0;
+    uint64_t seed = 0;
+};
+
+// Versioned binary save/restore of the full simulation state.
+//
+// Layout: fixed header, a block directory, then one 64-byte aligned block per
+// EntityHot column (plus interpolation buffers, obstacles, gunshots and hordes). Loading
+// maps the file and bulk-copies each block straight into its column.
+class Snapshot {
+public:
+    // 2: timers stored as deadline ticks, 3: AI think schedule, 4: horde macro-agents
+    static constexpr uint32_t kVersion = 4;
+
+    static bool save(const Simulation& sim, const std::string& path);
+    static bool load(Simulation& sim, const std::string& path);
+    static bool peek(const std::string& path, SnapshotInfo& info);
+
+    // In-memory variants (replay keyframes, tests)
+    static void write(const Simulation& sim, std::vector<uint8_t>& out);
+    static bool read(Simulation& sim, const uint8_t* data, size_t size);
+    static bool readInfo(const uint8_t* data, size_t size, SnapshotInfo& info);
+};
@@ -1,70 +1,266 @@
 #include "SpatialHash.hpp"
 #include <cmath>
+#include <cstring>
 #include <algorithm>
 
-SpatialHash::SpatialHash(float worldWidth, float worldHeight, float cellSize)
-    : cellSize(cellSize)
+SpatialHash::SpatialHash(float worldWidth, float worldHeight, float cellSize, SpatialHashMode mode)
+    : mode(mode)
+    , cellSize(cellSize)
     , worldWidth(worldWidth)
     , worldHeight(worldHeight)
 {
-    gridWidth = static_cast<uint32_t>(std::ceil(worldWidth / cellSize));
-    gridHeight = static_cast<uint32_t>(std::ceil(worldHeight / cellSize));
+    gridWidth = std::max(1u, static_cast<uint32_t>(std::ceil(worldWidth / cellSize)));
+    gridHeight = std::max(1u, static_cast<uint32_t>(std::ceil(worldHeight / cellSize)));
+    blocksWide = (gridWidth + kBlockSide - 1) >> kBlockShift;
+    blocksHigh = (gridHeight + kBlockSide - 1) >> kBlockShift;
     
-    cells.resize(gridWidth * gridHeight);
+    if (mode == SpatialHashMode::Blocks) {
+        blocks.resize(static_cast<size_t>(blocksWide) * blocksHigh);
+        blockTouched.resize(blocks.size(), 0);
+    } else {
+        resizeTable(1024);
+    }
 }
 
-void SpatialHash::clear() {
-    // Clear all cell contents but keep allocated memory
-    for (auto& cell : cells) {
-        cell.clear();
+void SpatialHash::build(const float* posX, const float* posY, size_t count, const uint8_t* kinds) {
+    // resize() keeps capacity, so a stable entity count reuses the same memory
+    entries.resize(count);
+    entityCell.resize(count);
+    
+    // Pass 1: count entities per cell (cell handle remembered per entity)
+    if (mode == SpatialHashMode::Hashed) {
+        while (!countHashed(posX, posY, count)) {
+            // Table grew mid-count: slot handles are stale, count again
+        }
+    } else {
+        countBlocks(posX, posY, count);
+    }
+    
+    // Pass 2: each cell's start = end of its range, then fill backwards so ids in a
+    // cell stay ascending and start ends up at the first entry
+    uint32_t running = 0;
+    if (mode == SpatialHashMode::Hashed) {
+        for (uint32_t slot : occupiedSlots) {
+            running += slotCount[slot];
+            slotStart[slot] = running;
+        }
+        for (size_t i = count; i-- > 0;) {
+            entries[--slotStart[entityCell[i]]] = static_cast<uint32_t>(i);
+        }
+    } else {
+        for (uint32_t b : touchedBlocks) {
+            Block& block = *blocks[b];
+            for (uint32_t local = 0; local < kBlockCells; local++) {
+                running += block.count[local];
+                block.start[local] = running;
+            }
+        }
+        for (size_t i = count; i-- > 0;) {
+            uint32_t handle = entityCell[i];
+            entries[--blocks[handle >> 8]->start[handle & 0xFF]] = static_cast<uint32_t>(i);
+        }
+    }
+    
+    hasSummaries = kinds != nullptr;
+    if (hasSummaries) {
+        summarize(posX, posY, kinds, count);
     }
 }
 
-void SpatialHash::insert(uint32_t entityId, float x, float y) {
-    uint32_t cellId = hashPosition(x, y);
-    cells[cellId].push_back(entityId);
+void SpatialHash::summarize(const float* posX, const float* posY, const uint8_t* kinds, size_t count) {
+    // Zero the occupied cells' summaries, then one pass in id order (so sums are
+    // reproducible) using the cell handles from the counting pass
+    if (mode == SpatialHashMode::Hashed) {
+        for (uint32_t slot : occupiedSlots) {
+            slotSummary[slot] = CellSummary{};
+        }
+        for (size_t i = 0; i < count; i++) {
+            CellSummary& summary = slotSummary[entityCell[i]];
+            uint32_t k = kinds[i];
+            summary.count[k]++;
+            summary.sumX[k] += posX[i];
+            summary.sumY[k] += posY[i];
+        }
+        return;
+    }
+    for (uint32_t b : touchedBlocks) {
+        Block& block = *blocks[b];
+        if (!block.summary) {
+            block.summary = std::make_unique<CellSummary[]>(kBlockCells);
+        }
+        std::memset(block.summary.get(), 0, sizeof(CellSummary) * kBlockCells);
+    }
+    for (size_t i = 0; i < count; i++) {
+        uint32_t handle = entityCell[i];
+        CellSummary& summary = blocks[handle >> 8]->summary[handle & 0xFF];
+        uint32_t k = kinds[i];
+        summary.count[k]++;
+        summary.sumX[k] += posX[i];
+        summary.sumY[k] += posY[i];
+    }
 }
 
-void SpatialHash::queryNeighbors(float x, float y, float radius, std::vector<uint32_t>& outEntities) const {
-    outEntities.clear();
+SpatialHash::Neighborhood SpatialHash::neighborhood(float x, float y) const {
+    Neighborhood result;
+    if (!hasSummaries) return result;
     
-    // Get center cell coordinates
     int32_t centerX = static_cast<int32_t>(x / cellSize);
     int32_t centerY = static_cast<int32_t>(y / cellSize);
     
-    const float radiusSq = radius * radius;
-    
-    // Check 9 cells (3x3 grid) around center (Design Doc §5.4)
     for (int32_t dy = -1; dy <= 1; ++dy) {
         for (int32_t dx = -1; dx <= 1; ++dx) {
             int32_t cellX = centerX + dx;
             int32_t cellY = centerY + dy;
-            
             if (!isValidCell(cellX, cellY)) continue;
             
-            uint32_t cellId = cellY * gridWidth + cellX;
-            const auto& cell = cells[cellId];
+            const uint32_t* first;
+            const uint32_t* last;
+            const CellSummary* summary = summaryAt(cellX, cellY, first, last);
+            if (!summary) continue;
             
-            // Add all entities from this cell
-            // (Could add distance filtering here, but caller typically does that)
-            outEntities.insert(outEntities.end(), cell.begin(), cell.end());
+            Neighborhood::Cell& cell = result.cells[result.cellCount++];
+            cell.first = first;
+            cell.last = last;
+            cell.kinds = 0;
+            for (uint32_t k = 0; k < kMaxKinds; k++) {
+                if (summary->count[k] == 0) continue;
+                cell.kinds |= kindBit(k);
+                result.total.count[k] += summary->count[k];
+                result.total.sumX[k] += summary->sumX[k];
+                result.total.sumY[k] += summary->sumY[k];
+            }
+            result.kinds |= cell.kinds;
+        }
+    }
+    return result;
+}
+
+uint32_t SpatialHash::kindsInRange(float x, float y, float radius) const {
+    if (!hasSummaries) return 0;
+    
+    int32_t minX, minY, maxX, maxY;
+    clampedCell(x - radius, y - radius, minX, minY);
+    clampedCell(x + radius, y + radius, maxX, maxY);
+    uint32_t kinds = 0;
+    for (int32_t cellY = minY; cellY <= maxY; ++cellY) {
+        for (int32_t cellX = minX; cellX <= maxX; ++cellX) {
+            const uint32_t* first;
+            const uint32_t* last;
+            const CellSummary* summary = summaryAt(cellX, cellY, first, last);
+            if (!summary) continue;
+            for (uint32_t k = 0; k < kMaxKinds; k++) {
+                if (summary->count[k]) kinds |= kindBit(k);
+            }
+        }
+    }
+    return kinds;
+}
+
+void SpatialHash::countBlocks(const float* posX, const float* posY, size_t count) {
+    // Reset only what the previous build touched
+    for (uint32_t b : touchedBlocks) {
+        std::memset(blocks[b]->count, 0, sizeof(Block::count));
+        blockTouched[b] = 0;
+    }
+    touchedBlocks.clear();
+    
+    for (size_t i = 0; i < count; i++) {
+        int32_t cellX, cellY;
+        clampedCell(posX[i], posY[i], cellX, cellY);
+        uint32_t b = blockIndex(cellX, cellY);
+        if (!blocks[b]) {
+            blocks[b] = std::make_unique<Block>();
+            std::memset(blocks[b]->start, 0, sizeof(Block::start));
+            std::memset(blocks[b]->count, 0, sizeof(Block::count));
+            allocatedBlocks++;
+        }
+        if (!blockTouched[b]) {
+            blockTouched[b] = 1;
+            touchedBlocks.push_back(b);
         }
+        uint32_t local = localIndex(cellX, cellY);
+        blocks[b]->count[local]++;
+        entityCell[i] = (b << 8) | local;
     }
 }
 
+bool SpatialHash::countHashed(const float* posX, const float* posY, size_t count) {
+    for (uint32_t slot : occupiedSlots) {
+        slotKeys[slot] = kEmptyKey;
+    }
+    occupiedSlots.clear();
+    
+    for (size_t i = 0; i < count; i++) {
+        int32_t cellX, cellY;
+        clampedCell(posX[i], posY[i], cellX, cellY);
+        uint64_t key = cellKey(cellX, cellY);
+        uint32_t slot = findSlot(key);
+        if (slotKeys[slot] == kEmptyKey) {
+            // Keep load factor <= 1/2 so probe chains stay short
+            if ((occupiedSlots.size() + 1) * 2 > slotKeys.size()) {
+                resizeTable(static_cast<uint32_t>(slotKeys.size() * 2));
+                return false;
+            }
+            slotKeys[slot] = key;
+            slotCount[slot] = 0;
+            occupiedSlots.push_back(slot);
+        }
+        slotCount[slot]++;
+        entityCell[i] = slot;
+    }
+    return true;
+}
+
+void SpatialHash::resizeTable(uint32_t capacity) {
+    slotKeys.assign(capacity, kEmptyKey);
+    slotStart.assign(capacity, 0);
+    slotCount.assign(capacity, 0);
+    slotSummary.assign(capacity, CellSummary{});
+    occupiedSlots.clear();
+    occupiedSlots.reserve(capacity / 2);
+    slotMask = capacity - 1;
+    slotShift = 64 - static_cast<uint32_t>(std::log2(capacity));
+}
+
+uint32_t SpatialHash::getAllocatedCellCount() const {
+    if (mode == SpatialHashMode::Hashed) {
+        return static_cast<uint32_t>(slotKeys.size());
+    }
+    return allocatedBlocks * kBlockCells;
+}
+
 uint32_t SpatialHash::getMaxOccupancy() const {
     uint32_t maxOccupancy = 0;
-    for (const auto& cell : cells) {
-        maxOccupancy = std::max(maxOccupancy, static_cast<uint32_t>(cell.size()));
+    if (mode == SpatialHashMode::Hashed) {
+        for (uint32_t slot : occupiedSlots) {
+            maxOccupancy = std::max(maxOccupancy, slotCount[slot]);
+        }
+        return maxOccupancy;
+    }
+    for (uint32_t b : touchedBlocks) {
+        for (uint32_t count : blocks[b]->count) {
+            maxOccupancy = std::max(maxOccupancy, count);
+        }
     }
     return maxOccupancy;
 }
 
+size_t SpatialHash::getMemoryBytes() const {
+    size_t bytes = (entries.capacity() + entityCell.capacity()) * sizeof(uint32_t);
+    if (mode == SpatialHashMode::Hashed) {
+        bytes += slotKeys.capacity() * sizeof(uint64_t);
+        bytes += (slotStart.capacity() + slotCount.capacity() + occupiedSlots.capacity()) * sizeof(uint32_t);
+        bytes += slotSummary.capacity() * sizeof(CellSummary);
+        return bytes;
+    }
+    bytes += blocks.capacity() * sizeof(blocks[0]) + blockTouched.capacity() + touchedBlocks.capacity() * sizeof(uint32_t);
+    bytes += static_cast<size_t>(allocatedBlocks) * sizeof(Block);
+    if (hasSummaries) {
+        bytes += static_cast<size_t>(allocatedBlocks) * kBlockCells * sizeof(CellSummary);
+    }
+    return bytes;
+}
+
 void SpatialHash::getCellCoords(float x, float y, int32_t& cellX, int32_t& cellY) const {
-    cellX = static_cast<int32_t>(x / cellSize);
-    cellY = static_cast<int32_t>(y / cellSize);
-    
-    // Clamp to grid bounds
-    cellX = (cellX < 0) ? 0 : (cellX >= static_cast<int32_t>(gridWidth) ? gridWidth - 1 : cellX);
-    cellY = (cellY < 0) ? 0 : (cellY >= static_cast<int32_t>(gridHeight) ? gridHeight - 1 : cellY);
+    clampedCell(x, y, cellX, cellY);
 }
@@ -1,50 +1,274 @@
 #pragma once
 #include <vector>
+#include <memory>
 #include <cstdint>
+#include <cstddef>
+
+// Cell storage strategy, picked at construction; queries behave identically
+enum class SpatialHashMode : uint8_t {
+    Blocks,  // 16x16-cell blocks allocated on first use (fast lookups, directory ~ world area / 256)
+    Hashed,  // Open-addressing table of occupied cells only (memory ~ occupied cells)
+};
 
 // Spatial hash grid for efficient neighbor queries (Design Doc §5)
+//
+// build() counting-sorts entity ids by cell into one flat array and each cell is a
+// (start, count) range into it, so a rebuild reuses the same memory every tick and
+// makes no allocations once the entity count is stable. Ids within a cell are in
+// ascending order.
+//
+// Blocks: cell ranges are grouped into 16x16 blocks that are only allocated once an
+// entity lands in them, so a 100k x 100k world costs a small block directory instead
+// of millions of empty cells. A rebuild only resets blocks touched by the last one.
+//
+// Hashed: occupied cells live in an open-addressing (linear probing) table keyed by
+// packed cell coordinate. Nothing is proportional to world area; a rebuild visits
+// only the cells occupied last time.
+//
+// When build() is given a small per-entity kind (the caller's classification, e.g.
+// agent type), each occupied cell also gets a CellSummary: per-kind counts and
+// position sums. neighborhood() hands back the 3x3 cells with their summed summary,
+// so a query can skip cells holding none of the kinds it cares about, or the whole
+// scan, and centroids of a kind come from the sums without visiting its members.
 class SpatialHash {
 public:
-    SpatialHash(float worldWidth, float worldHeight, float cellSize);
+    static constexpr uint32_t kMaxKinds = 4;
+    
+    struct CellSummary {
+        uint32_t count[kMaxKinds];
+        float sumX[kMaxKinds];
+        float sumY[kMaxKinds];
+    };
+    
+    // The 3x3 cells around a position (same cells as queryNeighbors)
+    struct Neighborhood {
+        struct Cell {
+            const uint32_t* first;
+            const uint32_t* last;
+            uint32_t kinds;  // Bit k set if the cell holds kind k
+        };
+        Cell cells[9];
+        uint32_t cellCount = 0;
+        uint32_t kinds = 0;  // Union of the cells' kind bits
+        CellSummary total{};
+        
+        bool has(uint32_t kindMask) const { return (kinds & kindMask) != 0; }
+        
+        // Append entities of the cells holding any kind in kindMask
+        template <typename Vec>
+        void collect(uint32_t kindMask, Vec& outEntities) const;
+    };
+    
+    static constexpr uint32_t kindBit(uint32_t kind) { return 1u << kind; }
+
+    SpatialHash(float worldWidth, float worldHeight, float cellSize,
+                SpatialHashMode mode = SpatialHashMode::Blocks);
+    
+    // Rebuild the grid for the current frame from entity positions (ids 0..count-1).
+    // kinds (values < kMaxKinds, one per entity) also builds the cell summaries.
+    void build(const float* posX, const float* posY, size_t count, const uint8_t* kinds = nullptr);
+    
+    // Query entities in 9-cell neighborhood (3x3 grid around position).
+    // Any vector of uint32_t works, e.g. an arena-backed one (FrameArena.hpp).
+    template <typename Vec>
+    void queryNeighbors(float x, float y, float radius, Vec& outEntities) const;
     
-    // Clear and rebuild the grid for current frame
-    void clear();
-    void insert(uint32_t entityId, float x, float y);
+    // 3x3 cells around position with their summaries; needs a build() with kinds
+    Neighborhood neighborhood(float x, float y) const;
     
-    // Query entities in 9-cell neighborhood (3x3 grid around position)
-    void queryNeighbors(float x, float y, float radius, std::vector<uint32_t>& outEntities) const;
+    // Entities of every cell overlapping the square of half-size radius around a
+    // position (any radius, unlike queryNeighbors' fixed 3x3 cells)
+    template <typename Vec>
+    void queryRange(float x, float y, float radius, Vec& outEntities) const;
+    
+    // Union of the kind bits of the same cells; needs a build() with kinds
+    uint32_t kindsInRange(float x, float y, float radius) const;
     
     // Debug info
-    uint32_t getCellCount() const { return gridWidth * gridHeight; }
+    uint32_t getCellCount() const { return gridWidth * gridHeight; }  // Logical cells
+    uint32_t getAllocatedCellCount() const;
     uint32_t getMaxOccupancy() const;
+    size_t getMemoryBytes() const;  // Approximate bytes held by cell storage
+    SpatialHashMode getMode() const { return mode; }
     
     // Get cell coordinates for position
     void getCellCoords(float x, float y, int32_t& cellX, int32_t& cellY) const;
 
 private:
+    static constexpr uint32_t kBlockShift = 4;  // 16x16 cells per block
+    static constexpr uint32_t kBlockSide = 1u << kBlockShift;
+    static constexpr uint32_t kBlockCells = kBlockSide * kBlockSide;
+    
+    struct Block {
+        uint32_t start[kBlockCells];  // Offset into entries
+        uint32_t count[kBlockCells];
+        std::unique_ptr<CellSummary[]> summary;  // Allocated on the first build with kinds
+    };
+    
+    SpatialHashMode mode;
     float cellSize;
     uint32_t gridWidth;
     uint32_t gridHeight;
+    uint32_t blocksWide;
+    uint32_t blocksHigh;
     float worldWidth;
     float worldHeight;
     
-    // Cell storage: vector of entity lists per cell
-    std::vector<std::vector<uint32_t>> cells;
+    // Entity ids sorted by cell, and each entity's cell handle from the counting pass
+    std::vector<uint32_t> entries;
+    std::vector<uint32_t> entityCell;
     
-    // Hash position to cell ID (Design Doc §5.2)
-    inline uint32_t hashPosition(float x, float y) const {
-        int32_t cellX = static_cast<int32_t>(x / cellSize);
-        int32_t cellY = static_cast<int32_t>(y / cellSize);
-        
-        // Clamp to grid bounds
+    // Block directory (null until first use) and blocks with entries this frame
+    std::vector<std::unique_ptr<Block>> blocks;
+    std::vector<uint8_t> blockTouched;
+    std::vector<uint32_t> touchedBlocks;
+    uint32_t allocatedBlocks = 0;
+    
+    // Hashed mode: slot keys (kEmptyKey = free), per-slot ranges, occupied slots
+    static constexpr uint64_t kEmptyKey = ~0ull;
+    std::vector<uint64_t> slotKeys;
+    std::vector<uint32_t> slotStart;
+    std::vector<uint32_t> slotCount;
+    std::vector<CellSummary> slotSummary;
+    std::vector<uint32_t> occupiedSlots;
+    uint32_t slotMask = 0;
+    uint32_t slotShift = 64;
+    
+    static inline uint64_t cellKey(int32_t cellX, int32_t cellY) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cellY)) << 32) | static_cast<uint32_t>(cellX);
+    }
+    inline uint32_t slotFor(uint64_t key) const {
+        return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> slotShift);  // Fibonacci hashing
+    }
+    // Slot holding key, or the empty slot where it would go
+    inline uint32_t findSlot(uint64_t key) const {
+        for (uint32_t slot = slotFor(key);; slot = (slot + 1) & slotMask) {
+            if (slotKeys[slot] == key || slotKeys[slot] == kEmptyKey) return slot;
+        }
+    }
+    bool hasSummaries = false;  // Last build() had kinds
+    
+    void resizeTable(uint32_t capacity);
+    void countBlocks(const float* posX, const float* posY, size_t count);
+    bool countHashed(const float* posX, const float* posY, size_t count);
+    void summarize(const float* posX, const float* posY, const uint8_t* kinds, size_t count);
+    
+    // Hash position to cell coordinates, clamped to the grid (Design Doc §5.2)
+    inline void clampedCell(float x, float y, int32_t& cellX, int32_t& cellY) const {
+        cellX = static_cast<int32_t>(x / cellSize);
+        cellY = static_cast<int32_t>(y / cellSize);
         cellX = (cellX < 0) ? 0 : (cellX >= static_cast<int32_t>(gridWidth) ? gridWidth - 1 : cellX);
         cellY = (cellY < 0) ? 0 : (cellY >= static_cast<int32_t>(gridHeight) ? gridHeight - 1 : cellY);
-        
-        return cellY * gridWidth + cellX;
     }
     
     inline bool isValidCell(int32_t cellX, int32_t cellY) const {
         return cellX >= 0 && cellX < static_cast<int32_t>(gridWidth) &&
                cellY >= 0 && cellY < static_cast<int32_t>(gridHeight);
     }
+    
+    inline uint32_t blockIndex(int32_t cellX, int32_t cellY) const {
+        return (static_cast<uint32_t>(cellY) >> kBlockShift) * blocksWide + (static_cast<uint32_t>(cellX) >> kBlockShift);
+    }
+    
+    static inline uint32_t localIndex(int32_t cellX, int32_t cellY) {
+        return ((static_cast<uint32_t>(cellY) & (kBlockSide - 1)) << kBlockShift) |
+               (static_cast<uint32_t>(cellX) & (kBlockSide - 1));
+    }
+    
+    // Entities in a cell as [first, last); empty if the cell holds nothing
+    inline void cellAt(int32_t cellX, int32_t cellY, const uint32_t*& first, const uint32_t*& last) const {
+        uint32_t start = 0, count = 0;
+        if (mode == SpatialHashMode::Hashed) {
+            uint32_t slot = findSlot(cellKey(cellX, cellY));
+            if (slotKeys[slot] != kEmptyKey) {
+                start = slotStart[slot];
+                count = slotCount[slot];
+            }
+        } else if (const Block* block = blocks[blockIndex(cellX, cellY)].get()) {
+            uint32_t local = localIndex(cellX, cellY);
+            count = block->count[local];
+            start = count ? block->start[local] : 0;
+        }
+        first = entries.data() + start;
+        last = first + count;
+    }
+    
+    // Same lookup, also returning the cell's summary (null if the cell is empty or
+    // the last build() had no kinds)
+    inline const CellSummary* summaryAt(int32_t cellX, int32_t cellY, const uint32_t*& first,
+                                        const uint32_t*& last) const {
+        const CellSummary* summary = nullptr;
+        uint32_t start = 0, count = 0;
+        if (mode == SpatialHashMode::Hashed) {
+            uint32_t slot = findSlot(cellKey(cellX, cellY));
+            if (slotKeys[slot] != kEmptyKey) {
+                start = slotStart[slot];
+                count = slotCount[slot];
+                if (hasSummaries) summary = &slotSummary[slot];
+            }
+        } else if (const Block* block = blocks[blockIndex(cellX, cellY)].get()) {
+            uint32_t local = localIndex(cellX, cellY);
+            count = block->count[local];
+            if (count) {
+                start = block->start[local];
+                if (hasSummaries) summary = &block->summary[local];
+            }
+        }
+        first = entries.data() + start;
+        last = first + count;
+        return count ? summary : nullptr;
+    }
 };
+
+template <typename Vec>
+void SpatialHash::queryRange(float x, float y, float radius, Vec& outEntities) const {
+    outEntities.clear();
+    int32_t minX, minY, maxX, maxY;
+    clampedCell(x - radius, y - radius, minX, minY);
+    clampedCell(x + radius, y + radius, maxX, maxY);
+    for (int32_t cellY = minY; cellY <= maxY; ++cellY) {
+        for (int32_t cellX = minX; cellX <= maxX; ++cellX) {
+            const uint32_t* first;
+            const uint32_t* last;
+            cellAt(cellX, cellY, first, last);
+            outEntities.insert(outEntities.end(), first, last);
+        }
+    }
+}
+
+template <typename Vec>
+void SpatialHash::queryNeighbors(float x, float y, float radius, Vec& outEntities) const {
+    outEntities.clear();
+    
+    // Get center cell coordinates
+    int32_t centerX = static_cast<int32_t>(x / cellSize);
+    int32_t centerY = static_cast<int32_t>(y / cellSize);
+    
+    // Check 9 cells (3x3 grid) around center (Design Doc §5.4)
+    for (int32_t dy = -1; dy <= 1; ++dy) {
+        for (int32_t dx = -1; dx <= 1; ++dx) {
+            int32_t cellX = centerX + dx;
+            int32_t cellY = centerY + dy;
+            
+            if (!isValidCell(cellX, cellY)) continue;
+            
+            const uint32_t* first;
+            const uint32_t* last;
+            cellAt(cellX, cellY, first, last);
+            
+            // Add all entities from this cell
+            // (Could add distance filtering here, but caller typically does that)
+            outEntities.insert(outEntities.end(), first, last);
+        }
+    }
+}
+
+template <typename Vec>
+void SpatialHash::Neighborhood::collect(uint32_t kindMask, Vec& outEntities) const {
+    outEntities.clear();
+    for (uint32_t c = 0; c < cellCount; c++) {
+        if (cells[c].kinds & kindMask) {
+            outEntities.insert(outEntities.end(), cells[c].first, cells[c].last);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include "StateHasher.hpp"
+#include "Simulation.hpp"
+#include "Random.hpp"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+constexpr uint64_t kLaneMul = 0x9E3779B97F4A7C15ull;
+constexpr uint64_t kLaneSeeds[4] = {
+    0x243F6A8885A308D3ull, 0x13198A2E03707344ull, 0xA4093822299F31D0ull, 0x082EFA98EC4E6C89ull,
+};
+
+uint64_t load64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+template <typename T>
+double widen(const T& value) {
+    if constexpr (std::is_enum_v<T>) {
+        return static_cast<double>(static_cast<std::underlying_type_t<T>>(value));
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        return static_cast<double>(value);
+    } else {
+        return static_cast<double>(static_cast<float>(value));
+    }
+}
+}
+
+uint64_t StateHasher::hashBytes(const void* data, size_t size, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    // Four lanes over 32-byte blocks keep four multiplies in flight
+    uint64_t lanes[4];
+    for (int l = 0; l < 4; l++) lanes[l] = kLaneSeeds[l] ^ seed;
+    size_t offset = 0;
+    for (; offset + 32 <= size; offset += 32) {
+        for (int l = 0; l < 4; l++) {
+            lanes[l] = (lanes[l] ^ load64(p + offset + l * 8)) * kLaneMul;
+            lanes[l] ^= lanes[l] >> 29;
+        }
+    }
+    uint64_t h = seed ^ (size * kLaneMul);
+    for (int l = 0; l < 4; l++) h = Rng::mix(h ^ lanes[l]);
+    for (; offset + 8 <= size; offset += 8) h = Rng::mix(h ^ load64(p + offset));
+    if (offset < size) {
+        uint64_t tail = 0;
+        std::memcpy(&tail, p + offset, size - offset);
+        h = Rng::mix(h ^ tail);
+    }
+    return h;
+}
+
+uint64_t StateHasher::update(const EntityHot& entities) {
+    columns.clear();
+    tickHash = Rng::mix(entities.count);
+    entities.forEachColumn([this](const char* name, const auto& column) {
+        using T = typename std::decay_t<decltype(column)>::value_type;
+        const uint64_t hash = hashBytes(column.data(), column.size() * sizeof(T), columns.size());
+        columns.push_back({name, hash});
+        tickHash = Rng::mix(tickHash ^ hash);
+    });
+    running = Rng::mix(running ^ tickHash);
+    ticks++;
+    return tickHash;
+}
+
+bool findDivergence(const EntityHot& expected, const EntityHot& actual, StateDivergence& out) {
+    if (expected.count != actual.count) {
+        out.column = "count";
+        out.entity = std::min(expected.count, actual.count);
+        out.expected = static_cast<double>(expected.count);
+        out.actual = static_cast<double>(actual.count);
+        return true;
+    }
+
+    // Same layout on both sides, so the columns line up in visiting order
+    std::vector<std::pair<const char*, const void*>> actualColumns;
+    actual.forEachColumn([&actualColumns](const char* name, const auto& column) {
+        actualColumns.push_back({name, &column});
+    });
+    bool found = false;
+    size_t index = 0;
+    expected.forEachColumn([&](const char* name, const auto& column) {
+        using Column = std::decay_t<decltype(column)>;
+        const Column& other = *static_cast<const Column*>(actualColumns[index++].second);
+        if (found) return;
+        for (size_t i = 0; i < column.size(); i++) {
+            if (std::memcmp(&column[i], &other[i], sizeof(column[i])) == 0) continue;
+            out.column = name;
+            out.entity = i;
+            out.expected = widen(column[i]);
+            out.actual = widen(other[i]);
+            found = true;
+            return;
+        }
+    });
+    return found;
+}
@@ -0,0 +1,293 @@
+#include "platform.h"
+#include "Telemetry.hpp"
+#include "Simulation.hpp"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <string>
+
+namespace {
+
+constexpr char kFileMagic[4] = {'T', 'X', 'T', 'M'};
+constexpr char kBatchMagic[4] = {'B', 'T', 'C', 'H'};
+constexpr uint32_t kVersion = 2;  // 2: 32-byte column names
+constexpr uint32_t kAgentRowsPerBatch = 65536;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t batchTicks;
+    uint32_t agentSampleEvery;
+};
+
+struct BatchHeader {
+    char magic[4];
+    uint32_t table;
+    uint32_t rows;
+    uint32_t columns;
+};
+
+struct ColumnHeader {
+    char name[32];  // Column names must fit, NUL included (checked below)
+    uint8_t type;
+    uint8_t reserved[7];
+    uint64_t bytes;
+};
+static_assert(sizeof(ColumnHeader) == 48, "Telemetry column header layout changed");
+
+// Column order matters: record() appends by index
+enum TickColumn : size_t {
+    TickCol, SimTimeCol, TickMsCol, AgentsCol,
+    CiviliansCol, ZombiesCol, HeroesCol, BittenCol, DeadCol, FightingCol, FleeingCol,
+    ShotsFiredCol, ZombiesShotCol, CombatsStartedCol, CiviliansBittenCol, CiviliansKilledCol,
+    InfectionDeathsCol, ReanimationsCol, CorpsesEatenCol, KilledByCiviliansCol, KilledByHeroesCol,
+    HeroesTurnedCol, ShotsBlockedCol,
+};
+
+constexpr std::pair<const char*, TelemetryType> kTickColumns[] = {
+    {"tick", TelemetryType::U64}, {"sim_time", TelemetryType::F32},
+    {"tick_ms", TelemetryType::F32}, {"agents", TelemetryType::U32},
+    {"civilians", TelemetryType::U32}, {"zombies", TelemetryType::U32},
+    {"heroes", TelemetryType::U32}, {"bitten", TelemetryType::U32},
+    {"dead", TelemetryType::U32}, {"fighting", TelemetryType::U32},
+    {"fleeing", TelemetryType::U32}, {"shots_fired", TelemetryType::U32},
+    {"zombies_shot", TelemetryType::U32}, {"combats_started", TelemetryType::U32},
+    {"civilians_bitten", TelemetryType::U32}, {"civilians_killed", TelemetryType::U32},
+    {"infection_deaths", TelemetryType::U32}, {"reanimations", TelemetryType::U32},
+    {"corpses_eaten", TelemetryType::U32}, {"zombies_killed_by_civilians", TelemetryType::U32},
+    {"zombies_killed_by_heroes", TelemetryType::U32}, {"heroes_turned", TelemetryType::U32},
+    {"shots_blocked", TelemetryType::U32},
+};
+
+enum AgentColumn : size_t { ATickCol, SlotCol, TypeCol, StateCol, PosXCol, PosYCol, HealthCol, InfectionCol };
+
+constexpr std::pair<const char*, TelemetryType> kAgentColumns[] = {
+    {"tick", TelemetryType::U64}, {"slot", TelemetryType::U32},
+    {"type", TelemetryType::U8}, {"state", TelemetryType::U8},
+    {"pos_x", TelemetryType::F32}, {"pos_y", TelemetryType::F32},
+    {"health", TelemetryType::U8}, {"infection", TelemetryType::F32},
+};
+
+template <size_t N>
+constexpr bool namesFit(const std::pair<const char*, TelemetryType> (&columns)[N]) {
+    for (const auto& column : columns) {
+        if (std::char_traits<char>::length(column.first) >= sizeof(ColumnHeader::name)) return false;
+    }
+    return true;
+}
+static_assert(namesFit(kTickColumns) && namesFit(kAgentColumns), "Telemetry column name too long");
+
+}  // namespace
+
+TelemetrySink::~TelemetrySink() {
+    close();
+}
+
+bool TelemetrySink::open(const TelemetryConfig& cfg) {
+    close();
+    config = cfg;
+    config.batchTicks = std::max<uint32_t>(1, config.batchTicks);
+    config.maxQueuedBatches = std::max<uint32_t>(1, config.maxQueuedBatches);
+
+    file = std::fopen(config.path.c_str(), "wb");
+    if (!file) {
+        spdlog::error("Telemetry: cannot open {} for writing", config.path);
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    header.version = kVersion;
+    header.batchTicks = config.batchTicks;
+    header.agentSampleEvery = config.agentSampleEvery;
+    std::fwrite(&header, sizeof(header), 1, file);
+
+    stopping = false;
+    droppedBatches = 0;
+    writtenBytes = sizeof(header);
+    ticks = takeBatch(TicksTable);
+    agents = takeBatch(AgentsTable);
+    writer = std::thread(&TelemetrySink::writerLoop, this);
+
+    spdlog::info("Telemetry streaming to {}", config.path);
+    return true;
+}
+
+void TelemetrySink::close() {
+    if (!file) return;
+
+    if (ticks && ticks->rows > 0) submit(ticks);
+    if (agents && agents->rows > 0) submit(agents);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_one();
+    writer.join();
+
+    std::fclose(file);
+    file = nullptr;
+    ticks.reset();
+    agents.reset();
+    freeList.clear();
+
+    spdlog::info("Telemetry closed: {} ({:.2f} MB written, {} batches dropped)",
+                 config.path, writtenBytes / (1024.0f * 1024.0f), droppedBatches);
+}
+
+void TelemetrySink::record(const Simulation& sim, float tickMs) {
+    if (!file) return;
+
+    const EntityHot& e = sim.getEntities();
+    const TickEvents& ev = sim.getLastTickEvents();
+    const uint64_t tick = sim.getTickCount();
+
+    // One pass over the type/state columns for the population aggregates
+    uint32_t byType[4] = {0};   // Indexed by AgentType
+    uint32_t byState[8] = {0};  // Indexed by AgentState
+    for (size_t i = 0; i < e.count; i++) {
+        byType[static_cast<uint8_t>(e.type[i]) & 3]++;
+        byState[static_cast<uint8_t>(e.state[i]) & 7]++;
+    }
+
+    TelemetryBatch& t = *ticks;
+    t.append(TickCol, tick);
+    t.append(SimTimeCol, sim.getSimTime());
+    t.append(TickMsCol, tickMs);
+    t.append(AgentsCol, static_cast<uint32_t>(e.count));
+    t.append(CiviliansCol, byType[static_cast<uint8_t>(AgentType::Civilian)]);
+    t.append(ZombiesCol, byType[static_cast<uint8_t>(AgentType::Zombie)]);
+    t.append(HeroesCol, byType[static_cast<uint8_t>(AgentType::Hero)]);
+    t.append(BittenCol, byState[static_cast<uint8_t>(AgentState::Bitten)]);
+    t.append(DeadCol, byState[static_cast<uint8_t>(AgentState::Dead)]);
+    t.append(FightingCol, byState[static_cast<uint8_t>(AgentState::Fighting)]);
+    t.append(FleeingCol, byState[static_cast<uint8_t>(AgentState::Fleeing)]);
+    t.append(ShotsFiredCol, ev.shotsFired);
+    t.append(ZombiesShotCol, ev.zombiesShot);
+    t.append(CombatsStartedCol, ev.combatsStarted);
+    t.append(CiviliansBittenCol, ev.civiliansBitten);
+    t.append(CiviliansKilledCol, ev.civiliansKilled);
+    t.append(InfectionDeathsCol, ev.infectionDeaths);
+    t.append(ReanimationsCol, ev.reanimations);
+    t.append(CorpsesEatenCol, ev.corpsesEaten);
+    t.append(KilledByCiviliansCol, ev.zombiesKilledByCivilians);
+    t.append(KilledByHeroesCol, ev.zombiesKilledByHeroes);
+    t.append(HeroesTurnedCol, ev.heroesTurned);
+    t.append(ShotsBlockedCol, ev.shotsBlocked);
+    if (++t.rows >= config.batchTicks) {
+        submit(ticks);
+    }
+
+    // Sampled per-agent rows, evenly strided over entity slots
+    if (config.agentSampleEvery > 0 && tick % config.agentSampleEvery == 0 && e.count > 0) {
+        size_t stride = std::max<size_t>(1, (e.count + config.maxSampledAgents - 1) / config.maxSampledAgents);
+        TelemetryBatch& a = *agents;
+        for (size_t i = 0; i < e.count; i += stride) {
+            a.append(ATickCol, tick);
+            a.append(SlotCol, static_cast<uint32_t>(i));
+            a.append(TypeCol, static_cast<uint8_t>(e.type[i]));
+            a.append(StateCol, static_cast<uint8_t>(e.state[i]));
+            a.append(PosXCol, e.posX[i]);
+            a.append(PosYCol, e.posY[i]);
+            a.append(HealthCol, e.health[i]);
+            a.append(InfectionCol, sim.getInfectionProgress(i));
+            a.rows++;
+        }
+        if (a.rows >= kAgentRowsPerBatch) {
+            submit(agents);
+        }
+    }
+}
+
+uint64_t TelemetrySink::getDroppedBatches() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return droppedBatches;
+}
+
+uint64_t TelemetrySink::getWrittenBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return writtenBytes;
+}
+
+std::unique_ptr<TelemetryBatch> TelemetrySink::takeBatch(Table table) {
+    std::unique_ptr<TelemetryBatch> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < freeList.size(); i++) {
+            if (freeList[i]->table == table) {
+                batch = std::move(freeList[i]);
+                freeList.erase(freeList.begin() + i);
+                break;
+            }
+        }
+    }
+
+    if (!batch) {
+        batch = std::make_unique<TelemetryBatch>();
+        batch->table = table;
+        if (table == TicksTable) {
+            for (const auto& [name, type] : kTickColumns) batch->columns.push_back({name, type, {}});
+        } else {
+            for (const auto& [name, type] : kAgentColumns) batch->columns.push_back({name, type, {}});
+        }
+    }
+    batch->rows = 0;
+    for (auto& column : batch->columns) column.data.clear();  // Keeps capacity
+    return batch;
+}
+
+void TelemetrySink::submit(std::unique_ptr<TelemetryBatch>& batch) {
+    Table table = static_cast<Table>(batch->table);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pending.size() < config.maxQueuedBatches) {
+            pending.push_back(std::move(batch));
+        } else {
+            droppedBatches++;  // Writer is behind: lose data, never stall the tick
+            freeList.push_back(std::move(batch));
+        }
+    }
+    cv.notify_one();
+    batch = takeBatch(table);
+}
+
+void TelemetrySink::writerLoop() {
+    std::vector<std::unique_ptr<TelemetryBatch>> work;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (pending.empty() && stopping) break;
+            work.swap(pending);
+        }
+
+        size_t bytes = 0;
+        for (const auto& batch : work) {
+            bytes += writeBatch(*batch);
+        }
+        std::fflush(file);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        writtenBytes += bytes;
+        for (auto& batch : work) freeList.push_back(std::move(batch));
+        work.clear();
+    }
+}
+
+size_t TelemetrySink::writeBatch(const TelemetryBatch& batch) {
+    BatchHeader header{};
+    std::memcpy(header.magic, kBatchMagic, sizeof(kBatchMagic));
+    header.table = batch.table;
+    header.rows = batch.rows;
+    header.columns = static_cast<uint32_t>(batch.columns.size());
+    size_t bytes = std::fwrite(&header, 1, sizeof(header), file);
+
+    for (const auto& column : batch.columns) {
+        ColumnHeader ch{};
+        std::strncpy(ch.name, column.name, sizeof(ch.name) - 1);
+        ch.type = static_cast<uint8_t>(column.type);
+        ch.bytes = column.data.size();
+        bytes += std::fwrite(&ch, 1, sizeof(ch), file);
+        bytes += std::fwrite(column.data.data(), 1, column.data.size(), file);
+    }
+    return bytes;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Simulation;
+
+struct TelemetryConfig {
+    std::string path = "tactix_telemetry.tlm";
+    uint32_t batchTicks = 600;         // Tick rows per batch (10 s at 60 TPS)
+    uint32_t agentSampleEvery = 60;    // Ticks between per-agent samples (0 = off)
+    uint32_t maxSampledAgents = 1024;  // Agents per sample, evenly strided over slots
+    uint32_t maxQueuedBatches = 16;    // Batches waiting for the writer before new ones are dropped
+};
+
+// Element types of telemetry columns (stored as-is, little-endian)
+enum class TelemetryType : uint8_t { U8 = 0, U32 = 1, U64 = 2, F32 = 3 };
+
+// A record batch: one table's rows for a span of ticks, stored column by column
+struct TelemetryBatch {
+    struct Column {
+        const char* name;
+        TelemetryType type;
+        std::vector<uint8_t> data;
+    };
+
+    uint32_t table = 0;
+    uint32_t rows = 0;
+    std::vector<Column> columns;
+
+    template <typename T>
+    void append(size_t column, T value) {
+        auto& data = columns[column].data;
+        size_t at = data.size();
+        data.resize(at + sizeof(T));
+        std::memcpy(data.data() + at, &value, sizeof(T));
+    }
+};
+
+// Streams per-tick aggregates and sampled per-agent columns to disk.
+//
+// record() runs on the simulation thread after each tick and only appends to
+// in-memory batches. Full batches are handed to a background writer; if the writer
+// falls behind, batches are dropped and counted rather than blocking the tick.
+//
+// File layout: "TXTM" header, then self-describing batches (table id, row count,
+// per-column name/type/bytes followed by the column data). Read with
+// scripts/read_telemetry.py.
+class TelemetrySink {
+public:
+    TelemetrySink() = default;
+    ~TelemetrySink();
+    TelemetrySink(const TelemetrySink&) = delete;
+    TelemetrySink& operator=(const TelemetrySink&) = delete;
+
+    bool open(const TelemetryConfig& config);
+    void close();  // Flushes partial batches and joins the writer
+    bool isOpen() const { return file != nullptr; }
+
+    void record(const Simulation& sim, float tickMs);
+
+    uint64_t getDroppedBatches() const;
+    uint64_t getWrittenBytes() const;
+
+private:
+    enum Table : uint32_t { TicksTable = 0, AgentsTable = 1 };
+
+    TelemetryConfig config;
+    FILE* file = nullptr;
+
+    std::unique_ptr<TelemetryBatch> ticks;
+    std::unique_ptr<TelemetryBatch> agents;
+
+    // Writer thread hand-off
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::unique_ptr<TelemetryBatch>> pending;
+    std::vector<std::unique_ptr<TelemetryBatch>> freeList;  // Recycled batches keep their capacity
+    std::thread writer;
+    bool stopping = false;
+    uint64_t droppedBatches = 0;
+    uint64_t writtenBytes = 0;
+
+    std::unique_ptr<TelemetryBatch> takeBatch(Table table);
+    void submit(std::unique_ptr<TelemetryBatch>& batch);
+    void writerLoop();
+    size_t writeBatch(const TelemetryBatch& batch);
+};
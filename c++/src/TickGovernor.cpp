@@ -0,0 +1,57 @@
+#include "TickGovernor.hpp"
+
+const char* qualityLevelName(QualityLevel level) {
+    switch (level) {
+        case QualityLevel::Full: return "full";
+        case QualityLevel::ReducedQueries: return "reduced queries";
+        case QualityLevel::CoarseSeparation: return "coarse separation";
+        case QualityLevel::LimitedCatchUp: return "limited catch-up";
+    }
+    return "unknown";
+}
+
+void TickGovernor::setBudget(float ms) {
+    // The app re-sends the budget every frame; only a real change restarts the streaks
+    const float budget = ms > 0.0f ? ms : 0.0f;
+    if (budget == budgetMs) return;
+    budgetMs = budget;
+    overStreak = 0;
+    underStreak = 0;
+}
+
+void TickGovernor::setLevel(QualityLevel newLevel) {
+    level = newLevel;
+    overStreak = 0;
+    underStreak = 0;
+}
+
+bool TickGovernor::record(float tickMs) {
+    // Exponential moving average over roughly the last 8 ticks
+    smoothedMs = smoothedMs == 0.0f ? tickMs : smoothedMs + (tickMs - smoothedMs) * 0.125f;
+    if (!isEnabled()) return false;
+
+    const uint32_t current = static_cast<uint32_t>(level);
+    if (smoothedMs > budgetMs) {
+        underStreak = 0;
+        if (++overStreak >= kDegradeTicks && current + 1 < kQualityLevelCount) {
+            setLevel(static_cast<QualityLevel>(current + 1));
+            return true;
+        }
+    } else if (smoothedMs < budgetMs * kRestoreShare) {
+        overStreak = 0;
+        if (++underStreak >= kRestoreTicks && current > 0) {
+            setLevel(static_cast<QualityLevel>(current - 1));
+            return true;
+        }
+    } else {
+        overStreak = 0;
+        underStreak = 0;
+    }
+    return false;
+}
+
+uint32_t TickGovernor::getMaxTicksPerFrame() const {
+    // Even at full quality a frame never runs an unbounded backlog (spiral of death)
+    static constexpr uint32_t kMaxTicks[kQualityLevelCount] = {8, 6, 4, 1};
+    return kMaxTicks[static_cast<uint32_t>(level)];
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+
+// Simulation quality steps, cheapest last. Each level keeps everything the levels
+// before it gave up.
+enum class QualityLevel : uint8_t {
+    Full = 0,
+    ReducedQueries = 1,    // Behaviors and separation consider only the first neighbors found
+    CoarseSeparation = 2,  // Each agent runs separation every other tick, at double strength
+    LimitedCatchUp = 3,    // Fewest catch-up ticks per frame: the sim falls behind real time
+};
+constexpr uint32_t kQualityLevelCount = 4;
+
+const char* qualityLevelName(QualityLevel level);
+
+// Tracks tick cost against a budget and steps quality down when ticks keep running
+// over, and back up once they have been comfortably under for a while.
+//
+// The cost is smoothed so a single slow tick (a snapshot, a spawn) doesn't trip it.
+// Degrading takes kDegradeTicks over budget in a row; restoring takes kRestoreTicks
+// under kRestoreShare of the budget, so the level doesn't flap around the boundary.
+// A budget of 0 turns the governor off and leaves the level wherever it was set
+// (replays pin it to the recorded levels).
+class TickGovernor {
+public:
+    static constexpr uint32_t kDegradeTicks = 15;
+    static constexpr uint32_t kRestoreTicks = 180;
+    static constexpr float kRestoreShare = 0.6f;
+
+    void setBudget(float ms);  // Same budget again: no-op
+    float getBudget() const { return budgetMs; }
+    bool isEnabled() const { return budgetMs > 0.0f; }
+
+    // One tick's cost in ms; true if the level changed
+    bool record(float tickMs);
+
+    QualityLevel getLevel() const { return level; }
+    void setLevel(QualityLevel newLevel);
+    float getSmoothedMs() const { return smoothedMs; }
+
+    // Fixed-timestep ticks a frame may run to catch up with real time at this level
+    uint32_t getMaxTicksPerFrame() const;
+
+private:
+    float budgetMs = 0.0f;
+    float smoothedMs = 0.0f;
+    QualityLevel level = QualityLevel::Full;
+    uint32_t overStreak = 0;
+    uint32_t underStreak = 0;
+};
@@ -0,0 +1,52 @@
+#include "TimerWheel.hpp"
+#include <algorithm>
+#include <bit>
+
+TimerWheel::TimerWheel(uint32_t slotCount) {
+    slots.resize(std::bit_ceil(std::max(slotCount, 2u)));
+    mask = slots.size() - 1;
+}
+
+void TimerWheel::append(List& list, uint32_t node) {
+    nodes[node].next = kNone;
+    if (list.tail == kNone) {
+        list.head = node;
+    } else {
+        nodes[list.tail].next = node;
+    }
+    list.tail = node;
+}
+
+void TimerWheel::schedule(uint32_t entity, uint64_t deadline, uint64_t now) {
+    uint32_t node = freeHead;
+    if (node != kNone) {
+        freeHead = nodes[node].next;
+    } else {
+        node = static_cast<uint32_t>(nodes.size());
+        nodes.push_back({});
+    }
+    nodes[node].deadline = deadline;
+    nodes[node].entity = entity;
+    append(deadline - now < slots.size() ? slots[deadline & mask] : overflow, node);
+    pending++;
+}
+
+void TimerWheel::drainOverflow(uint64_t tick) {
+    // Entries due before the wheel wraps again move into their slot, in order
+    List kept;
+    for (uint32_t n = overflow.head; n != kNone;) {
+        const uint32_t next = nodes[n].next;
+        const uint64_t deadline = nodes[n].deadline;
+        append(deadline - tick < slots.size() ? slots[deadline & mask] : kept, n);
+        n = next;
+    }
+    overflow = kept;
+}
+
+void TimerWheel::clear() {
+    std::fill(slots.begin(), slots.end(), List{});
+    overflow = List{};
+    nodes.clear();  // Keeps capacity
+    freeHead = kNone;
+    pending = 0;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Per-tick expiry buckets for agent timers (infection, reanimation, combat).
+//
+// An agent is scheduled once for the tick its timer runs out and is only looked at
+// again when that tick comes round, instead of every agent being decremented every
+// tick. Entries are just entity indices: an entity can be swap-removed, moved or
+// change state before its tick, so collect() hands back candidates and the caller
+// checks them against the entity's own deadline column (stale entries are dropped,
+// duplicates are harmless).
+//
+// Deadlines closer than the wheel size go straight into their slot; later ones wait
+// in an overflow list that is re-sorted into the wheel each time it wraps. collect()
+// must be called for every tick in order.
+//
+// Every entry is a node in one pooled array, linked into its slot's list (oldest
+// first) and recycled through a free list when collected, so scheduling only touches
+// the allocator when more entries are pending than ever before. reserve() sizes the
+// pool up front (Simulation keeps it at the entity capacity).
+class TimerWheel {
+public:
+    explicit TimerWheel(uint32_t slotCount = 1024);  // Rounded up to a power of two
+
+    // Fire entity at deadline (>= now, the tick being simulated)
+    void schedule(uint32_t entity, uint64_t deadline, uint64_t now);
+
+    // Append the entities due at tick to out, in scheduling order, and empty their slot
+    template <typename Vec>
+    void collect(uint64_t tick, Vec& out);
+
+    void reserve(size_t entries) { nodes.reserve(entries); }
+    void clear();
+    size_t getPendingCount() const { return pending; }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Node {
+        uint64_t deadline;  // Read for overflow entries only
+        uint32_t entity;
+        uint32_t next;
+    };
+    struct List {
+        uint32_t head = kNone;
+        uint32_t tail = kNone;
+    };
+
+    std::vector<Node> nodes;
+    uint32_t freeHead = kNone;
+    std::vector<List> slots;
+    List overflow;
+    uint64_t mask;
+    size_t pending = 0;
+
+    void append(List& list, uint32_t node);
+    void drainOverflow(uint64_t tick);
+};
+
+template <typename Vec>
+void TimerWheel::collect(uint64_t tick, Vec& out) {
+    if ((tick & mask) == 0 && overflow.head != kNone) {
+        drainOverflow(tick);
+    }
+    List& slot = slots[tick & mask];
+    if (slot.head == kNone) return;
+    for (uint32_t n = slot.head; n != kNone; n = nodes[n].next) {
+        out.push_back(nodes[n].entity);
+        pending--;
+    }
+    // The whole list goes back to the pool in one splice
+    nodes[slot.tail].next = freeHead;
+    freeHead = slot.head;
+    slot = List{};
+}
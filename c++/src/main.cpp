@@ -6,6 +6,9 @@
 #include <chrono>
 
 #include "Simulation.hpp"
+#include "Snapshot.hpp"
+#include "Replay.hpp"
+#include "Telemetry.hpp"
 
 int main() {
     // 1. Setup Window
@@ -30,15 +33,37 @@ int main() {
     camera.rotation = 0.0f;
     camera.zoom = 1.0f;
 
-    Simulation sim(screenWidth, screenHeight);
+    // World bounds are independent of the window; the camera pans/zooms over it
+    WorldConfig world;
+    world.width = static_cast<float>(screenWidth);
+    world.height = static_cast<float>(screenHeight);
+    Simulation sim(world);
     size_t agentCount = 100;
+    // Fresh seed each run; it's logged so an interesting run can be reproduced
+    sim.setSeed(static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
     sim.init(agentCount);
+    spdlog::info("Simulation seed: {}", sim.getSeed());
+    const char* snapshotPath = "tactix_snapshot.bin";
+
+    // Replay: inputs go through the recorder (logged only while recording)
+    const char* replayPath = "tactix_replay.bin";
+    ReplayRecorder recorder;
+    ReplayPlayer player;
+    bool replaying = false;      // Simulation is driven by the player, not live input
+    bool replayPlaying = false;  // Playback running (vs. scrubbing)
+    int seekTick = 0;
+    TelemetrySink telemetry;  // Streams per-tick aggregates to tactix_telemetry.tlm while enabled
 
     // Fixed timestep accumulator (Design Doc §1.1)
     const float FIXED_DT = 1.0f / 60.0f;  // 60 ticks per second
     float accumulator = 0.0f;
     auto lastTime = std::chrono::steady_clock::now();
     float timeScale = 0.5f;  // Time scaling: start at half speed to observe infection dynamics
+    float recordedTimeScale = timeScale;
+    // Share of a frame the simulation may spend ticking; the governor degrades past it
+    const float tickBudgetShare = 0.75f;
+    bool governorEnabled = true;
+    uint32_t droppedTicks = 0;  // Backlog discarded by the catch-up cap (sim fell behind real time)
 
     // Metrics
     float tickTimes[60] = {0};  // Rolling window for tick time
@@ -87,7 +112,11 @@ int main() {
         
         // Time scale keyboard controls
         if (IsKeyPressed(KEY_SPACE)) {
-            sim.togglePause();
+            if (replaying) {
+                replayPlaying = !replayPlaying;
+            } else {
+                recorder.setPaused(sim, !sim.isPaused());
+            }
         }
         if (IsKeyPressed(KEY_LEFT_BRACKET)) {
             timeScale = std::max(0.125f, timeScale * 0.5f);
@@ -99,17 +128,39 @@ int main() {
             timeScale = 1.0f;  // Reset to normal speed
         }
         
+        if (replaying) {
+            timeScale = player.getTimeScaleAt(sim.getTickCount(), timeScale);  // Recorded pacing
+        } else if (timeScale != recordedTimeScale) {
+            recorder.setTimeScale(sim, timeScale);
+        }
+        recordedTimeScale = timeScale;
+        
         auto currentTime = std::chrono::steady_clock::now();
         float frameTime = std::chrono::duration<float>(currentTime - lastTime).count();
         lastTime = currentTime;
 
         accumulator += frameTime * timeScale;
+        
+        // At 4x a frame runs 4 ticks, so each gets a quarter of the frame's budget
+        float tickBudgetMs = FIXED_DT * 1000.0f * tickBudgetShare / std::max(1.0f, timeScale);
+        sim.setTickBudget(governorEnabled && !replaying ? tickBudgetMs : 0.0f);
 
-        // Fixed timestep simulation loop
-        while (accumulator >= FIXED_DT) {
+        // Fixed timestep simulation loop, capped so slow ticks can't snowball
+        uint32_t ticksThisFrame = 0;
+        while (accumulator >= FIXED_DT && ticksThisFrame < sim.getGovernor().getMaxTicksPerFrame()) {
+            ticksThisFrame++;
             auto tickStart = std::chrono::steady_clock::now();
             
-            sim.tick(FIXED_DT);
+            if (replaying) {
+                if (replayPlaying) {
+                    player.seek(sim, sim.getTickCount() + 1);
+                    replayPlaying = sim.getTickCount() < player.getLog().endTick;
+                }
+            } else {
+                sim.tick(FIXED_DT);
+                recorder.afterTick(sim);
+                if (!sim.isPaused()) telemetry.record(sim, sim.getLastPhaseTimes().total);
+            }
             tickCount++;
             
             auto tickEnd = std::chrono::steady_clock::now();
@@ -118,6 +169,10 @@ int main() {
             
             accumulator -= FIXED_DT;
         }
+        if (accumulator >= FIXED_DT) {
+            droppedTicks += static_cast<uint32_t>(accumulator / FIXED_DT);
+            accumulator = std::fmod(accumulator, FIXED_DT);
+        }
 
         // Interpolation alpha for smooth rendering
         float alpha = accumulator / FIXED_DT;
@@ -151,9 +206,9 @@ int main() {
         
         // Agent count control
         int agentCountInt = static_cast<int>(agentCount);
-        if (ImGui::SliderInt("Total Agents", &agentCountInt, 100, 10000)) {
+        if (ImGui::SliderInt("Total Agents", &agentCountInt, 100, 10000) && !replaying) {
             agentCount = static_cast<size_t>(agentCountInt);
-            sim.setAgentCount(agentCount);
+            recorder.setAgentCount(sim, agentCount);
         }
         ImGui::Text("Active Agents: %zu", sim.getAgentCount());
         
@@ -208,6 +263,15 @@ int main() {
         
         ImGui::Text("Last Tick: %.3f ms", lastTickTime);
         
+        // Governor: current quality level and the catch-up cap it implies
+        const TickGovernor& governor = sim.getGovernor();
+        ImGui::Checkbox("Tick governor", &governorEnabled);
+        ImGui::SameLine();
+        ImVec4 qualityColor = sim.getQualityLevel() == QualityLevel::Full ? ImVec4(0, 1, 0, 1) : ImVec4(1, 0.6f, 0, 1);
+        ImGui::TextColored(qualityColor, "Quality: %s", qualityLevelName(sim.getQualityLevel()));
+        ImGui::Text("Budget %.2f ms, avg %.2f ms, <= %u ticks/frame, %u dropped", tickBudgetMs,
+                    governor.getSmoothedMs(), governor.getMaxTicksPerFrame(), droppedTicks);
+        
         // Performance bar
         float tickBudget = FIXED_DT * 1000.0f;  // 16.66 ms
         float tickPercent = (avgTickTime / tickBudget) * 100.0f;
@@ -233,6 +297,90 @@ int main() {
         if (ImGui::Button(sim.isDebugGridEnabled() ? "Hide Grid" : "Show Grid")) {
             sim.toggleDebugGrid();
         }
+        ImGui::SameLine();
+        EventLog& events = sim.getEventLog();
+        if (ImGui::Button(events.isEnabled() ? "Mute Event Log" : "Unmute Event Log")) {
+            events.setEnabled(!events.isEnabled());
+        }
+        ImGui::Text("Events: %llu combats, %llu bites, %llu reanimations",
+                    static_cast<unsigned long long>(events.getTotal(EventKind::CombatStarted)),
+                    static_cast<unsigned long long>(events.getTotal(EventKind::CivilianBitten) +
+                                                    events.getTotal(EventKind::CivilianPyrrhicKill)),
+                    static_cast<unsigned long long>(events.getTotal(EventKind::Reanimated)));
+        
+        ImGui::Separator();
+        if (ImGui::Button("Save Snapshot")) {
+            Snapshot::save(sim, snapshotPath);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Load Snapshot") && !replaying) {
+            recorder.end(sim);  // A loaded state isn't reachable from the recorded inputs
+            if (Snapshot::load(sim, snapshotPath)) {
+                agentCount = sim.getAgentCount();
+            }
+        }
+        ImGui::Text("Sim tick: %llu", static_cast<unsigned long long>(sim.getTickCount()));
+        
+        if (ImGui::Button(telemetry.isOpen() ? "Stop Telemetry" : "Start Telemetry")) {
+            if (telemetry.isOpen()) {
+                telemetry.close();
+            } else {
+                telemetry.open(TelemetryConfig{});
+            }
+        }
+        if (telemetry.isOpen()) {
+            ImGui::SameLine();
+            ImGui::Text("%.1f MB, %llu dropped", telemetry.getWrittenBytes() / (1024.0f * 1024.0f),
+                        static_cast<unsigned long long>(telemetry.getDroppedBatches()));
+        }
+        
+        // Record / replay (deterministic: seed + inputs + keyframes)
+        ImGui::Separator();
+        if (!replaying) {
+            if (ImGui::Button(recorder.isRecording() ? "Stop Recording" : "Start Recording")) {
+                if (recorder.isRecording()) {
+                    recorder.end(sim);
+                } else {
+                    recorder.begin(sim, FIXED_DT);
+                }
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Save Replay") && !recorder.isRecording()) {
+                recorder.getLog().save(replayPath);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Load Replay")) {
+                recorder.end(sim);
+                if (player.load(replayPath) && player.seek(sim, 0)) {
+                    replaying = true;
+                    replayPlaying = false;
+                    seekTick = static_cast<int>(sim.getTickCount());
+                }
+            }
+            if (recorder.isRecording()) {
+                ImGui::TextColored(ImVec4(1.0f, 0.2f, 0.2f, 1.0f), "REC  %zu inputs, %zu keyframes",
+                                   recorder.getLog().inputs.size(), recorder.getLog().keyframes.size());
+            }
+        } else {
+            ImGui::Text("Replay: tick %llu / %llu", static_cast<unsigned long long>(sim.getTickCount()),
+                        static_cast<unsigned long long>(player.getLog().endTick));
+            ImGui::InputInt("Seek Tick", &seekTick);
+            ImGui::SameLine();
+            if (ImGui::Button("Seek")) {
+                player.seek(sim, static_cast<uint64_t>(std::max(0, seekTick)));
+                replayPlaying = false;
+            }
+            ImGui::Text("Last seek: %llu ticks in %.1f ms", static_cast<unsigned long long>(player.getLastSeekTicks()),
+                        player.getLastSeekMs());
+            if (ImGui::Button(replayPlaying ? "Pause Playback" : "Play")) {
+                replayPlaying = !replayPlaying;
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Exit Replay")) {
+                replaying = false;  // Continue live from the current replay state
+                agentCount = sim.getAgentCount();
+            }
+        }
         
         ImGui::Separator();
         ImGui::PlotLines("Tick Time (ms)", tickTimes, 60, timeIndex, nullptr, 0.0f, 20.0f, ImVec2(0, 60));
@@ -259,6 +407,8 @@ int main() {
     rlImGuiShutdown();
     CloseWindow();
     
+    sim.getEventLog().flush();
+    sim.getEventLog().logSummary();
     spdlog::info("Tactix Engine Shutdown Cleanly. Total ticks: {}", tickCount);
     return 0;
 }
\ No newline at end of file